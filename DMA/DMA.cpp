@@ -14,37 +14,50 @@
 //------------------------------------------------------------------------------------
 
 
-/** Manejadores DMA para perifricos TIMx */
-TIM_HandleTypeDef*  DMA::tim1_ch1 = 0;
-TIM_HandleTypeDef*  DMA::tim1_ch2 = 0;
-TIM_HandleTypeDef*  DMA::tim1_ch3 = 0;
-TIM_HandleTypeDef*  DMA::tim1_ch4 = 0;
-TIM_HandleTypeDef*  DMA::tim16_ch1 = 0;
-
-/** Manejadores DMA para perifricos SPIx */
+/** Propietario de cada canal */
+DMA_HandleTypeDef* volatile DMA::_owners[DMA::ChannelCount] = {0};
+
+/** Registros de cada canal, en el orden de DMA::Channel */
+static DMA_Channel_TypeDef* const dma_channels[DMA::ChannelCount] = {
+    DMA1_Channel1, DMA1_Channel2, DMA1_Channel3, DMA1_Channel4, DMA1_Channel5, DMA1_Channel6, DMA1_Channel7,
+    DMA2_Channel1, DMA2_Channel2, DMA2_Channel3, DMA2_Channel4, DMA2_Channel5, DMA2_Channel6, DMA2_Channel7,
+};
+
+/** Rutas de cada petición */
+constexpr DMA::Route_t DMA::routes[DMA::RequestCount][DMA::MaxRoutes];
+
+/** Interrupción de cada canal, en el orden de DMA::Channel */
+static const IRQn_Type dma_irqs[DMA::ChannelCount] = {
+    DMA1_Channel1_IRQn, DMA1_Channel2_IRQn, DMA1_Channel3_IRQn, DMA1_Channel4_IRQn, DMA1_Channel5_IRQn, 
+    DMA1_Channel6_IRQn, DMA1_Channel7_IRQn,
+    DMA2_Channel1_IRQn, DMA2_Channel2_IRQn, DMA2_Channel3_IRQn, DMA2_Channel4_IRQn, DMA2_Channel5_IRQn, 
+    DMA2_Channel6_IRQn, DMA2_Channel7_IRQn,
+};
+
+/** Manejadores de periféricos SPIx */
 SPI_HandleTypeDef*  DMA::spi1 = 0;    
 SPI_HandleTypeDef*  DMA::spi3 = 0;
 
-/** Manejadores DMA para perifricos I2Cx */
+/** Manejadores DMA para periféricos I2Cx */
 I2C_HandleTypeDef*  DMA::i2c1 = 0;    
 I2C_HandleTypeDef*  DMA::i2c3 = 0;        
 
-/** Manejadores DMA para perifricos USARTx */
-USART_HandleTypeDef*  DMA::usart1 = 0;    
-USART_HandleTypeDef*  DMA::usart2 = 0;        
-USART_HandleTypeDef*  DMA::usart3 = 0;        
+/** Manejadores DMA para periféricos USARTx (en modo UART asíncrono) */
+UART_HandleTypeDef*  DMA::usart1 = 0;    
+UART_HandleTypeDef*  DMA::usart2 = 0;        
+UART_HandleTypeDef*  DMA::usart3 = 0;        
 
-/** Manejadores DMA para perifricos CANx */
+/** Manejadores DMA para periféricos CANx */
 CAN_HandleTypeDef*  DMA::can1 = 0;    
 
-/** Manejadores DMA para perifricos ADCx */
+/** Manejadores DMA para periféricos ADCx */
 ADC_HandleTypeDef*  DMA::adc1 = 0;    
 
-/** Manejadores DMA para perifricos DACx */
+/** Manejadores DMA para periféricos DACx */
 DAC_HandleTypeDef*  DMA::dac1 = 0;    
 DAC_HandleTypeDef*  DMA::dac2 = 0;        
 
-/** Manejadores DMA para perifricos SAIx */
+/** Manejadores DMA para periféricos SAIx */
 SAI_HandleTypeDef*  DMA::sai1 = 0;    
 SAI_HandleTypeDef*  DMA::sai2 = 0;   
 
@@ -55,89 +68,143 @@ SAI_HandleTypeDef*  DMA::sai2 = 0;
 
 //------------------------------------------------------------------------------------
 void DMA1_Channel1_IRQHandler(void){
+    DMA::dispatch(DMA::Dma1Channel1);
 }
 
 //------------------------------------------------------------------------------------
 void DMA1_Channel2_IRQHandler(void){
-    if(DMA::spi1){
-        HAL_DMA_IRQHandler(DMA::spi1->hdmarx);
-    }
-    if(DMA::tim1_ch1){
-        HAL_DMA_IRQHandler(DMA::tim1_ch1->hdma[TIM_DMA_ID_CC1]);
-    }    
+    DMA::dispatch(DMA::Dma1Channel2);
 }
 
 //------------------------------------------------------------------------------------
 void DMA1_Channel3_IRQHandler(void){
-    if(DMA::spi1){
-        HAL_DMA_IRQHandler(DMA::spi1->hdmatx);
-    }    
-    if(DMA::tim16_ch1){
-        HAL_DMA_IRQHandler(DMA::tim16_ch1->hdma[TIM_DMA_ID_CC1]);
-    }
-    if(DMA::tim1_ch2){
-        HAL_DMA_IRQHandler(DMA::tim1_ch2->hdma[TIM_DMA_ID_CC2]);
-    }    
+    DMA::dispatch(DMA::Dma1Channel3);
 }
 
 //------------------------------------------------------------------------------------
 void DMA1_Channel4_IRQHandler(void){
-    if(DMA::tim1_ch4){
-        HAL_DMA_IRQHandler(DMA::tim1_ch4->hdma[TIM_DMA_ID_CC4]);
-    }
+    DMA::dispatch(DMA::Dma1Channel4);
 }
 
 //------------------------------------------------------------------------------------
 void DMA1_Channel5_IRQHandler(void){
+    DMA::dispatch(DMA::Dma1Channel5);
 }
 
 //------------------------------------------------------------------------------------
 void DMA1_Channel6_IRQHandler(void){
-
+    DMA::dispatch(DMA::Dma1Channel6);
 }
+
 //------------------------------------------------------------------------------------
 void DMA1_Channel7_IRQHandler(void){
-    if(DMA::tim1_ch3){
-        HAL_DMA_IRQHandler(DMA::tim1_ch3->hdma[TIM_DMA_ID_CC3]);
-    }
+    DMA::dispatch(DMA::Dma1Channel7);
 }
 
-
 //------------------------------------------------------------------------------------
 void DMA2_Channel1_IRQHandler(void){
-    if(DMA::spi3){
-        HAL_DMA_IRQHandler(DMA::spi3->hdmarx);
-    }  
+    DMA::dispatch(DMA::Dma2Channel1);
 }
 
 //------------------------------------------------------------------------------------
 void DMA2_Channel2_IRQHandler(void){
-    if(DMA::spi3){
-        HAL_DMA_IRQHandler(DMA::spi3->hdmatx);
-    }    
+    DMA::dispatch(DMA::Dma2Channel2);
 }
 
 //------------------------------------------------------------------------------------
 void DMA2_Channel3_IRQHandler(void){
-
+    DMA::dispatch(DMA::Dma2Channel3);
 }
 
 //------------------------------------------------------------------------------------
 void DMA2_Channel4_IRQHandler(void){
-
+    DMA::dispatch(DMA::Dma2Channel4);
 }
 
 //------------------------------------------------------------------------------------
 void DMA2_Channel5_IRQHandler(void){
-
+    DMA::dispatch(DMA::Dma2Channel5);
 }
 
 //------------------------------------------------------------------------------------
 void DMA2_Channel6_IRQHandler(void){
-
+    DMA::dispatch(DMA::Dma2Channel6);
 }
 
 //------------------------------------------------------------------------------------
 void DMA2_Channel7_IRQHandler(void){
+    DMA::dispatch(DMA::Dma2Channel7);
+}
+
+
+//------------------------------------------------------------------------------------
+//- PUBLIC CLASS IMPL. ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+bool DMA::claim(DMA_HandleTypeDef* hdma){
+    Channel ch = getChannel(hdma->Instance);
+    if(ch == NoChannel){
+        return false;
+    }
+    if(_owners[ch] != 0 && _owners[ch] != hdma){
+        return false;
+    }
+    _owners[ch] = hdma;
+    return true;
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA::release(DMA_HandleTypeDef* hdma){
+    Channel ch = getChannel(hdma->Instance);
+    if(ch != NoChannel && _owners[ch] == hdma){
+        _owners[ch] = 0;
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+DMA::Channel DMA::getChannel(DMA_Channel_TypeDef* instance){
+    for(uint8_t i = 0; i < ChannelCount; i++){
+        if(dma_channels[i] == instance){
+            return (Channel)i;
+        }
+    }
+    return NoChannel;
+}
+
+
+//------------------------------------------------------------------------------------
+bool DMA::allocate(Request req, DMA_HandleTypeDef* hdma){
+    // si ya es propietario de una de sus rutas, la mantiene
+    for(uint8_t i = 0; i < MaxRoutes; i++){
+        const Route_t& route = routes[req][i];
+        if(route.channel != NoChannel && _owners[route.channel] == hdma){
+            return true;
+        }
+    }
+    for(uint8_t i = 0; i < MaxRoutes; i++){
+        const Route_t& route = routes[req][i];
+        if(route.channel == NoChannel || _owners[route.channel] != 0){
+            continue;
+        }
+        if(route.channel < Dma2Channel1){
+            __HAL_RCC_DMA1_CLK_ENABLE();
+        }
+        else{
+            __HAL_RCC_DMA2_CLK_ENABLE();
+        }
+        hdma->Instance = dma_channels[route.channel];
+        hdma->Init.Request = route.request;
+        return claim(hdma);
+    }
+    return false;
+}
 
+
+//------------------------------------------------------------------------------------
+IRQn_Type DMA::getIRQn(Channel ch){
+    return dma_irqs[ch];
 }
@@ -4,9 +4,27 @@
  *  Created on: Oct 2017
  *      Author: raulMrello
  *
- *  DMA es el mdulo C++ que proporciona acceso a los diferentes canales DMA. Dependiendo de la plataforma
- *  existirn ms o menos canales
+ *  DMA es el módulo C++ que proporciona acceso a los diferentes canales DMA. Dependiendo de la plataforma
+ *  existirán más o menos canales
  *  el archivo .cpp
+ *
+ *  Despacho de interrupciones: cada canal tiene un único propietario, registrado en tiempo de ejecución por el driver
+ *  que lo utiliza mediante claim() (normalmente tras HAL_DMA_Init) y liberado con release(). Cada DMAx_Channely_IRQHandler
+ *  realiza una única llamada indexada a HAL_DMA_IRQHandler del propietario de su canal, por lo que el coste de la
+ *  interrupción no depende del número de periféricos soportados y los canales sin propietario no invocan a la HAL.
+ *  Un canal compartido por varios periféricos (p.ej. DMA1_Channel3: SPI1_TX, TIM16_CH1, TIM1_CH2) sólo puede
+ *  pertenecer a uno de ellos: claim() falla si ya tiene otro propietario.
+ *
+ *  Asignación de canales: allocate() conoce la tabla de peticiones DMA del STM32L4 (RM0394, tablas 41 y 42) y asigna
+ *  a cada petición de periférico (Request) el primer canal libre de sus rutas posibles, probando primero la ruta
+ *  habitual en DMA1 y después los canales alternativos (p.ej. TIM16_CH1 en DMA1_Channel6, SPI1_TX en DMA2_Channel4).
+ *  Los drivers invocan allocate() en su construcción y detienen la ejecución con error() si no queda canal libre.
+ *  Cuando los periféricos son constantes, conflicts() permite detectar en tiempo de compilación dos peticiones que
+ *  no pueden coexistir, p.ej:
+ *
+ *      static_assert(!DMA::conflicts(DMA_PwmOut::getRequest(PA_9), DMA::ReqSpi1Tx), "Conflicto DMA");
+ *
+ *  La comprobación es por parejas: el conflicto entre tres o más peticiones se detecta en la construcción.
  */
  
  
@@ -16,7 +34,7 @@
 #if defined(TARGET_STM32L4) 
 #include "stm32l4xx_hal.h"
 #else
-#error Realizar implementacin para la plataforma en cuestin
+#error Realizar implementación para la plataforma en cuestión
 #endif
   
 
@@ -29,43 +47,206 @@
 
 class DMA{
   public:
-      
-    /** Manejadores DMA para perifricos TIMx */
-    static TIM_HandleTypeDef*  tim1_ch1;
-    static TIM_HandleTypeDef*  tim1_ch2;
-    static TIM_HandleTypeDef*  tim1_ch3;
-    static TIM_HandleTypeDef*  tim1_ch4;
-    static TIM_HandleTypeDef*  tim16_ch1;
+
+    /** Canales DMA, índice del registro de propietarios */
+    enum Channel{
+        Dma1Channel1 = 0,
+        Dma1Channel2,
+        Dma1Channel3,
+        Dma1Channel4,
+        Dma1Channel5,
+        Dma1Channel6,
+        Dma1Channel7,
+        Dma2Channel1,
+        Dma2Channel2,
+        Dma2Channel3,
+        Dma2Channel4,
+        Dma2Channel5,
+        Dma2Channel6,
+        Dma2Channel7,
+        ChannelCount,
+        NoChannel = ChannelCount,
+    };
+
+    /** Peticiones DMA de periféricos */
+    enum Request{
+        ReqAdc1 = 0,
+        ReqDac1Ch1,
+        ReqDac1Ch2,
+        ReqSpi1Rx,
+        ReqSpi1Tx,
+        ReqSpi3Rx,
+        ReqSpi3Tx,
+        ReqI2c1Rx,
+        ReqI2c1Tx,
+        ReqI2c3Rx,
+        ReqI2c3Tx,
+        ReqUsart1Rx,
+        ReqUsart1Tx,
+        ReqUsart2Rx,
+        ReqUsart2Tx,
+        ReqUsart3Rx,
+        ReqUsart3Tx,
+        ReqTim1Ch1,
+        ReqTim1Ch2,
+        ReqTim1Ch3,
+        ReqTim1Ch4,
+        ReqTim16Ch1,
+        RequestCount,
+    };
+
+    /** Número máximo de rutas (canal, selector de petición) de cada petición */
+    static const uint8_t MaxRoutes = 2;
+
+    /** Ruta de una petición: canal y valor del selector CxS */
+    struct Route_t{
+        uint8_t channel;
+        uint8_t request;
+    };
+
+    /** Rutas de cada petición, por orden de preferencia. Las no utilizadas tienen channel = NoChannel */
+    static constexpr Route_t routes[RequestCount][MaxRoutes] = {
+        /* ReqAdc1     */ {{Dma1Channel1, DMA_REQUEST_0}, {Dma2Channel3, DMA_REQUEST_0}},
+        /* ReqDac1Ch1  */ {{Dma1Channel3, DMA_REQUEST_6}, {Dma2Channel4, DMA_REQUEST_3}},
+        /* ReqDac1Ch2  */ {{Dma1Channel4, DMA_REQUEST_5}, {Dma2Channel5, DMA_REQUEST_3}},
+        /* ReqSpi1Rx   */ {{Dma1Channel2, DMA_REQUEST_1}, {Dma2Channel3, DMA_REQUEST_4}},
+        /* ReqSpi1Tx   */ {{Dma1Channel3, DMA_REQUEST_1}, {Dma2Channel4, DMA_REQUEST_4}},
+        /* ReqSpi3Rx   */ {{Dma2Channel1, DMA_REQUEST_3}, {NoChannel, 0}},
+        /* ReqSpi3Tx   */ {{Dma2Channel2, DMA_REQUEST_3}, {NoChannel, 0}},
+        /* ReqI2c1Rx   */ {{Dma1Channel7, DMA_REQUEST_3}, {Dma2Channel6, DMA_REQUEST_5}},
+        /* ReqI2c1Tx   */ {{Dma1Channel6, DMA_REQUEST_3}, {Dma2Channel7, DMA_REQUEST_5}},
+        /* ReqI2c3Rx   */ {{Dma1Channel3, DMA_REQUEST_3}, {NoChannel, 0}},
+        /* ReqI2c3Tx   */ {{Dma1Channel2, DMA_REQUEST_3}, {NoChannel, 0}},
+        /* ReqUsart1Rx */ {{Dma1Channel5, DMA_REQUEST_2}, {Dma2Channel7, DMA_REQUEST_2}},
+        /* ReqUsart1Tx */ {{Dma1Channel4, DMA_REQUEST_2}, {Dma2Channel6, DMA_REQUEST_2}},
+        /* ReqUsart2Rx */ {{Dma1Channel6, DMA_REQUEST_2}, {NoChannel, 0}},
+        /* ReqUsart2Tx */ {{Dma1Channel7, DMA_REQUEST_2}, {NoChannel, 0}},
+        /* ReqUsart3Rx */ {{Dma1Channel3, DMA_REQUEST_2}, {NoChannel, 0}},
+        /* ReqUsart3Tx */ {{Dma1Channel2, DMA_REQUEST_2}, {NoChannel, 0}},
+        /* ReqTim1Ch1  */ {{Dma1Channel2, DMA_REQUEST_7}, {NoChannel, 0}},
+        /* ReqTim1Ch2  */ {{Dma1Channel3, DMA_REQUEST_7}, {NoChannel, 0}},
+        /* ReqTim1Ch3  */ {{Dma1Channel7, DMA_REQUEST_7}, {NoChannel, 0}},
+        /* ReqTim1Ch4  */ {{Dma1Channel4, DMA_REQUEST_7}, {NoChannel, 0}},
+        /* ReqTim16Ch1 */ {{Dma1Channel3, DMA_REQUEST_4}, {Dma1Channel6, DMA_REQUEST_4}},
+    };
+
+	
+    /** @fn conflicts()
+     *  @brief Comprueba (en tiempo de compilación si los argumentos son constantes) si dos peticiones no pueden
+     *         obtener canales distintos con ninguna combinación de sus rutas
+     *  @param a Petición
+     *  @param b Petición
+     *  @return True si hay conflicto
+     */
+    static constexpr bool conflicts(Request a, Request b){
+        return !fits(a, b, 0, 0);
+    }
+
+	
+    /** @fn allocate()
+     *  @brief Asigna a un manejador DMA el primer canal libre de las rutas de una petición. Ajusta hdma->Instance
+     *         e hdma->Init.Request, habilita el reloj del controlador y registra el manejador como propietario del
+     *         canal (ver claim). Si el manejador ya es propietario de una de las rutas, la mantiene.
+     *  @param req Petición
+     *  @param hdma Manejador DMA
+     *  @return True si se asigna, False si todas las rutas están ocupadas
+     */
+    static bool allocate(Request req, DMA_HandleTypeDef* hdma);
+
+	
+    /** @fn getIRQn()
+     *  @brief Obtiene la interrupción de un canal
+     *  @param ch Canal
+     *  @return IRQn del canal
+     */
+    static IRQn_Type getIRQn(Channel ch);
+
+	
+    /** @fn claim()
+     *  @brief Registra un manejador DMA como propietario del canal indicado en hdma->Instance, al que se despachará
+     *         la interrupción del canal
+     *  @param hdma Manejador DMA, con Instance ya asignado
+     *  @return True si se registra (o ya era el propietario), False si el canal pertenece a otro manejador
+     */
+    static bool claim(DMA_HandleTypeDef* hdma);
+
+	
+    /** @fn release()
+     *  @brief Libera el canal de un manejador DMA, si es su propietario
+     *  @param hdma Manejador DMA
+     */
+    static void release(DMA_HandleTypeDef* hdma);
+
+	
+    /** @fn getChannel()
+     *  @brief Obtiene el índice de un canal DMA
+     *  @param instance Registros del canal (p.ej. DMA1_Channel3)
+     *  @return Índice del canal o NoChannel
+     */
+    static Channel getChannel(DMA_Channel_TypeDef* instance);
+
+	
+    /** @fn getOwner()
+     *  @brief Obtiene el propietario de un canal
+     *  @return Manejador DMA o 0 si el canal está libre
+     */
+    static DMA_HandleTypeDef* getOwner(Channel ch) { return (ch < ChannelCount)? _owners[ch] : 0; }
+
+	
+    /** @fn dispatch()
+     *  @brief Despacha la interrupción de un canal a su propietario (contexto ISR)
+     *  @param ch Canal
+     */
+    static inline void dispatch(Channel ch){
+        DMA_HandleTypeDef* hdma = _owners[ch];
+        if(hdma){
+            HAL_DMA_IRQHandler(hdma);
+        }
+    }
   
-    /** Manejadores DMA para perifricos SPIx */
+    /** Manejadores de periféricos SPIx, para identificar la instancia en las callbacks de la HAL */
     static SPI_HandleTypeDef*  spi1;    
     static SPI_HandleTypeDef*  spi3;
  
-    /** Manejadores DMA para perifricos I2Cx */
+    /** Manejadores DMA para periféricos I2Cx */
     static I2C_HandleTypeDef*  i2c1;    
     static I2C_HandleTypeDef*  i2c3;        
  
-    /** Manejadores DMA para perifricos USARTx */
-    static USART_HandleTypeDef*  usart1;    
-    static USART_HandleTypeDef*  usart2;        
-    static USART_HandleTypeDef*  usart3;        
+    /** Manejadores DMA para periféricos USARTx (en modo UART asíncrono) */
+    static UART_HandleTypeDef*  usart1;    
+    static UART_HandleTypeDef*  usart2;        
+    static UART_HandleTypeDef*  usart3;        
  
-    /** Manejadores DMA para perifricos CANx */
+    /** Manejadores DMA para periféricos CANx */
     static CAN_HandleTypeDef*  can1;    
  
-    /** Manejadores DMA para perifricos ADCx */
+    /** Manejadores DMA para periféricos ADCx */
     static ADC_HandleTypeDef*  adc1;    
  
-    /** Manejadores DMA para perifricos DACx */
+    /** Manejadores DMA para periféricos DACx */
     static DAC_HandleTypeDef*  dac1;    
     static DAC_HandleTypeDef*  dac2;        
     static DAC_HandleTypeDef*  dac3;        
 
-    /** Manejadores DMA para perifricos SAIx */
+    /** Manejadores DMA para periféricos SAIx */
     static SAI_HandleTypeDef*  sai1;    
     static SAI_HandleTypeDef*  sai2;    
 
-   
+  protected:
+
+    /** @fn fits()
+     *  @brief Busca recursivamente una combinación de rutas (i, j) de dos peticiones con canales distintos
+     */
+    static constexpr bool fits(Request a, Request b, uint8_t i, uint8_t j){
+        return (i >= MaxRoutes)? false :
+               (j >= MaxRoutes)? fits(a, b, i + 1, 0) :
+               (routes[a][i].channel != NoChannel && routes[b][j].channel != NoChannel &&
+                routes[a][i].channel != routes[b][j].channel)? true :
+               fits(a, b, i, j + 1);
+    }
+
+    /** Propietario de cada canal */
+    static DMA_HandleTypeDef* volatile _owners[ChannelCount];
 };
 
 
@@ -74,7 +255,7 @@ class DMA{
 //------------------------------------------------------------------------------------
 
 
-/** Manejadores de interrupcin para los canales DMA asociados a los interfaces SPI (SPI1 y SPI3)*/
+/** Manejadores de interrupción de los canales DMA, que despachan al propietario registrado con DMA::claim */
 
 #ifdef __cplusplus
 extern "C" {
@@ -0,0 +1,297 @@
+/*
+ * DMA_ADC.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ */
+
+#include "DMA_ADC.h"
+
+
+
+//------------------------------------------------------------------------------------
+//- STATIC ---------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+static DMA_ADC* adc1Dma;
+
+static void unhandled_callback(const uint16_t* block, uint16_t scans){}
+static void unhandled_callback_2(DMA_ADC::ErrorResult err){}
+
+
+/** Pines analógicos del ADC1 y su canal */
+struct AdcPin_t{
+    PinName pin;
+    GPIO_TypeDef* port;
+    uint16_t gpio;
+    uint32_t channel;
+};
+
+static const AdcPin_t adc_pins[] = {
+    {PA_0, GPIOA, GPIO_PIN_0, ADC_CHANNEL_5},
+    {PA_1, GPIOA, GPIO_PIN_1, ADC_CHANNEL_6},
+    {PA_2, GPIOA, GPIO_PIN_2, ADC_CHANNEL_7},
+    {PA_3, GPIOA, GPIO_PIN_3, ADC_CHANNEL_8},
+    {PA_4, GPIOA, GPIO_PIN_4, ADC_CHANNEL_9},
+    {PA_5, GPIOA, GPIO_PIN_5, ADC_CHANNEL_10},
+    {PA_6, GPIOA, GPIO_PIN_6, ADC_CHANNEL_11},
+    {PA_7, GPIOA, GPIO_PIN_7, ADC_CHANNEL_12},
+    {PB_0, GPIOB, GPIO_PIN_0, ADC_CHANNEL_15},
+    {PB_1, GPIOB, GPIO_PIN_1, ADC_CHANNEL_16},
+};
+
+/** Posiciones de la secuencia regular */
+static const uint32_t adc_ranks[DMA_ADC::MaxChannels] = {
+    ADC_REGULAR_RANK_1, ADC_REGULAR_RANK_2, ADC_REGULAR_RANK_3, ADC_REGULAR_RANK_4, ADC_REGULAR_RANK_5,
+    ADC_REGULAR_RANK_6, ADC_REGULAR_RANK_7, ADC_REGULAR_RANK_8, ADC_REGULAR_RANK_9, ADC_REGULAR_RANK_10,
+};
+
+
+//------------------------------------------------------------------------------------
+/** Vector de interrupción ADC1 (overrun) */
+static void adc1_irq(){
+    if(adc1Dma){
+        HAL_ADC_IRQHandler(adc1Dma->getHandler());
+    }
+}
+
+
+
+//------------------------------------------------------------------------------------
+//- WEAK IMPL. -----------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+/** Callback de interrupción dma_half_transfer */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc){
+    if(DMA::adc1 == hadc){
+        adc1Dma->onBlock(0);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+/** Callback de interrupción dma_transfer_complete */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc){
+    if(DMA::adc1 == hadc){
+        adc1Dma->onBlock(1);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+/** Callback de interrupción de error (overrun del ADC o error de la DMA) */
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef* hadc){
+    if(DMA::adc1 == hadc){
+        adc1Dma->errIsrCb.call((hadc->ErrorCode & HAL_ADC_ERROR_OVR)? DMA_ADC::OVERRUN_ERROR : DMA_ADC::TRANSFER_ERROR);
+    }
+}
+
+
+
+//------------------------------------------------------------------------------------
+//- PUBLIC CLASS IMPL. ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+DMA_ADC::DMA_ADC(const PinName* pins, uint8_t count, uint32_t hz){
+    _buf = 0;
+    _scans = 0;
+    _count = 0;
+    _overruns = 0;
+    _ready = false;
+    _running = false;
+    blockIsrCb = callback(unhandled_callback);
+    errIsrCb = callback(unhandled_callback_2);
+    _hdma.Instance = 0;
+    if(!pins || count == 0 || count > MaxChannels || hz == 0 || DMA::adc1 != 0){
+        return;
+    }
+
+    /* Analog pins */
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    uint32_t channels[MaxChannels];
+    for(uint8_t i = 0; i < count; i++){
+        const AdcPin_t* adc_pin = 0;
+        for(uint8_t j = 0; j < sizeof(adc_pins)/sizeof(adc_pins[0]); j++){
+            if(adc_pins[j].pin == pins[i]){
+                adc_pin = &adc_pins[j];
+                break;
+            }
+        }
+        if(!adc_pin){
+            return;
+        }
+        GPIO_InitTypeDef GPIO_InitStruct;
+        GPIO_InitStruct.Pin = adc_pin->gpio;
+        GPIO_InitStruct.Mode = GPIO_MODE_ANALOG_ADC_CONTROL;
+        GPIO_InitStruct.Pull = GPIO_NOPULL;
+        GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+        GPIO_InitStruct.Alternate = 0;
+        HAL_GPIO_Init(adc_pin->port, &GPIO_InitStruct);
+        channels[i] = adc_pin->channel;
+    }
+    _count = count;
+
+    /* Select a free DMA channel for the request and enable its clock */
+    if(!DMA::allocate(DMA::ReqAdc1, &_hdma)){
+        error("DMA_ADC: sin canal DMA libre para la peticion %d\r\n", DMA::ReqAdc1);
+        return;
+    }
+    DMA::adc1 = &_handle;
+    adc1Dma = this;
+
+    /* ADC1: regular sequence of count channels, one scan per TIM6 TRGO event, dma circular */
+    __HAL_RCC_ADC_CLK_ENABLE();
+    __HAL_RCC_ADC_CONFIG(RCC_ADCCLKSOURCE_SYSCLK);
+    _handle.Instance                   = ADC1;
+    _handle.Init.ClockPrescaler        = ADC_CLOCK_ASYNC_DIV1;
+    _handle.Init.Resolution            = ADC_RESOLUTION_12B;
+    _handle.Init.DataAlign             = ADC_DATAALIGN_RIGHT;
+    _handle.Init.ScanConvMode          = (count > 1)? ADC_SCAN_ENABLE : ADC_SCAN_DISABLE;
+    _handle.Init.EOCSelection          = ADC_EOC_SEQ_CONV;
+    _handle.Init.LowPowerAutoWait      = DISABLE;
+    _handle.Init.ContinuousConvMode    = DISABLE;
+    _handle.Init.NbrOfConversion       = count;
+    _handle.Init.DiscontinuousConvMode = DISABLE;
+    _handle.Init.NbrOfDiscConversion   = 1;
+    _handle.Init.ExternalTrigConv      = ADC_EXTERNALTRIG_T6_TRGO;
+    _handle.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_RISING;
+    _handle.Init.DMAContinuousRequests = ENABLE;
+    _handle.Init.Overrun               = ADC_OVR_DATA_OVERWRITTEN;
+    _handle.Init.OversamplingMode      = DISABLE;
+    if(HAL_ADC_Init(&_handle) != HAL_OK){
+        /* Configuration Error */
+        return;
+    }
+    for(uint8_t i = 0; i < count; i++){
+        ADC_ChannelConfTypeDef sConfig;
+        sConfig.Channel      = channels[i];
+        sConfig.Rank         = adc_ranks[i];
+        sConfig.SamplingTime = ADC_SAMPLETIME_47CYCLES_5;
+        sConfig.SingleDiff   = ADC_SINGLE_ENDED;
+        sConfig.OffsetNumber = ADC_OFFSET_NONE;
+        sConfig.Offset       = 0;
+        if(HAL_ADC_ConfigChannel(&_handle, &sConfig) != HAL_OK){
+            /* Configuration Error */
+            return;
+        }
+    }
+    HAL_ADCEx_Calibration_Start(&_handle, ADC_SINGLE_ENDED);
+
+    /* Configure the DMA handler for Reception process */
+    _hdma.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    _hdma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    _hdma.Init.MemInc              = DMA_MINC_ENABLE;
+    _hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    _hdma.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    _hdma.Init.Mode                = DMA_CIRCULAR;
+    _hdma.Init.Priority            = DMA_PRIORITY_HIGH;
+
+    HAL_DMA_Init(&_hdma);
+
+    /* Associate the initialized DMA handle to the the ADC handle */
+    __HAL_LINKDMA((&_handle), DMA_Handle, _hdma);
+
+    /* TIM6: base de tiempos de hz eventos de update por segundo, exportados en TRGO */
+    __HAL_RCC_TIM6_CLK_ENABLE();
+    uint32_t ticks = SystemCoreClock / hz;
+    uint32_t prescaler = (ticks - 1) / 0x10000;
+    _htim.Instance = TIM6;
+    _htim.Init.Prescaler = prescaler;
+    _htim.Init.CounterMode = TIM_COUNTERMODE_UP;
+    _htim.Init.Period = (ticks / (prescaler + 1)) - 1;
+    _htim.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    _htim.Init.RepetitionCounter = 0;
+    if(HAL_TIM_Base_Init(&_htim) != HAL_OK){
+        /* Configuration Error */
+        return;
+    }
+    TIM_MasterConfigTypeDef sMasterConfig;
+    sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+    if(HAL_TIMEx_MasterConfigSynchronization(&_htim, &sMasterConfig) != HAL_OK){
+        /* Configuration Error */
+        return;
+    }
+
+    /*##-4- Configure the NVIC for DMA and ADC #################################*/
+    IRQn_Type irqn = DMA::getIRQn(DMA::getChannel(_hdma.Instance));
+    HAL_NVIC_SetPriority(irqn, 1, 0);
+    HAL_NVIC_EnableIRQ(irqn);
+    NVIC_SetVector(ADC1_IRQn, (uint32_t)&adc1_irq);
+    HAL_NVIC_SetPriority(ADC1_IRQn, 1, 1);
+    HAL_NVIC_EnableIRQ(ADC1_IRQn);
+    _ready = true;
+}
+
+
+//------------------------------------------------------------------------------------
+DMA_ADC::~DMA_ADC(){
+    stop();
+    if(adc1Dma == this){
+        HAL_NVIC_DisableIRQ(ADC1_IRQn);
+        adc1Dma = 0;
+        DMA::adc1 = 0;
+    }
+    DMA::release(&_hdma);
+}
+
+
+//------------------------------------------------------------------------------------
+DMA_ADC::ErrorResult DMA_ADC::start(uint16_t* buf, uint16_t scans_per_block, Callback<void(const uint16_t*, uint16_t)>& xblockIsrCb,
+                                    Callback<void(ErrorResult)>& xerrIsrCb){
+    ErrorResult err;
+    if(!_ready){
+        return UNKNOWN_ERROR;
+    }
+    if(_running){
+        return BUSY_ERROR;
+    }
+    if(!buf || scans_per_block == 0 || ((uint32_t)scans_per_block * 2 * _count) > 0xFFFF){
+        return INVALID_ARGUMENTS;
+    }
+    blockIsrCb = xblockIsrCb;
+    errIsrCb = xerrIsrCb;
+    _buf = buf;
+    _scans = scans_per_block;
+    _overruns = 0;
+    if((err = (ErrorResult)HAL_ADC_Start_DMA(&_handle, (uint32_t*)buf, (uint32_t)scans_per_block * 2 * _count)) != NO_ERRORS){
+        return err;
+    }
+    // el primer barrido se dispara en el primer update de TIM6
+    __HAL_TIM_SET_COUNTER(&_htim, 0);
+    if((err = (ErrorResult)HAL_TIM_Base_Start(&_htim)) != NO_ERRORS){
+        HAL_ADC_Stop_DMA(&_handle);
+        return err;
+    }
+    _running = true;
+    return NO_ERRORS;
+}
+
+
+//------------------------------------------------------------------------------------
+DMA_ADC::ErrorResult DMA_ADC::stop(){
+    if(!_running){
+        return NO_ERRORS;
+    }
+    _running = false;
+    HAL_TIM_Base_Stop(&_htim);
+    return (ErrorResult)HAL_ADC_Stop_DMA(&_handle);
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_ADC::onBlock(uint8_t block){
+    uint32_t block_size = (uint32_t)_scans * _count;
+    blockIsrCb.call(&_buf[block * block_size], _scans);
+    // la entrega es válida si la DMA sigue escribiendo en el otro bloque al terminar el procesado
+    uint32_t pos = (2 * block_size) - __HAL_DMA_GET_COUNTER(&_hdma);
+    uint8_t writing = (pos < block_size)? 0 : 1;
+    if(writing == block){
+        _overruns++;
+    }
+}
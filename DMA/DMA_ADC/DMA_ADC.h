@@ -0,0 +1,134 @@
+/*
+ * DMA_ADC.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  DMA_ADC es un módulo C++ que proporciona muestreo continuo multicanal del ADC1 mediante DMA, sin interrupciones
+ *  por muestra. TIM6 dispara (TRGO) a la frecuencia indicada un barrido de todos los canales configurados, cuyos
+ *  resultados la DMA escribe en un buffer circular dividido en dos bloques (ping-pong):
+ *
+ *      bloque 0: scans [0, scans_per_block)            -> notificado en dma_half_transfer
+ *      bloque 1: scans [scans_per_block, 2*spb)        -> notificado en dma_transfer_complete
+ *
+ *  Cada bloque se entrega a blockIsrCb (contexto ISR) mientras la DMA rellena el otro, por lo que el procesado de
+ *  un bloque (p.ej. valor eficaz de corriente y tensión) dispone del tiempo de adquisición de un bloque completo.
+ *  Las muestras se almacenan entrelazadas: block[scan * channels + canal], en el orden de los pines del constructor.
+ *  Si blockIsrCb termina cuando la DMA ya ha empezado a reescribir el bloque entregado, se contabiliza un overrun
+ *  (ver getOverruns).
+ *
+ *  El ADC1 y TIM6 quedan dedicados a este driver (no se pueden usar AnalogIn simultáneamente). El canal DMA se
+ *  asigna mediante DMA::allocate (DMA1_Channel1 o DMA2_Channel3).
+ *
+ *  NOTA: Esta librería es compatible con procesadores STM32L4xx (pines PA_0..PA_7, PB_0 y PB_1).
+ */
+
+
+#ifndef DMA_ADC_H
+#define DMA_ADC_H
+
+
+#include "mbed.h"
+#include "DMA.h"
+
+
+
+//------------------------------------------------------------------------------------
+//- CLASS DMA_ADC --------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+class DMA_ADC : public DMA {
+  public:
+
+    enum ErrorResult{
+        NO_ERRORS = HAL_OK,
+        UNKNOWN_ERROR = HAL_ERROR,
+        BUSY_ERROR = HAL_BUSY,
+        TIMEOUT_ERROR = HAL_TIMEOUT,
+        INVALID_ARGUMENTS,
+        OVERRUN_ERROR,
+        TRANSFER_ERROR,
+    };
+
+    /** Número máximo de canales por barrido */
+    static const uint8_t MaxChannels = 10;
+
+    /** @fn DMA_ADC()
+     *  @brief Constructor, que configura el ADC1 para barrer los canales indicados disparado por TIM6
+     *  @param pins Pines analógicos, en el orden en que se almacenan en cada barrido
+     *  @param count Número de pines (1..MaxChannels)
+     *  @param hz Frecuencia de barrido (scans por segundo)
+     */
+    DMA_ADC(const PinName* pins, uint8_t count, uint32_t hz);
+
+
+    /** @fn ~DMA_ADC()
+     *  @brief Destructor, detiene el muestreo y libera el canal DMA
+     */
+    virtual ~DMA_ADC();
+
+
+    /** @fn start()
+     *  @brief Inicia el muestreo continuo sobre un buffer circular de 2 * scans_per_block * count muestras
+     *  @param buf Buffer de muestras, que debe permanecer válido hasta stop
+     *  @param scans_per_block Número de barridos de cada bloque
+     *  @param blockIsrCb Callback de procesado de cada bloque (puntero al bloque y número de barridos)
+     *  @param errIsrCb Callback para recibir errores (OVERRUN_ERROR del ADC, TRANSFER_ERROR de la DMA)
+     *  @return Código de error
+     */
+    ErrorResult start(uint16_t* buf, uint16_t scans_per_block, Callback<void(const uint16_t*, uint16_t)>& blockIsrCb,
+                        Callback<void(ErrorResult)>& errIsrCb);
+
+
+    /** @fn stop()
+     *  @brief Detiene el disparo y la DMA
+     *  @return Código de error
+     */
+    ErrorResult stop();
+
+
+    /** @fn getChannelCount()
+     *  @brief Obtiene el número de canales de cada barrido
+     */
+    uint8_t getChannelCount(){ return _count; }
+
+
+    /** @fn getOverruns()
+     *  @brief Obtiene el número de bloques cuyo procesado no terminó antes de que la DMA volviera a escribirlos
+     */
+    uint32_t getOverruns(){ return _overruns; }
+
+
+    /** @fn onBlock()
+     *  @brief Notifica un bloque completo (contexto ISR, uso interno)
+     *  @param block Bloque (0: primera mitad, 1: segunda mitad)
+     */
+    void onBlock(uint8_t block);
+
+
+    /** @fn getHandler()
+     *  @brief Obtiene la referencia al manejador ADC
+     *  @return Manejador adc
+     */
+    ADC_HandleTypeDef* getHandler(){ return &_handle; }
+
+    /** Callbacks de notificación de interrupción dma */
+    Callback<void(const uint16_t*, uint16_t)> blockIsrCb;
+    Callback<void(ErrorResult)> errIsrCb;
+
+  protected:
+    ADC_HandleTypeDef _handle;
+    DMA_HandleTypeDef _hdma;
+    TIM_HandleTypeDef _htim;
+    uint16_t* _buf;
+    uint16_t _scans;
+    uint8_t _count;
+    uint32_t _overruns;
+    bool _ready;
+    bool _running;
+};
+
+
+
+#endif   /* DMA_ADC_H */
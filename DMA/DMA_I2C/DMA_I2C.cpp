@@ -0,0 +1,326 @@
+/*
+ * DMA_I2C.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ */
+
+#include "DMA_I2C.h"
+
+
+
+//------------------------------------------------------------------------------------
+//- STATIC ---------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+static DMA_I2C* i2c1Dma;
+static DMA_I2C* i2c3Dma;
+
+static void unhandled_callback(){}
+static void unhandled_callback_2(DMA_I2C::ErrorResult err){}
+
+
+//------------------------------------------------------------------------------------
+static DMA_I2C* getInstance(I2C_HandleTypeDef* hi2c){
+    if(DMA::i2c1 == hi2c){
+        return i2c1Dma;
+    }
+    if(DMA::i2c3 == hi2c){
+        return i2c3Dma;
+    }
+    return 0;
+}
+
+
+//------------------------------------------------------------------------------------
+/** Vectores de interrupción I2Cx_EV/I2Cx_ER */
+static void i2c1_ev_irq(){
+    if(i2c1Dma){
+        i2c1Dma->isrHandler(false);
+    }
+}
+
+static void i2c1_er_irq(){
+    if(i2c1Dma){
+        i2c1Dma->isrHandler(true);
+    }
+}
+
+static void i2c3_ev_irq(){
+    if(i2c3Dma){
+        i2c3Dma->isrHandler(false);
+    }
+}
+
+static void i2c3_er_irq(){
+    if(i2c3Dma){
+        i2c3Dma->isrHandler(true);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+/** Callback de interrupción dma_transfer_error. Un error dma no pasa por las interrupciones I2Cx_EV/I2Cx_ER, por
+ *  lo que se intercepta en el propio canal */
+static void dmaErrorCallback(DMA_HandleTypeDef *hdma){
+    DMA_I2C* i2c = getInstance((I2C_HandleTypeDef*)hdma->Parent);
+    if(i2c){
+        i2c->dmaErrorHandler(hdma);
+    }
+}
+
+
+
+//------------------------------------------------------------------------------------
+//- PUBLIC CLASS IMPL. ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+DMA_I2C::DMA_I2C(PinName sda, PinName scl, int hz) : I2C(sda, scl){
+    I2C::frequency(hz);
+    _busy = false;
+    _addr = 0;
+    _rxbuf = 0;
+    _rxsize = 0;
+    _hal_dma_error = 0;
+    dmaCpltIsrCb = callback(unhandled_callback);
+    dmaErrIsrCb = callback(unhandled_callback_2);
+    _handle = &_i2c.i2c.handle;
+    _hdma_tx.Instance = 0;
+    _hdma_rx.Instance = 0;
+    DMA::Request tx_req, rx_req;
+    if(_handle->Instance == I2C1){
+        DMA::i2c1 = _handle;
+        i2c1Dma = this;
+        tx_req = DMA::ReqI2c1Tx;
+        rx_req = DMA::ReqI2c1Rx;
+        _ev_irq = I2C1_EV_IRQn;
+        _er_irq = I2C1_ER_IRQn;
+        _ev_vector = (uint32_t)&i2c1_ev_irq;
+        _er_vector = (uint32_t)&i2c1_er_irq;
+    }
+    else if(_handle->Instance == I2C3){
+        DMA::i2c3 = _handle;
+        i2c3Dma = this;
+        tx_req = DMA::ReqI2c3Tx;
+        rx_req = DMA::ReqI2c3Rx;
+        _ev_irq = I2C3_EV_IRQn;
+        _er_irq = I2C3_ER_IRQn;
+        _ev_vector = (uint32_t)&i2c3_ev_irq;
+        _er_vector = (uint32_t)&i2c3_er_irq;
+    }
+    else{
+        return;
+    }
+
+    /* Select free DMA channels for both requests and enable their clocks */
+    if(!DMA::allocate(tx_req, &_hdma_tx) || !DMA::allocate(rx_req, &_hdma_rx)){
+        error("DMA_I2C: sin canal DMA libre para las peticiones %d/%d\r\n", tx_req, rx_req);
+        return;
+    }
+
+    /* Configure the DMA handler for Transmission process */
+    _hdma_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    _hdma_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
+    _hdma_tx.Init.MemInc              = DMA_MINC_ENABLE;
+    _hdma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    _hdma_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    _hdma_tx.Init.Mode                = DMA_NORMAL;
+    _hdma_tx.Init.Priority            = DMA_PRIORITY_MEDIUM;
+
+    HAL_DMA_Init(&_hdma_tx);
+
+    /* Associate the initialized DMA handle to the the I2C handle */
+    __HAL_LINKDMA(_handle, hdmatx, _hdma_tx);
+
+    /* Configure the DMA handler for Reception process */
+    _hdma_rx.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    _hdma_rx.Init.PeriphInc           = DMA_PINC_DISABLE;
+    _hdma_rx.Init.MemInc              = DMA_MINC_ENABLE;
+    _hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    _hdma_rx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    _hdma_rx.Init.Mode                = DMA_NORMAL;
+    _hdma_rx.Init.Priority            = DMA_PRIORITY_MEDIUM;
+
+    HAL_DMA_Init(&_hdma_rx);
+
+    /* Associate the initialized DMA handle to the the I2C handle */
+    __HAL_LINKDMA(_handle, hdmarx, _hdma_rx);
+
+    /*##-4- Configure the NVIC for DMA #########################################*/
+    /* NVIC configuration for DMA transfer complete interrupt (I2Cx_TX) */
+    IRQn_Type irqn = DMA::getIRQn(DMA::getChannel(_hdma_tx.Instance));
+    HAL_NVIC_SetPriority(irqn, 1, 1);
+    HAL_NVIC_EnableIRQ(irqn);
+
+    /* NVIC configuration for DMA transfer complete interrupt (I2Cx_RX) */
+    irqn = DMA::getIRQn(DMA::getChannel(_hdma_rx.Instance));
+    HAL_NVIC_SetPriority(irqn, 1, 0);
+    HAL_NVIC_EnableIRQ(irqn);
+}
+
+
+//------------------------------------------------------------------------------------
+DMA_I2C::~DMA_I2C(){
+    DMA::release(&_hdma_tx);
+    DMA::release(&_hdma_rx);
+    if(i2c1Dma == this){ i2c1Dma = 0; DMA::i2c1 = 0; }
+    if(i2c3Dma == this){ i2c3Dma = 0; DMA::i2c3 = 0; }
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_I2C::transmit(uint8_t addr, uint8_t* txbuf, uint16_t size, Callback<void()>& xdmaCpltIsrCb,
+                                Callback<void(ErrorResult)>& xdmaErrIsrCb){
+    HAL_StatusTypeDef err = HAL_OK;
+    if(!start(xdmaCpltIsrCb, xdmaErrIsrCb)){
+        return;
+    }
+    core_util_critical_section_enter();
+    if((err = HAL_I2C_Master_Transmit_DMA(_handle, addr, txbuf, size)) == HAL_OK){
+        hookDmaError(&_hdma_tx);
+    }
+    core_util_critical_section_exit();
+    if(err != HAL_OK){
+        fail((ErrorResult)err);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_I2C::receive(uint8_t addr, uint8_t* rxbuf, uint16_t size, Callback<void()>& xdmaCpltIsrCb,
+                                Callback<void(ErrorResult)>& xdmaErrIsrCb){
+    HAL_StatusTypeDef err = HAL_OK;
+    if(!start(xdmaCpltIsrCb, xdmaErrIsrCb)){
+        return;
+    }
+    core_util_critical_section_enter();
+    if((err = HAL_I2C_Master_Receive_DMA(_handle, addr, rxbuf, size)) == HAL_OK){
+        hookDmaError(&_hdma_rx);
+    }
+    core_util_critical_section_exit();
+    if(err != HAL_OK){
+        fail((ErrorResult)err);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_I2C::transmitAndReceive(uint8_t addr, uint8_t* txbuf, uint16_t txsize, uint8_t* rxbuf, uint16_t rxsize,
+                                Callback<void()>& xdmaCpltIsrCb, Callback<void(ErrorResult)>& xdmaErrIsrCb){
+    HAL_StatusTypeDef err = HAL_OK;
+    if(!start(xdmaCpltIsrCb, xdmaErrIsrCb)){
+        return;
+    }
+    // la lectura se lanza desde checkState al terminar la escritura, que finaliza sin STOP (I2C_FIRST_FRAME)
+    _addr = addr;
+    _rxbuf = rxbuf;
+    _rxsize = rxsize;
+    core_util_critical_section_enter();
+    if((err = HAL_I2C_Master_Sequential_Transmit_DMA(_handle, addr, txbuf, txsize, I2C_FIRST_FRAME)) == HAL_OK){
+        hookDmaError(&_hdma_tx);
+    }
+    core_util_critical_section_exit();
+    if(err != HAL_OK){
+        fail((ErrorResult)err);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_I2C::isrHandler(bool error){
+    if(error){
+        HAL_I2C_ER_IRQHandler(_handle);
+    }
+    else{
+        HAL_I2C_EV_IRQHandler(_handle);
+    }
+    checkState();
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_I2C::dmaErrorHandler(DMA_HandleTypeDef* hdma){
+    // la callback de la HAL aborta la transferencia y deja el manejador en READY con HAL_I2C_ERROR_DMA
+    if(_hal_dma_error){
+        _hal_dma_error(hdma);
+    }
+    checkState();
+}
+
+
+
+//------------------------------------------------------------------------------------
+//- PROTECTED CLASS IMPL. ------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+void DMA_I2C::checkState(){
+    // la HAL deja el manejador en READY al finalizar cada fase, con o sin error
+    if(!_busy || _handle->State != HAL_I2C_STATE_READY){
+        return;
+    }
+    if(_handle->ErrorCode != HAL_I2C_ERROR_NONE){
+        fail((_handle->ErrorCode & HAL_I2C_ERROR_AF)? NACK_ERROR : TRANSFER_ERROR);
+        return;
+    }
+    if(_rxbuf){
+        // segunda fase: lectura con repeated start y STOP final
+        uint8_t* rxbuf = _rxbuf;
+        _rxbuf = 0;
+        if(HAL_I2C_Master_Sequential_Receive_DMA(_handle, _addr, rxbuf, _rxsize, I2C_LAST_FRAME) != HAL_OK){
+            fail(TRANSFER_ERROR);
+            return;
+        }
+        hookDmaError(&_hdma_rx);
+        return;
+    }
+    _busy = false;
+    dmaCpltIsrCb.call();
+}
+
+
+//------------------------------------------------------------------------------------
+bool DMA_I2C::start(Callback<void()>& xdmaCpltIsrCb, Callback<void(ErrorResult)>& xdmaErrIsrCb){
+    if(_hdma_tx.Instance == 0){
+        xdmaErrIsrCb.call(UNKNOWN_ERROR);
+        return false;
+    }
+    if(_busy){
+        xdmaErrIsrCb.call(BUSY_ERROR);
+        return false;
+    }
+    dmaCpltIsrCb = xdmaCpltIsrCb;
+    dmaErrIsrCb = xdmaErrIsrCb;
+    _rxbuf = 0;
+    _busy = true;
+    // los servicios bloqueantes de mbed pueden haber instalado sus propios vectores
+    NVIC_SetVector(_ev_irq, _ev_vector);
+    NVIC_SetVector(_er_irq, _er_vector);
+    HAL_NVIC_SetPriority(_ev_irq, 1, 2);
+    HAL_NVIC_SetPriority(_er_irq, 1, 2);
+    HAL_NVIC_EnableIRQ(_ev_irq);
+    HAL_NVIC_EnableIRQ(_er_irq);
+    return true;
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_I2C::hookDmaError(DMA_HandleTypeDef* hdma){
+    // la HAL instala su callback de error (I2C_DMAError) al iniciar cada fase: se conserva para que aborte la
+    // transferencia y se sustituye por la propia, que además notifica el error
+    if(hdma->XferErrorCallback != dmaErrorCallback){
+        _hal_dma_error = hdma->XferErrorCallback;
+    }
+    hdma->XferErrorCallback = dmaErrorCallback;
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_I2C::fail(ErrorResult err){
+    _busy = false;
+    _rxbuf = 0;
+    dmaErrIsrCb.call(err);
+}
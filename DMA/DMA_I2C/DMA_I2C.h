@@ -0,0 +1,183 @@
+/*
+ * DMA_I2C.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  DMA_I2C es un módulo C++ que proporciona transferencias I2C maestro asíncronas utilizando los canales DMA
+ *  asociados, de forma que el hilo llamante no queda bloqueado durante la transmisión (p.ej. la trama de 65 bytes
+ *  de PCA9685_ServoDrv::updateAll, ~650us a 1MHz).
+ *  Se pueden realizar operaciones de escritura, de lectura o de escritura seguida de lectura con repeated start
+ *  (típico acceso a registros: dirección de registro + datos leídos).
+ *  La notificación de eventos se delega a callbacks dedicadas: dmaCpltIsrCb y dmaErrIsrCb que se instalan en cada
+ *  operación y se invocan en contexto ISR.
+ *
+ *  Al heredar de I2C, los servicios bloqueantes de mbed (write, read) siguen disponibles sobre el mismo bus siempre
+ *  que no haya una transferencia dma en curso (ver isBusy).
+ *
+ *  Los canales DMA se asignan mediante DMA::allocate (I2C1: DMA1_Channel6/7 o DMA2_Channel7/6, I2C3:
+ *  DMA1_Channel2/3). El fin de cada transferencia lo señala el periférico I2C (STOP o TC), por lo que el driver
+ *  instala sus propios vectores de interrupción I2Cx_EV/I2Cx_ER al inicio de cada operación; éstos invocan a la HAL
+ *  igual que los de mbed. Los errores de los canales DMA, que la HAL no notifica por esas interrupciones, se
+ *  interceptan en la callback de error de cada canal.
+ *
+ *  NOTA: Esta librería es compatible con procesadores STM32L4xx (I2C1 e I2C3).
+ */
+
+
+#ifndef DMA_I2C_H
+#define DMA_I2C_H
+
+
+#include "mbed.h"
+#include "DMA.h"
+
+
+
+//------------------------------------------------------------------------------------
+//- CLASS DMA_I2C --------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+class DMA_I2C : public I2C, public DMA {
+  public:
+
+    enum ErrorResult{
+        NO_ERRORS = HAL_OK,
+        UNKNOWN_ERROR = HAL_ERROR,
+        BUSY_ERROR = HAL_BUSY,
+        TIMEOUT_ERROR = HAL_TIMEOUT,
+        TRANSFER_ERROR,
+        ABORT_ERROR,
+        NACK_ERROR,
+    };
+
+    /** @fn DMA_I2C()
+     *  @brief Constructor, que asocia un manejador I2C (I2C_x)
+     *  @param sda Línea sda del bus i2c
+     *  @param scl Línea scl del bus i2c
+     *  @param hz Velocidad del bus i2c
+     */
+    DMA_I2C(PinName sda, PinName scl, int hz = 100000);
+
+
+    /** @fn ~DMA_I2C()
+     *  @brief Destructor, libera los canales DMA
+     */
+    virtual ~DMA_I2C();
+
+
+    /** @fn transmit()
+     *  @brief Escribe un buffer en un esclavo por medio de DMA. El buffer debe permanecer válido hasta la
+     *         notificación de fin o error
+     *  @param addr Dirección i2c de 8 bits (7 bits desplazada a la izquierda, como en I2C::write)
+     *  @param txbuf Datos de origen
+     *  @param size Tamaño de los datos a enviar
+     *  @param dmaCpltIsrCb Callback para recibir el fin de la transferencia
+     *  @param dmaErrIsrCb Callback para recibir errores (NACK_ERROR si el esclavo no responde)
+     */
+    void transmit(uint8_t addr, uint8_t* txbuf, uint16_t size, Callback<void()>& dmaCpltIsrCb,
+                        Callback<void(ErrorResult)>& dmaErrIsrCb);
+
+
+    /** @fn receive()
+     *  @brief Lee un buffer de un esclavo por medio de DMA
+     *  @param addr Dirección i2c de 8 bits
+     *  @param rxbuf Datos de destino
+     *  @param size Tamaño de los datos a leer
+     *  @param dmaCpltIsrCb Callback para recibir el fin de la transferencia
+     *  @param dmaErrIsrCb Callback para recibir errores
+     */
+    void receive(uint8_t addr, uint8_t* rxbuf, uint16_t size, Callback<void()>& dmaCpltIsrCb,
+                        Callback<void(ErrorResult)>& dmaErrIsrCb);
+
+
+    /** @fn transmitAndReceive()
+     *  @brief Escribe un buffer y, sin liberar el bus (repeated start), lee otro del mismo esclavo por medio de DMA
+     *  @param addr Dirección i2c de 8 bits
+     *  @param txbuf Datos de origen para la escritura (p.ej. dirección de registro)
+     *  @param txsize Tamaño de los datos a enviar
+     *  @param rxbuf Datos de destino tras la lectura
+     *  @param rxsize Tamaño de los datos a leer
+     *  @param dmaCpltIsrCb Callback para recibir el fin de la lectura
+     *  @param dmaErrIsrCb Callback para recibir errores en cualquiera de las dos fases
+     */
+    void transmitAndReceive(uint8_t addr, uint8_t* txbuf, uint16_t txsize, uint8_t* rxbuf, uint16_t rxsize,
+                        Callback<void()>& dmaCpltIsrCb, Callback<void(ErrorResult)>& dmaErrIsrCb);
+
+
+    /** @fn isBusy()
+     *  @brief Indica si hay una transferencia dma en curso
+     *  @return True si está en curso
+     */
+    bool isBusy(){ return _busy; }
+
+
+    /** @fn isrHandler()
+     *  @brief Manejador de las interrupciones I2Cx_EV/I2Cx_ER (contexto ISR, uso interno)
+     *  @param error True si es la interrupción de error
+     */
+    void isrHandler(bool error);
+
+
+    /** @fn dmaErrorHandler()
+     *  @brief Manejador del error de transferencia de los canales dma (contexto ISR, uso interno)
+     *  @param hdma Canal dma en el que se ha producido el error
+     */
+    void dmaErrorHandler(DMA_HandleTypeDef* hdma);
+
+
+    /** @fn getHandler()
+     *  @brief Obtiene la referencia al manejador I2C
+     *  @return Manejador i2c
+     */
+    I2C_HandleTypeDef* getHandler(){ return _handle; }
+
+    /** Callbacks de notificación de interrupción dma */
+    Callback<void()> dmaCpltIsrCb;
+    Callback<void(ErrorResult)> dmaErrIsrCb;
+
+  protected:
+    I2C_HandleTypeDef* _handle;
+    DMA_HandleTypeDef _hdma_tx;
+    DMA_HandleTypeDef _hdma_rx;
+    IRQn_Type _ev_irq;
+    IRQn_Type _er_irq;
+    uint32_t _ev_vector;
+    uint32_t _er_vector;
+    volatile bool _busy;
+    uint8_t _addr;
+    uint8_t* _rxbuf;
+    uint16_t _rxsize;
+    void (*_hal_dma_error)(DMA_HandleTypeDef*);
+
+
+    /** @fn checkState()
+     *  @brief Comprueba si la fase en curso ha terminado: lanza la lectura de transmitAndReceive o notifica el fin
+     *         o el error de la transferencia
+     */
+    void checkState();
+
+
+    /** @fn hookDmaError()
+     *  @brief Intercepta el error de transferencia del canal dma de la fase recién iniciada
+     */
+    void hookDmaError(DMA_HandleTypeDef* hdma);
+
+
+    /** @fn start()
+     *  @brief Prepara una transferencia: instala callbacks y vectores de interrupción
+     *  @return True si puede iniciarse, False si hay otra en curso (notifica BUSY_ERROR)
+     */
+    bool start(Callback<void()>& xdmaCpltIsrCb, Callback<void(ErrorResult)>& xdmaErrIsrCb);
+
+
+    /** @fn fail()
+     *  @brief Finaliza la transferencia en curso con error
+     */
+    void fail(ErrorResult err);
+};
+
+
+
+#endif   /* DMA_I2C_H */
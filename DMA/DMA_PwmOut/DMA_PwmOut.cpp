@@ -19,11 +19,89 @@ static DMA_PwmOut* pwm_tim1_ch2 = 0;
 static DMA_PwmOut* pwm_tim1_ch3 = 0;
 static DMA_PwmOut* pwm_tim1_ch4 = 0;
 
+static void unhandled_callback(){}
+
+/** Uso compartido de TIM1: número de canales que lo utilizan y periodo con el que se configuró la base de tiempos */
+static uint8_t tim1_users = 0;
+static uint32_t tim1_period = 0;
+
+
+//------------------------------------------------------------------------------------
+/** Obtiene la instancia DMA_PwmOut asociada a un manejador TIM */
+static DMA_PwmOut* getInstance(TIM_HandleTypeDef *htim){
+    if(pwm_tim16_ch1 && pwm_tim16_ch1->getHandler() == htim){
+        return pwm_tim16_ch1;
+    }
+    if(pwm_tim1_ch1 && pwm_tim1_ch1->getHandler() == htim){
+        return pwm_tim1_ch1;
+    }
+    if(pwm_tim1_ch2 && pwm_tim1_ch2->getHandler() == htim){
+        return pwm_tim1_ch2;
+    }
+    if(pwm_tim1_ch3 && pwm_tim1_ch3->getHandler() == htim){
+        return pwm_tim1_ch3;
+    }
+    if(pwm_tim1_ch4 && pwm_tim1_ch4->getHandler() == htim){
+        return pwm_tim1_ch4;
+    }
+    return 0;
+}
+
+
+//------------------------------------------------------------------------------------
+/** Callback de interrupción dma_transfer_halfcomplete. La HAL del TIM no la propaga en todas sus versiones, por
+ *  lo que se instala directamente en el manejador DMA */
+static void dmaHalfCpltCallback(DMA_HandleTypeDef *hdma){
+    DMA_PwmOut* pwm = getInstance((TIM_HandleTypeDef*)hdma->Parent);
+    if(pwm){
+        pwm->dmaHalfIsrCb.call();
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+/** Callback de interrupción dma_transfer_complete para los canales armados con dmaArm, que no pasan por la HAL
+ *  del TIM */
+static void dmaCpltCallback(DMA_HandleTypeDef *hdma){
+    DMA_PwmOut* pwm = getInstance((TIM_HandleTypeDef*)hdma->Parent);
+    if(pwm){
+        if(pwm->isOneShot()){
+            pwm->dmaHalt();
+        }
+        pwm->dmaCpltIsrCb.call();
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+/** Callback de interrupción dma_transfer_error, instalada en lugar de la de la HAL del TIM (que no notifica al
+ *  canal). La HAL ya ha deshabilitado el canal dma, por lo que la salida se deja a nivel bajo como en un fin de envío */
+static void dmaErrorCallback(DMA_HandleTypeDef *hdma){
+    DMA_PwmOut* pwm = getInstance((TIM_HandleTypeDef*)hdma->Parent);
+    if(pwm){
+        pwm->dmaHalt();
+        pwm->dmaErrIsrCb.call();
+    }
+}
+
 
 //------------------------------------------------------------------------------------
 //- WEAK IMPL. -----------------------------------------------------------------------
 //------------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------------
+/** Callback de interrupción dma_transfer_complete */
+void HAL_TIM_PWM_PulseFinishedCallback(TIM_HandleTypeDef *htim){
+    DMA_PwmOut* pwm = getInstance(htim);
+    if(pwm){
+        if(pwm->isOneShot()){
+            pwm->dmaHalt();
+        }
+        pwm->dmaCpltIsrCb.call();
+    }
+}
+
+
 /** @defgroup HAL_MSP_Private_Functions
   * @{
   */
@@ -43,51 +121,48 @@ void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim){
     GPIO_TypeDef* port = GPIOA;    
     DMA_HandleTypeDef* hdma_tim;
     uint16_t ccreg;
-    IRQn_Type irqn;
-    uint32_t request;
-    DMA_Channel_TypeDef* dma_channel;
+    DMA::Request request;
+    DMA_PwmOut* pwm;
     
-    if(pwm_tim16_ch1->getHandler() == htim){
+    if(pwm_tim16_ch1 && pwm_tim16_ch1->getHandler() == htim){
+        pwm = pwm_tim16_ch1;
         GPIO_InitStruct = pwm_tim16_ch1->getGPIOTypeDef();
         hdma_tim = pwm_tim16_ch1->getDMAHandle();
-        request = DMA_REQUEST_4;
-        dma_channel = DMA1_Channel3;
-        irqn = DMA1_Channel3_IRQn;
+        request = DMA::ReqTim16Ch1;
         ccreg = TIM_DMA_ID_CC1;
 
     }
-    else if(pwm_tim1_ch1->getHandler() == htim){
+    else if(pwm_tim1_ch1 && pwm_tim1_ch1->getHandler() == htim){
+        pwm = pwm_tim1_ch1;
         GPIO_InitStruct = pwm_tim1_ch1->getGPIOTypeDef();
         hdma_tim = pwm_tim1_ch1->getDMAHandle();
-        request = DMA_REQUEST_7;
-        dma_channel = DMA1_Channel2;
-        irqn = DMA1_Channel2_IRQn;
+        request = DMA::ReqTim1Ch1;
         ccreg = TIM_DMA_ID_CC1;
     }
-    else if(pwm_tim1_ch2->getHandler() == htim){
+    else if(pwm_tim1_ch2 && pwm_tim1_ch2->getHandler() == htim){
+        pwm = pwm_tim1_ch2;
         GPIO_InitStruct = pwm_tim1_ch2->getGPIOTypeDef();
         hdma_tim = pwm_tim1_ch2->getDMAHandle();
-        request = DMA_REQUEST_7;
-        dma_channel = DMA1_Channel3;
-        irqn = DMA1_Channel3_IRQn;
+        request = DMA::ReqTim1Ch2;
         ccreg = TIM_DMA_ID_CC2;
     }
-    else if(pwm_tim1_ch3->getHandler() == htim){
+    else if(pwm_tim1_ch3 && pwm_tim1_ch3->getHandler() == htim){
+        pwm = pwm_tim1_ch3;
         GPIO_InitStruct = pwm_tim1_ch3->getGPIOTypeDef();
         hdma_tim = pwm_tim1_ch3->getDMAHandle();
-        request = DMA_REQUEST_7;
-        dma_channel = DMA1_Channel7;
-        irqn = DMA1_Channel7_IRQn;
+        request = DMA::ReqTim1Ch3;
         ccreg = TIM_DMA_ID_CC3;
     }
-    else if(pwm_tim1_ch4->getHandler() == htim){
+    else if(pwm_tim1_ch4 && pwm_tim1_ch4->getHandler() == htim){
+        pwm = pwm_tim1_ch4;
         GPIO_InitStruct = pwm_tim1_ch4->getGPIOTypeDef();
         hdma_tim = pwm_tim1_ch4->getDMAHandle();
-        request = DMA_REQUEST_7;
-        dma_channel = DMA1_Channel4;
-        irqn = DMA1_Channel4_IRQn;
+        request = DMA::ReqTim1Ch4;
         ccreg = TIM_DMA_ID_CC4;
     }    
+    else{
+        return;
+    }
 
     
     /* TIMx clock enable */
@@ -101,25 +176,24 @@ void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim){
     /* Enable GPIO  Clocks */
     __HAL_RCC_GPIOA_CLK_ENABLE();
 
-    /* Enable DMA clock */
-    __HAL_RCC_DMA1_CLK_ENABLE();
-    
     HAL_GPIO_Init(port, GPIO_InitStruct);
 
+    /* Select a free DMA channel for the request and enable its clock */
+    if(!DMA::allocate(request, hdma_tim)){
+        error("DMA_PwmOut: sin canal DMA libre para la peticion %d\r\n", request);
+        return;
+    }
 
     /* Set the parameters to be configured */
-    hdma_tim->Init.Request  = request;
     hdma_tim->Init.Direction = DMA_MEMORY_TO_PERIPH;
     hdma_tim->Init.PeriphInc = DMA_PINC_DISABLE;
     hdma_tim->Init.MemInc = DMA_MINC_ENABLE;
     hdma_tim->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
-    hdma_tim->Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma_tim->Init.MemDataAlignment = (pwm->getDutyWidth() == DMA_PwmOut::DutyWidth8)? DMA_MDATAALIGN_BYTE :
+                                      (pwm->getDutyWidth() == DMA_PwmOut::DutyWidth16)? DMA_MDATAALIGN_HALFWORD : DMA_MDATAALIGN_WORD;
     hdma_tim->Init.Mode = DMA_CIRCULAR;
     hdma_tim->Init.Priority = DMA_PRIORITY_HIGH;
 
-    /* Set hdma_tim instance */
-    hdma_tim->Instance = dma_channel;
-
     /* Link hdma_tim to hdma[TIM_DMA_ID_CC3] (channel3) */
     __HAL_LINKDMA(htim, hdma[ccreg], (*hdma_tim));
 
@@ -128,6 +202,7 @@ void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim){
 
     /*##-2- Configure the NVIC for DMA #########################################*/
     /* NVIC configuration for DMA transfer complete interrupt */
+    IRQn_Type irqn = DMA::getIRQn(DMA::getChannel(hdma_tim->Instance));
     HAL_NVIC_SetPriority(irqn, 0, 0);
     HAL_NVIC_EnableIRQ(irqn); 
 }
@@ -139,11 +214,28 @@ void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim){
 
 
 //------------------------------------------------------------------------------------
-DMA_PwmOut::DMA_PwmOut(PinName pin, uint32_t hz){ 
+DMA_PwmOut::DMA_PwmOut(PinName pin, uint32_t hz, DutyWidth width){ 
+    _dma_size = 0;
+    _period_ticks = 0;
+    _tim_user = false;
+    _handle.Instance = 0;
+    _hdma_tim.Instance = 0;
+    dmaHalfIsrCb = callback(unhandled_callback);
+    dmaCpltIsrCb = callback(unhandled_callback);
+    dmaErrIsrCb = callback(unhandled_callback);
+    
+    // ajusta el ancho del buffer dma para que el periodo quepa en él
+    uint32_t period = (uint32_t)((SystemCoreClock / hz) - 1);
+    _width = width;
+    if(_width == DutyWidth8 && period > 0xFF){
+        _width = DutyWidth16;
+    }
+    if(_width == DutyWidth16 && period > 0xFFFF){
+        _width = DutyWidth32;
+    }
     
     switch(pin){
         case PA_6:{
-            DMA::tim16_ch1 = &_handle;
             pwm_tim16_ch1 = this;
             _handle.Instance = TIM16;
             _channel = TIM_CHANNEL_1;
@@ -155,7 +247,6 @@ DMA_PwmOut::DMA_PwmOut(PinName pin, uint32_t hz){
             break;
         }
         case PA_8:{
-            DMA::tim1_ch1 = &_handle;
             pwm_tim1_ch1 = this;
             _handle.Instance = TIM1;
             _channel = TIM_CHANNEL_1;
@@ -167,7 +258,6 @@ DMA_PwmOut::DMA_PwmOut(PinName pin, uint32_t hz){
             break;
         }
         case PA_9:{
-            DMA::tim1_ch2 = &_handle;
             pwm_tim1_ch2 = this;
             _handle.Instance = TIM1;
             _channel = TIM_CHANNEL_2;
@@ -179,7 +269,6 @@ DMA_PwmOut::DMA_PwmOut(PinName pin, uint32_t hz){
             break;
         }
         case PA_10:{
-            DMA::tim1_ch3 = &_handle;
             pwm_tim1_ch3 = this;
             _handle.Instance = TIM1;
             _channel = TIM_CHANNEL_3;
@@ -191,7 +280,6 @@ DMA_PwmOut::DMA_PwmOut(PinName pin, uint32_t hz){
             break;
         }
         case PA_11:{
-            DMA::tim1_ch4 = &_handle;
             pwm_tim1_ch4 = this;
             _handle.Instance = TIM1;
             _channel = TIM_CHANNEL_4;
@@ -203,22 +291,49 @@ DMA_PwmOut::DMA_PwmOut(PinName pin, uint32_t hz){
             break;
         }
         default:{
+            // pin sin timer asociado: el canal queda sin configurar y no admite operaciones (ver hasTimer)
             return;
         }
     }
-    do{
+    // si TIM1 ya está configurado por otro canal, no se reinicia su base de tiempos (detendría o desfasaría a los
+    // demás canales). Sólo se inicializan los recursos propios del canal (gpio y dma)
+    if(_handle.Instance == TIM1 && tim1_users > 0){
+        if(period != tim1_period){
+            /* Configuration Error: el periodo debe coincidir con el de los demás canales */
+            error("DMA_PwmOut: periodo %d distinto del de TIM1 (%d)\r\n", period, tim1_period);
+            return;
+        }
         _handle.Init.RepetitionCounter  = 0;
         _handle.Init.Prescaler          = 0; 
-        _handle.Init.Period             = (uint32_t)((SystemCoreClock / hz) - 1);
+        _handle.Init.Period             = period;
         _handle.Init.ClockDivision      = 0;
         _handle.Init.CounterMode        = TIM_COUNTERMODE_UP;
         HAL_TIM_PWM_DeInit(&_handle);
+        HAL_TIM_PWM_MspInit(&_handle);
+        _handle.State = HAL_TIM_STATE_READY;
+        tim1_users++;
+        _tim_user = true;
+    }
+    else{
+        do{
+            _handle.Init.RepetitionCounter  = 0;
+            _handle.Init.Prescaler          = 0; 
+            _handle.Init.Period             = period;
+            _handle.Init.ClockDivision      = 0;
+            _handle.Init.CounterMode        = TIM_COUNTERMODE_UP;
+            HAL_TIM_PWM_DeInit(&_handle);
         
-        if (HAL_TIM_PWM_Init(&_handle) != HAL_OK) {
-            /* Initialization Error */
-            return;
-        }
-    }while(_handle.State != HAL_TIM_STATE_READY);
+            if (HAL_TIM_PWM_Init(&_handle) != HAL_OK) {
+                /* Initialization Error */
+                return;
+            }
+            if(_handle.Instance == TIM1){
+                tim1_users = 1;
+                tim1_period = period;
+                _tim_user = true;
+            }
+        }while(_handle.State != HAL_TIM_STATE_READY);
+    }
     
     _period_ticks = _handle.Init.Period;
     
@@ -238,25 +353,192 @@ DMA_PwmOut::DMA_PwmOut(PinName pin, uint32_t hz){
 
 
 //------------------------------------------------------------------------------------
-DMA_PwmOut::ErrorResult DMA_PwmOut::dmaStart(uint32_t* buf, uint16_t bufsize){
+DMA_PwmOut::~DMA_PwmOut(){
+    if(pwm_tim16_ch1 == this){ pwm_tim16_ch1 = 0; }
+    if(pwm_tim1_ch1 == this){ pwm_tim1_ch1 = 0; }
+    if(pwm_tim1_ch2 == this){ pwm_tim1_ch2 = 0; }
+    if(pwm_tim1_ch3 == this){ pwm_tim1_ch3 = 0; }
+    if(pwm_tim1_ch4 == this){ pwm_tim1_ch4 = 0; }
+    DMA::release(&_hdma_tim);
+    // libera la base de tiempos compartida, que se reconfigurará con el siguiente canal que se cree
+    if(_tim_user && tim1_users > 0){
+        tim1_users--;
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+DMA_PwmOut::ErrorResult DMA_PwmOut::dmaStart(void* buf, uint16_t bufsize, Callback<void()>& xdmaHalfIsrCb, Callback<void()>& xdmaCpltIsrCb){
     DMA_PwmOut::ErrorResult err;
-    _sConfig.Pulse = *buf;
-    if ((err = (DMA_PwmOut::ErrorResult)HAL_TIM_PWM_ConfigChannel(&_handle, &_sConfig, _channel)) == HAL_OK)  {
-        return (DMA_PwmOut::ErrorResult)HAL_TIM_PWM_Start_DMA(&_handle, _channel, buf, bufsize);
+    dmaHalfIsrCb = xdmaHalfIsrCb;
+    dmaCpltIsrCb = xdmaCpltIsrCb;
+    if((err = dmaStart(buf, bufsize)) == NO_ERRORS){
+        // habilita la interrupción de mitad de buffer con la callback propia
+        _hdma_tim.XferHalfCpltCallback = dmaHalfCpltCallback;
+        __HAL_DMA_ENABLE_IT(&_hdma_tim, DMA_IT_HT);
+    }
+    return err;
+}
+
+
+//------------------------------------------------------------------------------------
+DMA_PwmOut::ErrorResult DMA_PwmOut::dmaStart(void* buf, uint16_t bufsize){
+    DMA_PwmOut::ErrorResult err;
+    if(!hasTimer()){
+        return UNKNOWN_ERROR;
+    }
+    _sConfig.Pulse = firstDuty(buf);
+    _dma_size = bufsize;
+    if ((err = (DMA_PwmOut::ErrorResult)HAL_TIM_PWM_ConfigChannel(&_handle, &_sConfig, _channel)) != HAL_OK)  {
+        return err;
     } 
+    if((err = (DMA_PwmOut::ErrorResult)HAL_TIM_PWM_Start_DMA(&_handle, _channel, (uint32_t*)buf, bufsize)) == HAL_OK){
+        _hdma_tim.XferErrorCallback = dmaErrorCallback;
+    }
     return err;    
 }
 
 
+//------------------------------------------------------------------------------------
+DMA_PwmOut::ErrorResult DMA_PwmOut::dmaArm(void* buf, uint16_t bufsize, Callback<void()>& xdmaHalfIsrCb, Callback<void()>& xdmaCpltIsrCb){
+    DMA_PwmOut::ErrorResult err;
+    if(!hasTimer()){
+        return UNKNOWN_ERROR;
+    }
+    dmaHalfIsrCb = xdmaHalfIsrCb;
+    dmaCpltIsrCb = xdmaCpltIsrCb;
+    _sConfig.Pulse = firstDuty(buf);
+    _dma_size = bufsize;
+    if ((err = (DMA_PwmOut::ErrorResult)HAL_TIM_PWM_ConfigChannel(&_handle, &_sConfig, _channel)) != HAL_OK)  {
+        return err;
+    }
+    // mismos pasos que HAL_TIM_PWM_Start_DMA, salvo la habilitación del contador (ver timerStart)
+    _hdma_tim.XferCpltCallback = dmaCpltCallback;
+    _hdma_tim.XferHalfCpltCallback = dmaHalfCpltCallback;
+    _hdma_tim.XferErrorCallback = dmaErrorCallback;
+    if((err = (DMA_PwmOut::ErrorResult)HAL_DMA_Start_IT(&_hdma_tim, (uint32_t)buf, (uint32_t)getCCR(), bufsize)) != HAL_OK){
+        return err;
+    }
+    __HAL_TIM_ENABLE_DMA(&_handle, (TIM_DMA_CC1 << (_channel >> 2)));
+    TIM_CCxChannelCmd(_handle.Instance, _channel, TIM_CCx_ENABLE);
+    _handle.State = HAL_TIM_STATE_BUSY;
+    return NO_ERRORS;
+}
+
+
+//------------------------------------------------------------------------------------
+DMA_PwmOut::ErrorResult DMA_PwmOut::dmaSend(void* buf, uint16_t bufsize, Callback<void()>& xdmaCpltIsrCb){
+    DMA_PwmOut::ErrorResult err;
+    Callback<void()> half = callback(unhandled_callback);
+    if((err = dmaArm(buf, bufsize, half, xdmaCpltIsrCb)) != NO_ERRORS){
+        return err;
+    }
+    // el contador puede seguir en marcha (timer compartido), en cuyo caso la dma arranca en el siguiente periodo
+    if((_handle.Instance->CR1 & TIM_CR1_CEN) == 0){
+        timerStart();
+    }
+    return NO_ERRORS;
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_PwmOut::dmaSetErrorCb(Callback<void()> xdmaErrIsrCb){
+    dmaErrIsrCb = xdmaErrIsrCb;
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_PwmOut::dmaSetOneShot(bool oneshot){
+    if(!hasTimer()){
+        return;
+    }
+    _hdma_tim.Init.Mode = (oneshot)? DMA_NORMAL : DMA_CIRCULAR;
+    HAL_DMA_Init(&_hdma_tim);
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_PwmOut::dmaHalt(){
+    if(!hasTimer()){
+        return;
+    }
+    // la última petición dma llega en el flanco de bajada del último pulso: con duty 0 la salida queda a nivel bajo
+    __HAL_TIM_DISABLE_DMA(&_handle, (TIM_DMA_CC1 << (_channel >> 2)));
+    *getCCR() = 0;
+    // el contador sólo se detiene si ningún otro canal depende de él
+    if(_handle.Instance != TIM1 || tim1_users <= 1){
+        timerStop();
+    }
+    _handle.State = HAL_TIM_STATE_READY;
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_PwmOut::timerStart(){
+    if(!hasTimer()){
+        return;
+    }
+    __HAL_TIM_SET_COUNTER(&_handle, 0);
+    __HAL_TIM_MOE_ENABLE(&_handle);
+    _handle.Instance->CR1 |= TIM_CR1_CEN;
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_PwmOut::timerStop(){
+    if(!hasTimer()){
+        return;
+    }
+    // __HAL_TIM_DISABLE no detiene el contador mientras haya canales habilitados
+    _handle.Instance->CR1 &= ~(TIM_CR1_CEN);
+}
+
+
 //------------------------------------------------------------------------------------
 DMA_PwmOut::ErrorResult DMA_PwmOut::dmaStop(){
+    dmaHalfIsrCb = callback(unhandled_callback);
+    dmaCpltIsrCb = callback(unhandled_callback);
+    if(!hasTimer()){
+        return UNKNOWN_ERROR;
+    }
     return (DMA_PwmOut::ErrorResult)HAL_TIM_PWM_Stop_DMA(&_handle, _channel);
 }
 
 
 
+//------------------------------------------------------------------------------------
+void DMA_PwmOut::dmaSetBuffer(void* buf){
+    if(!hasTimer()){
+        return;
+    }
+    // la dirección de memoria sólo puede cambiarse con el canal deshabilitado
+    __HAL_DMA_DISABLE(&_hdma_tim);
+    _hdma_tim.Instance->CMAR = (uint32_t)buf;
+    _hdma_tim.Instance->CNDTR = _dma_size;
+    __HAL_DMA_ENABLE(&_hdma_tim);
+}
+
+
+
 //------------------------------------------------------------------------------------
 //- PROTECTED CLASS IMPL. ------------------------------------------------------------
 //------------------------------------------------------------------------------------
 
 
+//------------------------------------------------------------------------------------
+uint32_t DMA_PwmOut::firstDuty(void* buf){
+    // el primer valor del buffer se precarga en el canal según el ancho de los elementos
+    switch(_width){
+        case DutyWidth8:    return *((uint8_t*)buf);
+        case DutyWidth16:   return *((uint16_t*)buf);
+        default:            return *((uint32_t*)buf);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+volatile uint32_t* DMA_PwmOut::getCCR(){
+    // CCR1..CCR4 son consecutivos y TIM_CHANNEL_x = 4*(x-1)
+    return (&_handle.Instance->CCR1 + (_channel >> 2));
+}
+
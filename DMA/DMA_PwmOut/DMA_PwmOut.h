@@ -4,18 +4,42 @@
  *  Created on: Oct 2017
  *      Author: raulMrello
  *
- *  DMA_PwmOut es un mdulo C++ que proporciona acceso al perifrico TIM1 para implementar clases PwmOut con 
+ *  DMA_PwmOut es un módulo C++ que proporciona acceso al periférico TIM1 para implementar clases PwmOut con 
  *  capacidades de DMA, para cambiar el ciclo de trabajo en tiempo real, a partir de un buffer de valores DUTYCYCLE.
  *
- *  NOTA: Slo se permite TIM1, TIM15 y TIM16. TIM2 mbed lo usa como base de tiempos para el us_ticker y no se puede usar.
+ *  NOTA: Sólo se permite TIM1, TIM15 y TIM16. TIM2 mbed lo usa como base de tiempos para el us_ticker y no se puede usar.
  *  Por lo tanto las posibles configuraciones son:
  *
- *  PA_6 (TIM16_CH1) DMA1_Channel3
+ *  PA_6 (TIM16_CH1) DMA1_Channel3 (o DMA1_Channel6 si está ocupado)
  *  PA_8 (TIM1_CH1)  DMA1_Channel2
  *  PA_9 (TIM1_CH2)  DMA1_Channel3
  *  PA_10 (TIM1_CH3) DMA1_Channel7
  *  PA_11 (TIM1_CH4) DMA1_Channel4
  *
+ *  El canal se asigna mediante DMA::allocate al inicializar el timer; si no queda canal libre la ejecución se detiene
+ *  con error(). getRequest(pin) permite comprobar conflictos en tiempo de compilación con DMA::conflicts.
+ *
+ *  El buffer de valores DUTYCYCLE puede ser de 8, 16 o 32 bits por elemento (DutyWidth). El lado del periférico
+ *  (registro CCRx) siempre se accede como palabra de 32 bits y la DMA rellena con ceros los bits superiores, por lo
+ *  que con buffers de 8 o 16 bits se reduce la RAM necesaria a 1/4 o 1/2 siempre que el periodo del pwm quepa en
+ *  dicho ancho.
+ *
+ *  Opcionalmente, dmaStart puede instalar callbacks para las interrupciones dma_half_transfer y dma_complete_transfer,
+ *  lo que permite rellenar un buffer circular por mitades mientras la DMA envía la otra mitad.
+ *
+ *  Los canales de TIM1 (PA_8..PA_11) comparten una única base de tiempos. El primer canal que se crea configura TIM1
+ *  y los siguientes sólo inicializan su gpio y su canal dma, por lo que deben usar la misma frecuencia (en caso
+ *  contrario el canal queda sin configurar). Para arrancar varios canales en fase se arma cada uno con dmaArm(), que
+ *  no habilita el contador, y después se invoca timerStart() una única vez.
+ *
+ *  Por defecto la DMA es circular y el buffer se retransmite indefinidamente. Con dmaSetOneShot(true) cada envío
+ *  (dmaSend) transmite el buffer una sola vez: al terminar se deshabilita la petición dma del canal, la salida queda a
+ *  nivel bajo (duty 0), se detiene el contador si no lo usa otro canal y se notifica dmaCpltIsrCb. Para que el último
+ *  valor útil llegue a emitirse, el buffer debe terminar en un elemento a 0.
+ *
+ *  Los errores de transferencia dma se notifican con la callback instalada con dmaSetErrorCb, tras detener la dma y
+ *  dejar la salida a nivel bajo.
+ *
  */
  
  
@@ -47,35 +71,124 @@ class DMA_PwmOut : public DMA {
         TRANSFER_ERROR,        
         ABORT_ERROR,
     };
+    
+    /** Ancho en bytes de cada elemento del buffer de valores DUTYCYCLE */
+    enum DutyWidth{
+        DutyWidth8 = 1,
+        DutyWidth16 = 2,
+        DutyWidth32 = 4,
+    };
 	
     /** @fn DMA_PwmOut()
      *  @brief Constructor, que asocia un manejador PwmOut
      *  @param pin Pin de salida
      *  @param hz Frecuencia del ciclo pwm
+     *  @param width Ancho de cada elemento del buffer dma. Si el periodo del pwm no cabe en el ancho solicitado,
+     *         se selecciona automáticamente el ancho inmediatamente superior (ver getDutyWidth)
      */
-    DMA_PwmOut(PinName pin, uint32_t hz);
+    DMA_PwmOut(PinName pin, uint32_t hz, DutyWidth width = DutyWidth32);
 
 	
     /** @fn ~DMA_PwmOut()
      *  @brief Destructor por defecto
      */
-    virtual ~DMA_PwmOut(){}
+    virtual ~DMA_PwmOut();
 
 	
     /** @fn dmaStart()
      *  @brief Inicia la escritura del duty cycle via dma
-     *  @param buf Datos de origen (configuraciones del duty cycle)
-     *  @param bufsize Tamao de los datos a enviar
+     *  @param buf Datos de origen (configuraciones del duty cycle), con elementos de getDutyWidth() bytes
+     *  @param bufsize Número de elementos a enviar
+     */
+    ErrorResult dmaStart(void* buf, uint16_t bufsize);
+
+	
+    /** @fn dmaStart()
+     *  @brief Inicia la escritura del duty cycle via dma, notificando las interrupciones de mitad y fin de buffer
+     *  @param buf Datos de origen (configuraciones del duty cycle), con elementos de getDutyWidth() bytes
+     *  @param bufsize Número de elementos a enviar
+     *  @param dmaHalfIsrCb Callback para recibir eventos halfDma
+     *  @param dmaCpltIsrCb Callback para recibir eventos CpltDma
+     */
+    ErrorResult dmaStart(void* buf, uint16_t bufsize, Callback<void()>& dmaHalfIsrCb, Callback<void()>& dmaCpltIsrCb);
+
+	
+    /** @fn dmaArm()
+     *  @brief Prepara la escritura del duty cycle via dma sin habilitar el contador del timer, que se arranca 
+     *         posteriormente con timerStart(). Permite iniciar en fase varios canales del mismo timer
+     *  @param buf Datos de origen (configuraciones del duty cycle), con elementos de getDutyWidth() bytes
+     *  @param bufsize Número de elementos a enviar
+     *  @param dmaHalfIsrCb Callback para recibir eventos halfDma
+     *  @param dmaCpltIsrCb Callback para recibir eventos CpltDma
+     */
+    ErrorResult dmaArm(void* buf, uint16_t bufsize, Callback<void()>& dmaHalfIsrCb, Callback<void()>& dmaCpltIsrCb);
+
+	
+    /** @fn dmaSend()
+     *  @brief Envía una única vez un buffer (modo OneShot, ver dmaSetOneShot) y habilita el contador si estaba
+     *         detenido. Al terminar, la salida queda a nivel bajo y se notifica dmaCpltIsrCb
+     *  @param buf Datos de origen, con elementos de getDutyWidth() bytes. El último elemento debe ser 0
+     *  @param bufsize Número de elementos a enviar
+     *  @param dmaCpltIsrCb Callback para recibir el evento de fin de envío
+     */
+    ErrorResult dmaSend(void* buf, uint16_t bufsize, Callback<void()>& dmaCpltIsrCb);
+
+	
+    /** @fn dmaSetErrorCb()
+     *  @brief Instala la callback de error de transferencia dma (contexto ISR). Tras un error la dma queda detenida y
+     *         la salida a nivel bajo. Se mantiene entre envíos
+     *  @param dmaErrIsrCb Callback para recibir eventos de error dma
+     */
+    void dmaSetErrorCb(Callback<void()> dmaErrIsrCb);
+
+	
+    /** @fn dmaSetOneShot()
+     *  @brief Selecciona dma circular (por defecto) o de un único envío. Debe invocarse con la dma detenida
+     *  @param oneshot True para envíos únicos, False para retransmisión continua
+     */
+    void dmaSetOneShot(bool oneshot);
+
+	
+    /** @fn isOneShot()
+     *  @brief Indica si la dma está configurada para envíos únicos
+     *  @return True en modo OneShot
+     */
+    bool isOneShot() { return (_hdma_tim.Init.Mode == DMA_NORMAL); }
+
+	
+    /** @fn dmaHalt()
+     *  @brief Finaliza un envío único dejando la salida a nivel bajo. Se invoca desde la interrupción de fin de
+     *         buffer, justo tras el flanco de bajada del último pulso
      */
-    ErrorResult dmaStart(uint32_t* buf, uint16_t bufsize);
+    void dmaHalt();
+
+	
+    /** @fn timerStart()
+     *  @brief Pone a cero y habilita el contador del timer, común a todos sus canales
+     */
+    void timerStart();
+
+	
+    /** @fn timerStop()
+     *  @brief Detiene el contador del timer, común a todos sus canales, aunque haya canales habilitados
+     */
+    void timerStop();
 
 	
     /** @fn dmaStop()
-     *  @brief Detiene la salida va dma
+     *  @brief Detiene la salida vía dma
      */
     ErrorResult dmaStop();
 
 	
+    /** @fn dmaSetBuffer()
+     *  @brief Reapunta la DMA en curso a otro buffer del mismo tamaño, que se empieza a enviar desde su primer
+     *         elemento. Está pensado para invocarse desde dmaCpltIsrCb (contexto ISR)
+     *  @param buf Nuevo buffer de origen, con el mismo número de elementos que el indicado en dmaStart
+     */
+    void dmaSetBuffer(void* buf);
+
+	
     /** @fn getHandler()
      *  @brief Obtiene la referencia al manejador TIM
      *  @return Manejador tim
@@ -94,6 +207,21 @@ class DMA_PwmOut : public DMA {
     }
 
 	
+    /** @fn getRequest()
+     *  @brief Obtiene la petición DMA asociada a un pin pwm (constexpr). Un pin no soportado no es una expresión
+     *         constante válida para DMA::conflicts
+     *  @param pin Pin de salida
+     *  @return Petición DMA o RequestCount
+     */
+    static constexpr DMA::Request getRequest(PinName pin){
+        return (pin == PA_6)?  DMA::ReqTim16Ch1 :
+               (pin == PA_8)?  DMA::ReqTim1Ch1 :
+               (pin == PA_9)?  DMA::ReqTim1Ch2 :
+               (pin == PA_10)? DMA::ReqTim1Ch3 :
+               (pin == PA_11)? DMA::ReqTim1Ch4 : DMA::RequestCount;
+    }
+
+	
     /** @fn getDMAHandle()
      *  @brief Obtiene la referencia al manejador DMA
      *  @return Manejador dma
@@ -103,13 +231,37 @@ class DMA_PwmOut : public DMA {
     }
 
 	
+    /** @fn getDutyWidth()
+     *  @brief Obtiene el ancho de cada elemento del buffer dma
+     *  @return Ancho en bytes (1, 2 o 4)
+     */
+    DutyWidth getDutyWidth(){
+        return _width; 
+    }
+
+	
     /** @fn getTickPercent()
-     *  @brief Obtiene el nmero de ticks para un porcentaje del duty cycle dado
+     *  @brief Obtiene el número de ticks para un porcentaje del duty cycle dado
      *  @return Ticks correspondientes a un porcentaje 0..100%
      */
     uint32_t getTickPercent(uint8_t percent){
         return ((uint32_t)(((uint32_t) percent * _period_ticks) / 100)); 
     }
+
+	
+    /** @fn hasTimer()
+     *  @brief Indica si el canal tiene un timer configurado. Con un pin no soportado (p.ej. NC) no lo tiene, y las
+     *         operaciones de dma y timer no hacen nada o devuelven UNKNOWN_ERROR
+     *  @return True si la base de tiempos está configurada
+     */
+    bool hasTimer(){
+        return (_period_ticks != 0); 
+    }
+
+    /** Callbacks de notificación de interrupción dma */
+    Callback<void()> dmaHalfIsrCb;
+    Callback<void()> dmaCpltIsrCb;
+    Callback<void()> dmaErrIsrCb;
     
         
   protected:              
@@ -121,6 +273,24 @@ class DMA_PwmOut : public DMA {
     
     uint32_t _channel;
     uint32_t _period_ticks;
+    uint16_t _dma_size;
+    DutyWidth _width;
+    bool _tim_user;
+
+	
+    /** @fn firstDuty()
+     *  @brief Obtiene el primer valor de un buffer dma, que se precarga en el canal antes de iniciar la dma
+     *  @param buf Buffer dma
+     *  @return Valor duty
+     */
+    uint32_t firstDuty(void* buf);
+
+	
+    /** @fn getCCR()
+     *  @brief Obtiene el registro de comparación del canal, destino de la dma
+     *  @return Puntero al registro CCRx
+     */
+    volatile uint32_t* getCCR();
 };    
 
 
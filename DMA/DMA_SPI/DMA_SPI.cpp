@@ -24,7 +24,7 @@ static DMA_SPI* spi3Dma;
 
 
 //------------------------------------------------------------------------------------
-/** Callback de interrupcin dma_transmit_complete */
+/** Callback de interrupción dma_transmit_complete */
 void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi){
     if(DMA::spi1 == hspi){
         spi1Dma->dmaCpltIsrCb.call();
@@ -38,7 +38,7 @@ void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi){
 
 
 //------------------------------------------------------------------------------------
-/** Callback de interrupcin dma_receive_complete */
+/** Callback de interrupción dma_receive_complete */
 void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi){
     if(DMA::spi1 == hspi){
         spi1Dma->dmaCpltIsrCb.call();
@@ -52,7 +52,7 @@ void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi){
 
 
 //------------------------------------------------------------------------------------
-/** Callback de interrupcin dma_transmit_receive_complete */
+/** Callback de interrupción dma_transmit_receive_complete */
 void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi){
     if(DMA::spi1 == hspi){
         spi1Dma->dmaCpltIsrCb.call();
@@ -66,7 +66,7 @@ void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi){
 
 
 //------------------------------------------------------------------------------------
-/** Callback de interrupcin dma_transmit_halfcomplete */
+/** Callback de interrupción dma_transmit_halfcomplete */
 void HAL_SPI_TxHalfCpltCallback(SPI_HandleTypeDef *hspi){
     if(DMA::spi1 == hspi){
         spi1Dma->dmaHalfIsrCb.call();
@@ -80,7 +80,7 @@ void HAL_SPI_TxHalfCpltCallback(SPI_HandleTypeDef *hspi){
 
 
 //------------------------------------------------------------------------------------
-/** Callback de interrupcin dma_receive_halfcomplete */
+/** Callback de interrupción dma_receive_halfcomplete */
 void HAL_SPI_RxHalfCpltCallback(SPI_HandleTypeDef *hspi){
     if(DMA::spi1 == hspi){
         spi1Dma->dmaHalfIsrCb.call();
@@ -94,7 +94,7 @@ void HAL_SPI_RxHalfCpltCallback(SPI_HandleTypeDef *hspi){
 
 
 //------------------------------------------------------------------------------------
-/** Callback de interrupcin dma_transmit_receive_halfcomplete */
+/** Callback de interrupción dma_transmit_receive_halfcomplete */
 void HAL_SPI_TxRxHalfCpltCallback(SPI_HandleTypeDef *hspi){
     if(DMA::spi1 == hspi){
         spi1Dma->dmaHalfIsrCb.call();
@@ -108,7 +108,7 @@ void HAL_SPI_TxRxHalfCpltCallback(SPI_HandleTypeDef *hspi){
 
 
 //------------------------------------------------------------------------------------
-/** Callback de interrupcin dma_error */
+/** Callback de interrupción dma_error */
 void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi){
     if(DMA::spi1 == hspi){
         spi1Dma->dmaErrIsrCb.call(DMA_SPI::TRANSFER_ERROR);
@@ -122,7 +122,7 @@ void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi){
 
 
 //------------------------------------------------------------------------------------
-/** Callback de interrupcin dma_abort */
+/** Callback de interrupción dma_abort */
 void HAL_SPI_AbortCpltCallback(SPI_HandleTypeDef *hspi){
     if(DMA::spi1 == hspi){
         spi1Dma->dmaErrIsrCb.call(DMA_SPI::ABORT_ERROR);
@@ -144,97 +144,80 @@ void HAL_SPI_AbortCpltCallback(SPI_HandleTypeDef *hspi){
 //------------------------------------------------------------------------------------
 DMA_SPI::DMA_SPI(int hz, PinName mosi, PinName miso, PinName sclk, PinName ssel) : SPI(mosi, miso, sclk, ssel){
     SPI::frequency(hz);
+    _dma_size = 0;
     _handle = &_spi.spi.handle;
+    _hdma_tx.Instance = 0;
+    _hdma_rx.Instance = 0;
+    DMA::Request tx_req, rx_req;
     if(_handle->Instance == SPI1){
         DMA::spi1 = _handle;
         spi1Dma = this;
-        // Activo clock DMA1
-        __HAL_RCC_DMA1_CLK_ENABLE();
-        /* Configure the DMA handler for Transmission process */
-        _hdma_tx.Instance                 = DMA1_Channel3;
-        _hdma_tx.Init.Request             = DMA_REQUEST_1;
-        _hdma_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
-        _hdma_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
-        _hdma_tx.Init.MemInc              = DMA_MINC_ENABLE;
-        _hdma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-        _hdma_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-        _hdma_tx.Init.Mode                = DMA_NORMAL;
-        _hdma_tx.Init.Priority            = DMA_PRIORITY_HIGH;
-
-        HAL_DMA_Init(&_hdma_tx);
-
-        /* Associate the initialized DMA handle to the the SPI handle */
-        __HAL_LINKDMA(_handle, hdmatx, _hdma_tx);
-
-        /* Configure the DMA handler for Reception process */
-        _hdma_rx.Instance                 = DMA1_Channel2;
-        _hdma_rx.Init.Request             = DMA_REQUEST_1;
-        _hdma_rx.Init.Direction           = DMA_PERIPH_TO_MEMORY;
-        _hdma_rx.Init.PeriphInc           = DMA_PINC_DISABLE;
-        _hdma_rx.Init.MemInc              = DMA_MINC_ENABLE;
-        _hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-        _hdma_rx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-        _hdma_rx.Init.Mode                = DMA_NORMAL;
-        _hdma_rx.Init.Priority            = DMA_PRIORITY_HIGH;
-
-        HAL_DMA_Init(&_hdma_rx);
-
-        /* Associate the initialized DMA handle to the the SPI handle */
-        __HAL_LINKDMA(_handle, hdmarx, _hdma_rx);
-        
-        /*##-4- Configure the NVIC for DMA #########################################*/ 
-        /* NVIC configuration for DMA transfer complete interrupt (SPI1_TX) */
-        HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 1, 1);
-        HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
-        
-        /* NVIC configuration for DMA transfer complete interrupt (SPI1_RX) */
-        HAL_NVIC_SetPriority(DMA1_Channel2_IRQn, 1, 0);
-        HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);            
+        tx_req = DMA::ReqSpi1Tx;
+        rx_req = DMA::ReqSpi1Rx;
     }
     else if(_handle->Instance == SPI3){
         DMA::spi3 = _handle;
         spi3Dma = this;
-        // Activo clock DMA2
-        __HAL_RCC_DMA2_CLK_ENABLE();
-        /* Configure the DMA handler for Transmission process */
-        _hdma_tx.Instance                 = DMA2_Channel2;
-        _hdma_tx.Init.Request             = DMA_REQUEST_3;
-        _hdma_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
-        _hdma_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
-        _hdma_tx.Init.MemInc              = DMA_MINC_ENABLE;
-        _hdma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-        _hdma_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-        _hdma_tx.Init.Mode                = DMA_NORMAL;
-        _hdma_tx.Init.Priority            = DMA_PRIORITY_HIGH;
-
-        HAL_DMA_Init(&_hdma_tx);
-
-        /* Associate the initialized DMA handle to the the SPI handle */
-        __HAL_LINKDMA(_handle, hdmatx, _hdma_tx);
-
-        /* Configure the DMA handler for Reception process */
-        _hdma_rx.Instance                 = DMA2_Channel1;
-        _hdma_rx.Init.Request             = DMA_REQUEST_3;
-        _hdma_rx.Init.Direction           = DMA_PERIPH_TO_MEMORY;
-        _hdma_rx.Init.PeriphInc           = DMA_PINC_DISABLE;
-        _hdma_rx.Init.MemInc              = DMA_MINC_ENABLE;
-        _hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-        _hdma_rx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-        _hdma_rx.Init.Mode                = DMA_NORMAL;
-        _hdma_rx.Init.Priority            = DMA_PRIORITY_HIGH;
-
-        /* Associate the initialized DMA handle to the the SPI handle */
-        __HAL_LINKDMA(_handle, hdmarx, _hdma_rx);
-        
-        /*##-4- Configure the NVIC for DMA #########################################*/ 
-        /* NVIC configuration for DMA transfer complete interrupt (SPI1_TX) */
-        HAL_NVIC_SetPriority(DMA2_Channel2_IRQn, 1, 1);
-        HAL_NVIC_EnableIRQ(DMA2_Channel2_IRQn);
-        
-        /* NVIC configuration for DMA transfer complete interrupt (SPI1_RX) */
-        HAL_NVIC_SetPriority(DMA2_Channel1_IRQn, 1, 0);
-        HAL_NVIC_EnableIRQ(DMA2_Channel1_IRQn);    
-    }      
+        tx_req = DMA::ReqSpi3Tx;
+        rx_req = DMA::ReqSpi3Rx;
+    }
+    else{
+        return;
+    }
+
+    /* Select free DMA channels for both requests and enable their clocks */
+    if(!DMA::allocate(tx_req, &_hdma_tx) || !DMA::allocate(rx_req, &_hdma_rx)){
+        error("DMA_SPI: sin canal DMA libre para las peticiones %d/%d\r\n", tx_req, rx_req);
+        return;
+    }
+
+    /* Configure the DMA handler for Transmission process */
+    _hdma_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    _hdma_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
+    _hdma_tx.Init.MemInc              = DMA_MINC_ENABLE;
+    _hdma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    _hdma_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    _hdma_tx.Init.Mode                = DMA_NORMAL;
+    _hdma_tx.Init.Priority            = DMA_PRIORITY_HIGH;
+
+    HAL_DMA_Init(&_hdma_tx);
+
+    /* Associate the initialized DMA handle to the the SPI handle */
+    __HAL_LINKDMA(_handle, hdmatx, _hdma_tx);
+
+    /* Configure the DMA handler for Reception process */
+    _hdma_rx.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    _hdma_rx.Init.PeriphInc           = DMA_PINC_DISABLE;
+    _hdma_rx.Init.MemInc              = DMA_MINC_ENABLE;
+    _hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    _hdma_rx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    _hdma_rx.Init.Mode                = DMA_NORMAL;
+    _hdma_rx.Init.Priority            = DMA_PRIORITY_HIGH;
+
+    HAL_DMA_Init(&_hdma_rx);
+
+    /* Associate the initialized DMA handle to the the SPI handle */
+    __HAL_LINKDMA(_handle, hdmarx, _hdma_rx);
+    
+    /*##-4- Configure the NVIC for DMA #########################################*/ 
+    /* NVIC configuration for DMA transfer complete interrupt (SPIx_TX) */
+    IRQn_Type irqn = DMA::getIRQn(DMA::getChannel(_hdma_tx.Instance));
+    HAL_NVIC_SetPriority(irqn, 1, 1);
+    HAL_NVIC_EnableIRQ(irqn);
+    
+    /* NVIC configuration for DMA transfer complete interrupt (SPIx_RX) */
+    irqn = DMA::getIRQn(DMA::getChannel(_hdma_rx.Instance));
+    HAL_NVIC_SetPriority(irqn, 1, 0);
+    HAL_NVIC_EnableIRQ(irqn);
+}
+
+
+//------------------------------------------------------------------------------------
+DMA_SPI::~DMA_SPI(){
+    DMA::release(&_hdma_tx);
+    DMA::release(&_hdma_rx);
+    if(spi1Dma == this){ spi1Dma = 0; DMA::spi1 = 0; }
+    if(spi3Dma == this){ spi3Dma = 0; DMA::spi3 = 0; }
 }
 
 
@@ -245,6 +228,7 @@ void DMA_SPI::transmit(uint8_t* txbuf, uint16_t bufsize, Callback<void()>& xdmaH
     dmaHalfIsrCb = xdmaHalfIsrCb;
     dmaCpltIsrCb = xdmaCpltIsrCb;
     dmaErrIsrCb = xdmaErrIsrCb;
+    _dma_size = bufsize;
     if((err = HAL_SPI_Transmit_DMA(_handle, txbuf, bufsize)) != HAL_OK){
         dmaErrIsrCb.call((ErrorResult)err);
     }
@@ -279,6 +263,30 @@ void DMA_SPI::transmitAndReceive(uint8_t* txbuf, uint8_t* rxbuf, uint16_t bufsiz
 
 
 
+//------------------------------------------------------------------------------------
+void DMA_SPI::dmaSetCircular(bool circular){
+    _hdma_tx.Init.Mode = (circular)? DMA_CIRCULAR : DMA_NORMAL;
+    HAL_DMA_Init(&_hdma_tx);
+}
+
+
+//------------------------------------------------------------------------------------
+DMA_SPI::ErrorResult DMA_SPI::dmaStop(){
+    return (ErrorResult)HAL_SPI_DMAStop(_handle);
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_SPI::dmaSetBuffer(uint8_t* buf){
+    // la dirección de memoria sólo puede cambiarse con el canal deshabilitado
+    __HAL_DMA_DISABLE(&_hdma_tx);
+    _hdma_tx.Instance->CMAR = (uint32_t)buf;
+    _hdma_tx.Instance->CNDTR = _dma_size;
+    __HAL_DMA_ENABLE(&_hdma_tx);
+}
+
+
+
 //------------------------------------------------------------------------------------
 //- PROTECTED CLASS IMPL. ------------------------------------------------------------
 //------------------------------------------------------------------------------------
@@ -4,13 +4,17 @@
  *  Created on: Oct 2017
  *      Author: raulMrello
  *
- *  DMA_SPI es un mdulo C++ que proporciona un mecanismo de transmisin/recepcin SPI utilizando los
+ *  DMA_SPI es un módulo C++ que proporciona un mecanismo de transmisión/recepción SPI utilizando los
  *  canales DMA asociados para enviar y/o recibir datos desde un buffer de memoria.
- *  Se pueden realizar operaciones de envo, de recepcin o de envo+recepcin.
- *  La notificacin de eventos se delega a callbacks dedicadas: dmaHalfIsrCb, dmaCpltIsrCb y dmaErrIsrCb que
- *  debern ser instaladas al inicio del proceso.
+ *  Se pueden realizar operaciones de envío, de recepción o de envío+recepción.
+ *  La notificación de eventos se delega a callbacks dedicadas: dmaHalfIsrCb, dmaCpltIsrCb y dmaErrIsrCb que
+ *  deberán ser instaladas al inicio del proceso.
  *
- *  NOTA: Esta librera es compatible con procesadores STM32L4xx. Nota la velocidad del bus SPI es un mltiplo
+ *  Por defecto la DMA de transmisión envía el buffer una única vez. Con dmaSetCircular(true) el buffer se retransmite
+ *  indefinidamente, notificando dmaHalfIsrCb y dmaCpltIsrCb en cada vuelta, lo que permite rellenarlo por mitades
+ *  (p.ej. el backend SPI de WS281xLedStrip).
+ *
+ *  NOTA: Esta librería es compatible con procesadores STM32L4xx. Nota la velocidad del bus SPI es un múltiplo
  *  de fpclk/br siendo br (2,4,8,...,256) y fpclk (SPI1: PCLK2 (80MHz), SPI3: PCLK1)
  */
  
@@ -56,15 +60,15 @@ class DMA_SPI : public SPI, public DMA {
 
 	
     /** @fn ~DMA_SPI()
-     *  @brief Destructor por defecto
+     *  @brief Destructor, libera los canales DMA
      */
-    virtual ~DMA_SPI(){}
+    virtual ~DMA_SPI();
 
 	
     /** @fn transmit()
-     *  @brief Enva un buffer por medio de DMA
+     *  @brief Envía un buffer por medio de DMA
      *  @param txbuf Datos de origen
-     *  @param bufsize Tamao de los datos a enviar
+     *  @param bufsize Tamaño de los datos a enviar
      *  @param dmaHalfIsrCb Callback para recibir eventos halfDma
      *  @param dmaCpltIsrCb Callback para recibir eventos CpltDma
      *  @param dmaErrIsrCb Callback para recibir eventos ErrorDma
@@ -76,7 +80,7 @@ class DMA_SPI : public SPI, public DMA {
     /** @fn receive()
      *  @brief Recibe un buffer por medio de DMA
      *  @param rxbuf Datos de destino
-     *  @param bufsize Tamao de los datos a enviar
+     *  @param bufsize Tamaño de los datos a enviar
      *  @param dmaHalfIsrCb Callback para recibir eventos halfDma
      *  @param dmaCpltIsrCb Callback para recibir eventos CpltDma
      *  @param dmaErrIsrCb Callback para recibir eventos ErrorDma
@@ -86,10 +90,10 @@ class DMA_SPI : public SPI, public DMA {
 
 	
     /** @fn transmitAndReceive()
-     *  @brief Enva y recibe un buffer por medio de DMA
+     *  @brief Envía y recibe un buffer por medio de DMA
      *  @param txbuf Datos de origen para la escritura
      *  @param rxbuf Datos de destino tras la lectura
-     *  @param bufsize Tamao de los datos a enviar
+     *  @param bufsize Tamaño de los datos a enviar
      *  @param dmaHalfIsrCb Callback para recibir eventos halfDma
      *  @param dmaCpltIsrCb Callback para recibir eventos CpltDma
      *  @param dmaErrIsrCb Callback para recibir eventos ErrorDma
@@ -98,13 +102,35 @@ class DMA_SPI : public SPI, public DMA {
                         Callback<void()>& dmaHalfIsrCb, Callback<void()>& dmaCpltIsrCb, Callback<void(ErrorResult)>& dmaErrIsrCb);
 
 	
+    /** @fn dmaSetCircular()
+     *  @brief Selecciona dma de transmisión circular o de un único envío (por defecto). Debe invocarse con la dma 
+     *         detenida
+     *  @param circular True para retransmitir el buffer indefinidamente
+     */
+    void dmaSetCircular(bool circular);
+
+	
+    /** @fn dmaStop()
+     *  @brief Detiene las transferencias dma en curso
+     */
+    ErrorResult dmaStop();
+
+	
+    /** @fn dmaSetBuffer()
+     *  @brief Reapunta la transmisión dma en curso a otro buffer del mismo tamaño, que se empieza a enviar desde su
+     *         primer byte. Está pensado para invocarse desde dmaCpltIsrCb en modo circular (contexto ISR)
+     *  @param buf Nuevo buffer de origen, con el mismo tamaño que el indicado en transmit
+     */
+    void dmaSetBuffer(uint8_t* buf);
+
+	
     /** @fn getHandler()
      *  @brief Obtiene la referencia al manejador SPI
      *  @return Manejador spi
      */
     SPI_HandleTypeDef* getHandler(){ return _handle; }
 
-    /** Callbacks de notificacin de interrupcin dma */
+    /** Callbacks de notificación de interrupción dma */
     Callback<void()> dmaHalfIsrCb;
     Callback<void()> dmaCpltIsrCb;
     Callback<void(ErrorResult)> dmaErrIsrCb;  
@@ -113,6 +139,7 @@ class DMA_SPI : public SPI, public DMA {
     SPI_HandleTypeDef* _handle;
     DMA_HandleTypeDef _hdma_tx;
     DMA_HandleTypeDef _hdma_rx;
+    uint16_t _dma_size;
   
 };    
 
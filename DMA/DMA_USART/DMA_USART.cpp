@@ -0,0 +1,291 @@
+/*
+ * DMA_USART.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ */
+
+#include "DMA_USART.h"
+
+
+
+//------------------------------------------------------------------------------------
+//- STATIC ---------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+static DMA_USART* usart1Dma;
+static DMA_USART* usart2Dma;
+static DMA_USART* usart3Dma;
+
+static void unhandled_callback(DMA_USART::RxEvent ev){}
+
+
+//------------------------------------------------------------------------------------
+/** Indica si el vector de una interrupción lo ha instalado mbed (serial_irq_set, al hacer attach) o es aún el de la
+ *  tabla de arranque en flash, cuyo manejador por defecto es un bucle infinito y no puede invocarse */
+static bool isInstalledVector(IRQn_Type irqn, uint32_t vector){
+    const uint32_t* flash_vectors = (const uint32_t*)NVIC_FLASH_VECTOR_ADDRESS;
+    return (vector != 0 && vector != flash_vectors[irqn + NVIC_USER_IRQ_OFFSET]);
+}
+
+
+//------------------------------------------------------------------------------------
+static DMA_USART* getInstance(UART_HandleTypeDef* huart){
+    if(DMA::usart1 == huart){
+        return usart1Dma;
+    }
+    if(DMA::usart2 == huart){
+        return usart2Dma;
+    }
+    if(DMA::usart3 == huart){
+        return usart3Dma;
+    }
+    return 0;
+}
+
+
+//------------------------------------------------------------------------------------
+/** Vectores de interrupción USARTx */
+static void usart1_irq(){
+    if(usart1Dma){
+        usart1Dma->isrHandler();
+    }
+}
+
+static void usart2_irq(){
+    if(usart2Dma){
+        usart2Dma->isrHandler();
+    }
+}
+
+static void usart3_irq(){
+    if(usart3Dma){
+        usart3Dma->isrHandler();
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+/** Callbacks de interrupción dma half_transfer, transfer_complete y error */
+static void dmaHalfCallback(DMA_HandleTypeDef *hdma){
+    DMA_USART* usart = getInstance((UART_HandleTypeDef*)hdma->Parent);
+    if(usart){
+        usart->dmaRxIsrCb.call(DMA_USART::RxHalf);
+    }
+}
+
+static void dmaCpltCallback(DMA_HandleTypeDef *hdma){
+    DMA_USART* usart = getInstance((UART_HandleTypeDef*)hdma->Parent);
+    if(usart){
+        usart->dmaRxIsrCb.call(DMA_USART::RxComplete);
+    }
+}
+
+static void dmaErrorCallback(DMA_HandleTypeDef *hdma){
+    DMA_USART* usart = getInstance((UART_HandleTypeDef*)hdma->Parent);
+    if(usart){
+        usart->dmaRxIsrCb.call(DMA_USART::RxError);
+    }
+}
+
+
+
+//------------------------------------------------------------------------------------
+//- PUBLIC CLASS IMPL. ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+DMA_USART::DMA_USART(PinName tx, PinName rx, int baud) : RawSerial(tx, rx, baud){
+    _rxbuf = 0;
+    _bufsize = 0;
+    _tail = 0;
+    _receiving = false;
+    _prev_vector = 0;
+    _chain = false;
+    dmaRxIsrCb = callback(unhandled_callback);
+    _handle.Instance = (USART_TypeDef*)_serial.serial.uart;
+    _hdma_rx.Instance = 0;
+    DMA::Request rx_req;
+    if(_handle.Instance == USART1){
+        DMA::usart1 = &_handle;
+        usart1Dma = this;
+        rx_req = DMA::ReqUsart1Rx;
+        _irqn = USART1_IRQn;
+        _vector = (uint32_t)&usart1_irq;
+    }
+    else if(_handle.Instance == USART2){
+        DMA::usart2 = &_handle;
+        usart2Dma = this;
+        rx_req = DMA::ReqUsart2Rx;
+        _irqn = USART2_IRQn;
+        _vector = (uint32_t)&usart2_irq;
+    }
+    else if(_handle.Instance == USART3){
+        DMA::usart3 = &_handle;
+        usart3Dma = this;
+        rx_req = DMA::ReqUsart3Rx;
+        _irqn = USART3_IRQn;
+        _vector = (uint32_t)&usart3_irq;
+    }
+    else{
+        return;
+    }
+
+    /* Select a free DMA channel for the request and enable its clock */
+    if(!DMA::allocate(rx_req, &_hdma_rx)){
+        error("DMA_USART: sin canal DMA libre para la peticion %d\r\n", rx_req);
+        return;
+    }
+
+    /* Configure the DMA handler for Reception process */
+    _hdma_rx.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    _hdma_rx.Init.PeriphInc           = DMA_PINC_DISABLE;
+    _hdma_rx.Init.MemInc              = DMA_MINC_ENABLE;
+    _hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    _hdma_rx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    _hdma_rx.Init.Mode                = DMA_CIRCULAR;
+    _hdma_rx.Init.Priority            = DMA_PRIORITY_HIGH;
+
+    HAL_DMA_Init(&_hdma_rx);
+
+    /* Associate the initialized DMA handle to the the UART handle */
+    __HAL_LINKDMA((&_handle), hdmarx, _hdma_rx);
+
+    /*##-4- Configure the NVIC for DMA #########################################*/
+    /* NVIC configuration for DMA transfer complete interrupt (USARTx_RX) */
+    IRQn_Type irqn = DMA::getIRQn(DMA::getChannel(_hdma_rx.Instance));
+    HAL_NVIC_SetPriority(irqn, 1, 0);
+    HAL_NVIC_EnableIRQ(irqn);
+}
+
+
+//------------------------------------------------------------------------------------
+DMA_USART::~DMA_USART(){
+    stopReceiver();
+    DMA::release(&_hdma_rx);
+    if(usart1Dma == this){ usart1Dma = 0; DMA::usart1 = 0; }
+    if(usart2Dma == this){ usart2Dma = 0; DMA::usart2 = 0; }
+    if(usart3Dma == this){ usart3Dma = 0; DMA::usart3 = 0; }
+}
+
+
+//------------------------------------------------------------------------------------
+DMA_USART::ErrorResult DMA_USART::startReceiver(uint8_t* rxbuf, uint16_t bufsize, Callback<void(RxEvent)>& xdmaRxIsrCb){
+    ErrorResult err;
+    if(_hdma_rx.Instance == 0 || !rxbuf || bufsize == 0){
+        return UNKNOWN_ERROR;
+    }
+    if(_receiving){
+        return BUSY_ERROR;
+    }
+    dmaRxIsrCb = xdmaRxIsrCb;
+    _rxbuf = rxbuf;
+    _bufsize = bufsize;
+    _tail = 0;
+    _hdma_rx.XferHalfCpltCallback = dmaHalfCallback;
+    _hdma_rx.XferCpltCallback = dmaCpltCallback;
+    _hdma_rx.XferErrorCallback = dmaErrorCallback;
+    if((err = (ErrorResult)HAL_DMA_Start_IT(&_hdma_rx, (uint32_t)&_handle.Instance->RDR, (uint32_t)rxbuf, bufsize)) != NO_ERRORS){
+        return err;
+    }
+    _receiving = true;
+
+    // descarta el estado previo de la línea y habilita la petición dma del receptor
+    _handle.Instance->ICR = USART_ICR_IDLECF | USART_ICR_ORECF;
+    SET_BIT(_handle.Instance->CR3, USART_CR3_DMAR);
+
+    // instala el vector propio y habilita la detección de línea inactiva. Sólo se encadena con el vector anterior si
+    // lo instaló mbed; si no, isrHandler atiende por sí mismo los flags de la USART
+    _prev_vector = NVIC_GetVector(_irqn);
+    _chain = isInstalledVector(_irqn, _prev_vector);
+    NVIC_SetVector(_irqn, _vector);
+    SET_BIT(_handle.Instance->CR1, USART_CR1_IDLEIE);
+    HAL_NVIC_EnableIRQ(_irqn);
+    return NO_ERRORS;
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_USART::stopReceiver(){
+    if(!_receiving){
+        return;
+    }
+    CLEAR_BIT(_handle.Instance->CR1, USART_CR1_IDLEIE);
+    CLEAR_BIT(_handle.Instance->CR3, USART_CR3_DMAR);
+    HAL_DMA_Abort(&_hdma_rx);
+    NVIC_SetVector(_irqn, _prev_vector);
+    _chain = false;
+    _receiving = false;
+}
+
+
+//------------------------------------------------------------------------------------
+uint16_t DMA_USART::available(){
+    if(!_receiving){
+        return 0;
+    }
+    uint16_t head = getHead();
+    return (head >= _tail)? (head - _tail) : (_bufsize - _tail + head);
+}
+
+
+//------------------------------------------------------------------------------------
+uint16_t DMA_USART::read(uint8_t* buf, uint16_t maxsize){
+    if(!_receiving){
+        return 0;
+    }
+    uint16_t head = getHead();
+    uint16_t tail = _tail;
+    uint16_t count = 0;
+    // tramo hasta el final del buffer si la DMA ha dado la vuelta
+    if(head < tail){
+        uint16_t n = _bufsize - tail;
+        n = (n > maxsize)? maxsize : n;
+        memcpy(buf, &_rxbuf[tail], n);
+        count += n;
+        tail += n;
+        if(tail >= _bufsize){
+            tail = 0;
+        }
+    }
+    // tramo contiguo hasta la posición de escritura
+    if(tail < head && count < maxsize){
+        uint16_t n = head - tail;
+        n = (n > (maxsize - count))? (maxsize - count) : n;
+        memcpy(&buf[count], &_rxbuf[tail], n);
+        count += n;
+        tail += n;
+    }
+    _tail = tail;
+    return count;
+}
+
+
+//------------------------------------------------------------------------------------
+void DMA_USART::isrHandler(){
+    if((_handle.Instance->ISR & USART_ISR_IDLE) != 0 && (_handle.Instance->CR1 & USART_CR1_IDLEIE) != 0){
+        _handle.Instance->ICR = USART_ICR_IDLECF;
+        dmaRxIsrCb.call(RxIdle);
+    }
+    // el resto de eventos (tx, errores) los atiende el manejador de mbed, si lo hay. En caso contrario se descartan
+    // los flags de error para que la interrupción no quede pendiente
+    if(_chain){
+        ((void(*)())_prev_vector)();
+        return;
+    }
+    _handle.Instance->ICR = USART_ICR_ORECF | USART_ICR_NCF | USART_ICR_FECF | USART_ICR_PECF;
+}
+
+
+
+//------------------------------------------------------------------------------------
+//- PROTECTED CLASS IMPL. ------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+uint16_t DMA_USART::getHead(){
+    uint16_t head = _bufsize - (uint16_t)__HAL_DMA_GET_COUNTER(&_hdma_rx);
+    return (head >= _bufsize)? 0 : head;
+}
@@ -0,0 +1,147 @@
+/*
+ * DMA_USART.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  DMA_USART es un módulo C++ que proporciona recepción serie por DMA sobre un buffer circular, de forma que la
+ *  carga de interrupciones pasa de una por byte (RawSerial::attach(RxIrq)) a unas pocas por trama:
+ *
+ *  - RxHalf: la DMA ha escrito la primera mitad del buffer
+ *  - RxComplete: la DMA ha escrito la segunda mitad y vuelve al inicio
+ *  - RxIdle: la línea rx ha quedado inactiva durante un carácter tras recibir datos (fin de trama)
+ *  - RxError: error de transferencia dma
+ *
+ *  Los eventos se notifican mediante dmaRxIsrCb (contexto ISR) y los datos pendientes se extraen con read(), que
+ *  puede invocarse desde la propia callback o desde un hilo. El buffer debe dimensionarse para que el lector consuma
+ *  los datos antes de que la DMA dé una vuelta completa; en caso contrario se pierden datos sin notificación.
+ *
+ *  La transmisión sigue siendo la de RawSerial (putc, printf, attach(TxIrq)). La interrupción USARTx se comparte con
+ *  mbed: startReceiver instala un vector propio que atiende la detección de línea inactiva y después invoca al que
+ *  hubiera instalado mbed, por lo que attach(TxIrq) debe realizarse antes de startReceiver. Si no se ha hecho ningún
+ *  attach, el vector anterior es el manejador por defecto de la tabla de arranque y no se invoca: el vector propio
+ *  descarta entonces los flags de error de la USART.
+ *
+ *  Los canales DMA se asignan mediante DMA::allocate (USART1_RX: DMA1_Channel5 o DMA2_Channel7, USART2_RX:
+ *  DMA1_Channel6, USART3_RX: DMA1_Channel3).
+ *
+ *  NOTA: Esta librería es compatible con procesadores STM32L4xx (USART1, USART2 y USART3).
+ */
+
+
+#ifndef DMA_USART_H
+#define DMA_USART_H
+
+
+#include "mbed.h"
+#include "DMA.h"
+
+
+
+//------------------------------------------------------------------------------------
+//- CLASS DMA_USART ------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+class DMA_USART : public RawSerial, public DMA {
+  public:
+
+    enum ErrorResult{
+        NO_ERRORS = HAL_OK,
+        UNKNOWN_ERROR = HAL_ERROR,
+        BUSY_ERROR = HAL_BUSY,
+        TIMEOUT_ERROR = HAL_TIMEOUT,
+    };
+
+    /** Eventos de recepción */
+    enum RxEvent{
+        RxHalf,
+        RxComplete,
+        RxIdle,
+        RxError,
+    };
+
+    /** @fn DMA_USART()
+     *  @brief Constructor, que asocia un manejador USART (USART_x)
+     *  @param tx Línea de transmisión
+     *  @param rx Línea de recepción
+     *  @param baud Velocidad del puerto serie
+     */
+    DMA_USART(PinName tx, PinName rx, int baud = MBED_CONF_PLATFORM_DEFAULT_SERIAL_BAUD_RATE);
+
+
+    /** @fn ~DMA_USART()
+     *  @brief Destructor, detiene el receptor y libera el canal DMA
+     */
+    virtual ~DMA_USART();
+
+
+    /** @fn startReceiver()
+     *  @brief Inicia la recepción dma circular sobre un buffer
+     *  @param rxbuf Buffer circular de recepción, que debe permanecer válido hasta stopReceiver
+     *  @param bufsize Tamaño del buffer
+     *  @param dmaRxIsrCb Callback para recibir los eventos de recepción
+     *  @return Código de error
+     */
+    ErrorResult startReceiver(uint8_t* rxbuf, uint16_t bufsize, Callback<void(RxEvent)>& dmaRxIsrCb);
+
+
+    /** @fn stopReceiver()
+     *  @brief Detiene la recepción dma y restaura el vector de interrupción de mbed
+     */
+    void stopReceiver();
+
+
+    /** @fn available()
+     *  @brief Obtiene el número de bytes recibidos pendientes de leer
+     *  @return Número de bytes
+     */
+    uint16_t available();
+
+
+    /** @fn read()
+     *  @brief Copia los bytes recibidos pendientes de leer
+     *  @param buf Buffer de destino
+     *  @param maxsize Tamaño del buffer de destino
+     *  @return Número de bytes copiados
+     */
+    uint16_t read(uint8_t* buf, uint16_t maxsize);
+
+
+    /** @fn isrHandler()
+     *  @brief Manejador de la interrupción USARTx (contexto ISR, uso interno)
+     */
+    void isrHandler();
+
+
+    /** @fn getHandler()
+     *  @brief Obtiene la referencia al manejador UART (sólo Instance y los enlaces dma son válidos)
+     *  @return Manejador uart
+     */
+    UART_HandleTypeDef* getHandler(){ return &_handle; }
+
+    /** Callback de notificación de eventos de recepción */
+    Callback<void(RxEvent)> dmaRxIsrCb;
+
+  protected:
+    UART_HandleTypeDef _handle;
+    DMA_HandleTypeDef _hdma_rx;
+    IRQn_Type _irqn;
+    uint32_t _vector;
+    uint32_t _prev_vector;
+    bool _chain;                    /// El vector anterior lo instaló mbed y se invoca desde isrHandler
+    uint8_t* _rxbuf;
+    uint16_t _bufsize;
+    volatile uint16_t _tail;
+    bool _receiving;
+
+
+    /** @fn getHead()
+     *  @brief Obtiene la posición de escritura de la DMA en el buffer
+     */
+    uint16_t getHead();
+};
+
+
+
+#endif   /* DMA_USART_H */
@@ -208,7 +208,7 @@ bool HCSR04::filtData(int16_t dist){
     _filter.dist_cm[_filter.curr]= dist;
     
     
-    // comprueba si todas las medidas estn en rango para generar una medida concreta
+    // comprueba si todas las medidas están en rango para generar una medida concreta
     int16_t dist_max = 0, dist_min = MaxDetectableRange;
     for(uint8_t i=0; i<_filter.count; i++){
         dist_min = (dist_min <= _filter.dist_cm[i])? dist_min : _filter.dist_cm[i];
@@ -9,7 +9,7 @@
 // **************************************************************************
 
 
-/** Macro de impresin de trazas de depuracin */
+/** Macro de impresión de trazas de depuración */
 #define DEBUG_TRACE(format, ...)    if(logger){logger->printf(format, ##__VA_ARGS__);}
 
 
@@ -17,7 +17,7 @@
 // *********** OBJETOS  *****************************************************
 // **************************************************************************
 
-/** Canal de comunicacin remota */
+/** Canal de comunicación remota */
 static Logger* logger;
 
 /** Driver control detector */
@@ -51,19 +51,19 @@ void test_HCSR04(){
     th = Thread::gettid();
             
     // --------------------------------------
-    // Inicia el canal de comunicacin remota
+    // Inicia el canal de comunicación remota
     logger = new Logger(USBTX, USBRX, 16, 115200);    
     DEBUG_TRACE("\r\nIniciando test_PCA9685...\r\n");
 
 
     // --------------------------------------
     // Creo driver de control para los servos
-    //  - Direccin I2C = 0h
-    //  - Nmero de servos controlables = 12 (0 al 11)    
+    //  - Dirección I2C = 0h
+    //  - Número de servos controlables = 12 (0 al 11)    
     DEBUG_TRACE("\r\nCreando Driver HCSR04...");    
     distdrv = new HCSR04(PA_0, PA_1);
         
-    // situo todos a 0 y doy la orden sincronizada
+    // situo todos a 0º y doy la orden sincronizada
     DEBUG_TRACE("\r\nAjustando distancias a 10cm... ");
     distdrv->config(10, 10, 3);
     
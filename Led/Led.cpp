@@ -119,7 +119,7 @@ void Led::off(uint32_t ms_duration, uint8_t intensity, uint32_t ms_ramp){
 
 //------------------------------------------------------------------------------------
 void Led::blink(uint32_t ms_blink_on, uint32_t ms_blink_off, uint32_t ms_duration, uint8_t intensity_on, uint8_t intensity_off){
-    // si no hay temporizaciones de On y Off, no permite la ejecucin
+    // si no hay temporizaciones de On y Off, no permite la ejecución
     if(ms_blink_on == 0 && ms_blink_off == 0){
         return;
     }
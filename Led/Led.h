@@ -4,8 +4,8 @@
  *  Created on: Sep 2017
  *      Author: raulMrello
  *
- *	Led es el mdulo encargado de gestionar la activacin y apagado de un LED. Es posible generar patrones de parpadeo a diferentes
- *  velocidades, con diferente nivel de intensidad, con encendidos y apagados instantneos o en rampa.
+ *	Led es el módulo encargado de gestionar la activación y apagado de un LED. Es posible generar patrones de parpadeo a diferentes
+ *  velocidades, con diferente nivel de intensidad, con encendidos y apagados instantáneos o en rampa.
  *
  */
  
@@ -18,13 +18,13 @@
 class Led{
   public:
 
-    /** Configuracin para establecer el tipo de led */
+    /** Configuración para establecer el tipo de led */
     enum LedType{
         LedOnOffType,
         LedDimmableType,
     };
   
-    /** Configuracin para establecer la lgica de activacin */
+    /** Configuración para establecer la lógica de activación */
 	enum LedLogicLevel{
 		OnIsLowLevel,
 		OnIsHighLevel
@@ -33,7 +33,7 @@ class Led{
 	/** Constructor
      *  @param led GPIO conectado al led
      *  @param type Tipo de led (DigitalOut o PwmOut)
-     *  @param level Nivel de activacin lgico 
+     *  @param level Nivel de activación lógico 
      *  @param period Periodo del del pwm en milisegundos
      */
     Led(PinName led, LedType type, LedLogicLevel level = OnIsHighLevel, uint32_t period_ms = 1);
@@ -42,30 +42,30 @@ class Led{
   
 	/** on
      *  Inicia el encendido del led, a un nivel de intensidad, con o sin rampa incial y opcionalmente
-     *  con una duracin mxima. Por defecto enciende el led instantneamente
+     *  con una duración máxima. Por defecto enciende el led instantáneamente
      *  @param intensity Intensidad en porcentaje 0-100%
-	 *	@param ms_duration Tiempo de duracin, hasta volver al estado anterior
-	 *	@param ms_ramp Tiempo hasta alcanzar la intensidad (0: instantnea, !=0: millisegundos)
+	 *	@param ms_duration Tiempo de duración, hasta volver al estado anterior
+	 *	@param ms_ramp Tiempo hasta alcanzar la intensidad (0: instantánea, !=0: millisegundos)
 	 */
     void on(uint32_t ms_duration = 0, uint8_t intensity=100, uint32_t ms_ramp = 0);
 
 
     /** off
      *  Inicia el apagado del led, a un nivel de intensidad, con o sin rampa incial y opcionalmente
-     *  con una duracin mxima. Por defecto deja el led apagado instantneamente.
-     *	@param ms_duration Tiempo de duracin, hasta volver al estado anterior
+     *  con una duración máxima. Por defecto deja el led apagado instantáneamente.
+     *	@param ms_duration Tiempo de duración, hasta volver al estado anterior
 	 *  @param intensity Intensidad en porcentaje 0-100%
-	 *	@param ms_ramp Tiempo hasta alcanzar la intensidad (0: instantnea, !=0: millisegundos)
+	 *	@param ms_ramp Tiempo hasta alcanzar la intensidad (0: instantánea, !=0: millisegundos)
 	 */
     void off(uint32_t ms_duration = 0, uint8_t intensity=0, uint32_t ms_ramp = 0);
 
 
     /** blink
-     *  Inicia el parpadeo del led, con intensidades mxima y mnima y opcionalmente
-     *  con una duracin mxima. Por defecto el led parpadea de 0 a 1.
+     *  Inicia el parpadeo del led, con intensidades máxima y mínima y opcionalmente
+     *  con una duración máxima. Por defecto el led parpadea de 0 a 1.
      *	@param ms_blink_on Tiempo de encendido en ms
 	 *	@param ms_blink_off Tiempo de apagado en ms
-	 *	@param ms_duration Tiempo de duracin, hasta volver al estado anterior
+	 *	@param ms_duration Tiempo de duración, hasta volver al estado anterior
 	 *  @param intensity_on Intensidad de encendido en porcentaje 0-100%
 	 *  @param intensity_off Intensidad de apagado en porcentaje 0-100%
 	 */
@@ -81,7 +81,7 @@ class Led{
   
   
 	/** setDebugChannel()
-     *  Instala canal de depuracin
+     *  Instala canal de depuración
      *  @param dbg Logger
      */
     void setDebugChannel(bool dbg) { _debug = dbg; }
@@ -105,23 +105,23 @@ class Led{
     PwmOut* _out;                                           /// Salida pwm
     DigitalOut* _out_01;                                    /// Salida binaria 0 1
     float _intensity;                                       /// Nivel de intensidad    
-    float _max_intensity;                                   /// Mximo nivel de intensidad
-    float _min_intensity;                                   /// Mnimo nivel de intensidad
+    float _max_intensity;                                   /// Máximo nivel de intensidad
+    float _min_intensity;                                   /// Mínimo nivel de intensidad
     LedType _type;                                          /// Tipo de led
-    LedLogicLevel _level;                                   /// Nivel lgico para la activacin
+    LedLogicLevel _level;                                   /// Nivel lógico para la activación
     LedStat _stat;                                          /// Estado del led
-    LedAction _action;                                      /// Accin en ejecucin del led
+    LedAction _action;                                      /// Acción en ejecución del led
     uint32_t _period_ms;                                    /// Periodo del pwm en milisegundos
     Ticker _tick_ramp;                                      /// Timer para la rampa
     Ticker _tick_blink;                                     /// Timer para el parpadeo
-    Ticker _tick_duration;                                  /// Timer para la duracin
+    Ticker _tick_duration;                                  /// Timer para la duración
     uint32_t _ms_ramp;                                      /// Milisegundos de rampa
     uint32_t _ms_blink_on;                                  /// Milisegundos de encendido (parpadeo)
     uint32_t _ms_blink_off;                                 /// Miliegundos de apagado (parpadeo)
     uint32_t _ms_duration;                                  /// Milisegundos del estado temporal
     LedStat _bkp_stat;                                      /// Estado backup en modo temporal
-    bool _istemp;                                           /// Flag para indicar si el modo temporal est activo
-    bool  _debug;                                           /// Canal de depuracin
+    bool _istemp;                                           /// Flag para indicar si el modo temporal está activo
+    bool  _debug;                                           /// Canal de depuración
   
     
 	/** rampOffCb
@@ -143,13 +143,13 @@ class Led{
   
     
 	/** temporalCb
-     *  Callback para ejecutar la accin temporal
+     *  Callback para ejecutar la acción temporal
      */
     void temporalCb();
   
     
 	/** convertIntensity
-     *  Convierte la intensidad 0-100% en un valor de 0-1 teniendo en cuenta la lgica
+     *  Convierte la intensidad 0-100% en un valor de 0-1 teniendo en cuenta la lógica
      *  @param intensity Intensidad 0-100%
      *  @return Intensidad 0 - 1.0f
      */
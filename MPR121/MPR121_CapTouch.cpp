@@ -66,10 +66,10 @@ __packed struct Command{        /// Estructura de lectura/escritura por registro
 static void defaultCb(){}
 static const Command cmd_power_up[] = {
     {'W', MPR121_SOFTRESET, 0x63},      /// Reset por software
-    {'R', MPR121_ECR, 0},               /// Desactivacin de electrodos
+    {'R', MPR121_ECR, 0},               /// Desactivación de electrodos
     {'R', MPR121_CONFIG2, 0x00/*0x24*/},        /// Lectura del filtro 2nd 
-    {'T', 0, 0},                        /// Ajuste de thresholds para eventos de pulsacin-release
-    {'W', MPR121_MHDR, 0x01},           /// Ajuste de parmetros de filtrado
+    {'T', 0, 0},                        /// Ajuste de thresholds para eventos de pulsación-release
+    {'W', MPR121_MHDR, 0x01},           /// Ajuste de parámetros de filtrado
     {'W', MPR121_NHDR, 0x01},
     {'W', MPR121_NCLR, 0x0E},
     {'W', MPR121_FDLR, 0},
@@ -101,7 +101,7 @@ MPR121_CapTouch::MPR121_CapTouch(PinName sda, PinName scl, PinName irq, uint16_t
     _iin_irq->rise(callback(defaultCb));
     _iin_irq->fall(callback(defaultCb));
     _addr = ((addr << 1)& 0xfe);
-    _elec_mask = (elec_mask & 0x0fff); // slo permiten 12 electrodos (NO UTILIZA EL DE PROXIMIDAD)
+    _elec_mask = (elec_mask & 0x0fff); // sólo permiten 12 electrodos (NO UTILIZA EL DE PROXIMIDAD)
     _stat = NotPresent;
     // ajusta thresholds por defecto
     _touch_thr = DefaultTouchThreshold;
@@ -121,12 +121,12 @@ MPR121_CapTouch::MPR121_CapTouch(PinName sda, PinName scl, PinName irq, uint16_t
         return;
     }
     
-    // inicializa estado para el caso de que falle la inicializacin
+    // inicializa estado para el caso de que falle la inicialización
     _stat = PresentWithErrors;
     // espera 1ms a estabilizar tras reset software
     wait_us(1000);
     
-    // inicia volcado de parmetros por defecto
+    // inicia volcado de parámetros por defecto
     while(cmd_power_up[id].op != 0){
         // proceso escritura de registros...
         if(cmd_power_up[id].op == 'W'){
@@ -143,7 +143,7 @@ MPR121_CapTouch::MPR121_CapTouch(PinName sda, PinName scl, PinName irq, uint16_t
             if(_i2c->read(_addr, &val, 1) != 0){
                 return;
             }         
-            // si es la configuracin del filtro, chequea que el valor ledo coincide con el de por defecto
+            // si es la configuración del filtro, chequea que el valor leído coincide con el de por defecto
             if(cmd_power_up[id].reg == MPR121_CONFIG2 && val != cmd_power_up[id].value){
                 return;
             }            
@@ -4,15 +4,15 @@
  *  Created on: Oct 2017
  *      Author: raulMrello
  *
- *	MPR121_CapTouch es el driver del chip MPR121 que mediante un bus I2C proporciona el acceso a 12 canales tctiles
- *  capacitivos. Adems el chip proporciona un pin de salida IRQ para notificar eventos, activo en el flanco de bajada,
- *  as como un pin para seleccin de direccin, que puede dejarse sin conectar para utilizar la direccin por defecto 5Ah.
+ *	MPR121_CapTouch es el driver del chip MPR121 que mediante un bus I2C proporciona el acceso a 12 canales táctiles
+ *  capacitivos. Además el chip proporciona un pin de salida IRQ para notificar eventos, activo en el flanco de bajada,
+ *  así como un pin para selección de dirección, que puede dejarse sin conectar para utilizar la dirección por defecto 5Ah.
  *
- *  El uso tpico ser: Crear objeto, ajustar parmetros, instalar callback, invocar a touched() fuera de contexto ISR para 
+ *  El uso típico será: Crear objeto, ajustar parámetros, instalar callback, invocar a touched() fuera de contexto ISR para 
  *  leer estado de los pads.
  *
- *  Adems para trazar el estado anterior de los pads y saber si ha sido pulsado, si sigue pulsado o si acaba de ser liberado
- *  es necesario de un manager de ms alto nivel (ver clase TouchManager)
+ *  Además para trazar el estado anterior de los pads y saber si ha sido pulsado, si sigue pulsado o si acaba de ser liberado
+ *  es necesario de un manager de más alto nivel (ver clase TouchManager)
  *
  *
  *  void onIrq(){ thread.signal_set(1); }
@@ -35,9 +35,9 @@
 
 class MPR121_CapTouch {
  public:
-    /** Direccin por defecto (ADDR sin conectar) */
+    /** Dirección por defecto (ADDR sin conectar) */
     static const uint8_t DefaultAddress = 0x5A;
-    static const uint8_t SensorCount = 12;              /// Nmero de sensores capacitivos
+    static const uint8_t SensorCount = 12;              /// Número de sensores capacitivos
     
  
     /** Estado del dispositivo */
@@ -60,29 +60,29 @@ class MPR121_CapTouch {
     
 
     /** Constructor por defecto
-     * @param sda Lnea sda del bus i2c
-     * @param scl Lnea scl del bus i2c
-     * @param irq Entrada de interrupcin
-     * @param elec_mask Mscara de bits indicando qu electrodos quedarn activos.
-     * @param addr Direccin i2c, por defecto (5Ah)
+     * @param sda Línea sda del bus i2c
+     * @param scl Línea scl del bus i2c
+     * @param irq Entrada de interrupción
+     * @param elec_mask Máscara de bits indicando qué electrodos quedarán activos.
+     * @param addr Dirección i2c, por defecto (5Ah)
      */
     MPR121_CapTouch(PinName sda, PinName scl, PinName irq, uint16_t elec_mask, uint8_t addr = DefaultAddress);
     
 
     /** Obtiene el estado del driver
-     * @return Estado de ejecucin
+     * @return Estado de ejecución
      */
     Status getState(){ return _stat; }    
 
-    /** Instala callback para la notificacin de eventos hardware
+    /** Instala callback para la notificación de eventos hardware
      * @param irq_cb Callback a instalar en eventos pin IRQ
      */
     void attachIrqCb(Callback<void()> irq_cb);
 
-    /** Ajusta los thresholds para la generacin de eventos
-     * @param touch_th Threshold de pulsacin en num. cuentas
-     * @param release_th Threshold de liberacin en num. cuentas
-     * @return Cdigo de error
+    /** Ajusta los thresholds para la generación de eventos
+     * @param touch_th Threshold de pulsación en num. cuentas
+     * @param release_th Threshold de liberación en num. cuentas
+     * @return Código de error
      */
     ErrorResult setThresholds(uint8_t touch_th, uint8_t release_th);
     
@@ -101,45 +101,45 @@ class MPR121_CapTouch {
     uint16_t getBaselineData(uint8_t elec);
     
 
-    /** Obtiene el estado de pulsacin de los electrodos, obtiene
+    /** Obtiene el estado de pulsación de los electrodos, obtiene
      *  el bit activo de los electrodos pulsados bit0 = elec0, bit11 = elec11
-     * @return Estado de pulsacin
+     * @return Estado de pulsación
      */
     uint16_t touched();
 
   
   protected:
-    static const uint8_t DefaultTouchThreshold = 12;    /// threshold en num. cuentas para deteccin pulsacin
-    static const uint8_t DefaultReleaseThreshold = 6;   /// threshold en num. cuentas para deteccin liberacin
+    static const uint8_t DefaultTouchThreshold = 12;    /// threshold en num. cuentas para detección pulsación
+    static const uint8_t DefaultReleaseThreshold = 6;   /// threshold en num. cuentas para detección liberación
   
     I2C* _i2c;                      /// Puerto i2c 
-    InterruptIn* _iin_irq;          /// Entrada de interrupcin
-    uint8_t _addr;                  /// Direccin i2c asignada
+    InterruptIn* _iin_irq;          /// Entrada de interrupción
+    uint8_t _addr;                  /// Dirección i2c asignada
     int8_t _i2caddr;
-    Status _stat;                   /// Estado de ejecucin
-    uint8_t _touch_thr;             /// Threshold actual de pulsacin
-    uint8_t _release_thr;           /// Threshold actual de liberacin   
-    uint16_t _elec_mask;            /// Mscara de bits de los electrodos activos
+    Status _stat;                   /// Estado de ejecución
+    uint8_t _touch_thr;             /// Threshold actual de pulsación
+    uint8_t _release_thr;           /// Threshold actual de liberación   
+    uint16_t _elec_mask;            /// Máscara de bits de los electrodos activos
     Callback<void()> _irq_cb;       /// Callback a invocar tras evento irq
       
 
-    /** Procesa una interrupcin a nivel bajo en el pin irq
+    /** Procesa una interrupción a nivel bajo en el pin irq
      */
     void onIrqFallingEdge();
      
 
     /** Lee un registro de 8 bits
      *  @param reg Registro a leer
-     *  @param value Recibe el valor ledo
-     *  @return Cdigo de error
+     *  @param value Recibe el valor leído
+     *  @return Código de error
      */
     ErrorResult readRegister8(const char reg, uint8_t* value);
    
 
     /** Lee un registro de 16 bits
      *  @param reg Registro a leer
-     *  @param value Recibe el valor ledo
-     *  @return Cdigo de error
+     *  @param value Recibe el valor leído
+     *  @return Código de error
      */
     ErrorResult readRegister16(const char reg, uint16_t* value);
    
@@ -147,7 +147,7 @@ class MPR121_CapTouch {
     /** Escribe un registro de 8 bits
      *  @param reg Registro a escribir
      *  @param value Valor a escribir
-     *  @return Cdigo de error
+     *  @return Código de error
      */
     ErrorResult writeRegister(const char reg, char value);
   
@@ -9,7 +9,7 @@
 // **************************************************************************
 
 
-/** Macro de impresin de trazas de depuracin */
+/** Macro de impresión de trazas de depuración */
 #define DEBUG_TRACE(format, ...)    if(logger){logger->printf(format, ##__VA_ARGS__);}
 
 
@@ -18,7 +18,7 @@
 // **************************************************************************
 
 
-/** Canal de depuracin */
+/** Canal de depuración */
 static Logger* logger;
 /** Driver control detector */
 static MPR121_CapTouch* touchdrv;
@@ -45,15 +45,15 @@ void test_MPR121(){
     th = Thread::gettid();
             
     // --------------------------------------
-    // Inicia el canal de comunicacin remota
+    // Inicia el canal de comunicación remota
     logger = new Logger(USBTX, USBRX, 16, 115200);
     DEBUG_TRACE("\r\nIniciando test_MPR121...\r\n");
 
 
     // --------------------------------------
     // Creo driver de control para los canales touch 0 y 1
-    //  - Direccin I2C = 5Ah
-    //  - Nmero de canales controlables = 2 (0, 1)    
+    //  - Dirección I2C = 5Ah
+    //  - Número de canales controlables = 2 (0, 1)    
     DEBUG_TRACE("\r\nCreando Driver MPR121...");    
     touchdrv = new MPR121_CapTouch(PB_7, PB_6, PB_1, 0x03);
     MPR121_CapTouch::Status stat = touchdrv->getState();
@@ -4,8 +4,8 @@
  *  Created on: Nov 2017
  *      Author: raulMrello
  *
- *  NVFlash es el mdulo C++ que proporciona acceso a zonas de memoria FLASH para almacenar datos no voltiles
- *  como configuraciones, parmetros de calibracin, etc...
+ *  NVFlash es el módulo C++ que proporciona acceso a zonas de memoria FLASH para almacenar datos no volátiles
+ *  como configuraciones, parámetros de calibración, etc...
  *  Por regla general, son zonas de memoria situadas al final de la flash de programa
  * 
  */
@@ -27,7 +27,7 @@ class NVFlash {
 
 public:
         
-    /** Lista de erores devueltos por el mdulo */
+    /** Lista de erores devueltos por el módulo */
     enum ErrorResult{
         Success,
         Locked,
@@ -40,42 +40,42 @@ public:
     
     /** init()
      *  Inicializa reservando una zona de la flash
-     *  @param base_addr Pginas a reservar
-     *  @param size Tamao de pgina.
-     *  @return Cdigo de error
+     *  @param base_addr Páginas a reservar
+     *  @param size Tamaño de página.
+     *  @return Código de error
      */
     static ErrorResult init(uint32_t base_addr = 0x0803F800, uint32_t size = 2048);
     
     
     /** getPageSize()
-     *  Obtiene el tamao de una pgina
-     *  @return Tamao de pgina
+     *  Obtiene el tamaño de una página
+     *  @return Tamaño de página
      */
     static uint32_t getPageSize() { return _page_size; }
 
 
     /** readPage()
-     *  Lee una pgina
-     *  @param page Pgina a leer
-     *  @param dest Recibe los datos ledos
-     *  @param size Tamao a leer.
-     *  @return Cdigo de error
+     *  Lee una página
+     *  @param page Página a leer
+     *  @param dest Recibe los datos leídos
+     *  @param size Tamaño a leer.
+     *  @return Código de error
      */
     static ErrorResult readPage(uint8_t page, uint32_t* dest, uint32_t size = 2048);
 
 
     /** writePage()
-     *  Escribe datos a una posicin de memoria
-     *  @param page Pgina a programar
+     *  Escribe datos a una posición de memoria
+     *  @param page Página a programar
      *  @param data Datos a escribir
-     *  @return Cdigo de error
+     *  @return Código de error
      */
     static ErrorResult writePage(uint8_t page, uint32_t* data);
 
 
     /** erasePage()
-     *  Borra una pgina
-     *  @param page Pgina a borrar
+     *  Borra una página
+     *  @param page Página a borrar
      */
     static ErrorResult erasePage(uint8_t page);
 
@@ -83,9 +83,9 @@ public:
 protected:
 
     static FlashIAP _flash;         /// Controlador de memoria
-    static uint32_t _start_addr;    /// Direccin de origen
-    static uint8_t _num_pages;      /// Nmero de pginas reservadas
-    static uint32_t _page_size;     /// Tamao de la pgina
+    static uint32_t _start_addr;    /// Dirección de origen
+    static uint8_t _num_pages;      /// Número de páginas reservadas
+    static uint32_t _page_size;     /// Tamaño de la página
 
 };
 
@@ -125,7 +125,7 @@
 /* PWM Frequency macro calculator */
 #define PCA9685_PWM_FREQ(oscMhz,updRate)    ((oscMhz)/(4096*(updRate)))
 
-/** Trama de configuracin inicial */
+/** Trama de configuración inicial */
 static const uint8_t INIT_CONFIG[]  = {PCA9685_MODE1, PCA9685_MODE1_AI, PCA9685_MODE2_OUTDRV};
 
 /** Trama de bajo consumo */
@@ -141,7 +141,7 @@ static uint8_t CHANGE_FREQ[]        = {PCA9685_PRE_SCALE, 0};
 
 
 //------------------------------------------------------------------------------------
-PCA9685_ServoDrv::PCA9685_ServoDrv(PinName sda, PinName scl, uint8_t numServos, uint8_t addr, uint32_t period_us, PinName oe, uint32_t hz){
+PCA9685_ServoDrv::PCA9685_ServoDrv(PinName sda, PinName scl, uint8_t numServos, uint8_t addr, uint32_t period_us, PinName oe, uint32_t hz, bool use_dma){
     uint8_t i;
     _addr = addr|PCA9685_FIXED_ADDRESS;
     _hz = hz;
@@ -149,8 +149,17 @@ PCA9685_ServoDrv::PCA9685_ServoDrv(PinName sda, PinName scl, uint8_t numServos,
     _freq = 1000000/period_us;
     _num_servos = numServos;
     
-    _i2c = new I2C(sda, scl);
-    _i2c->frequency(1000000);
+    // el bus dma es opcional: reserva dos canales DMA y el constructor de DMA_I2C se detiene si no hay libres
+    _dma = NULL;
+    if(use_dma){
+        _dma = new DMA_I2C(sda, scl, 1000000);
+        _i2c = _dma;
+    }
+    else{
+        _i2c = new I2C(sda, scl);
+    }
+    _dmaCpltCb = callback(this, &PCA9685_ServoDrv::onUpdateDone);
+    _dmaErrCb = callback(this, &PCA9685_ServoDrv::onUpdateError);
     _oe = NULL;
     if(oe != NC){
         _oe = new DigitalOut(oe, 1);
@@ -162,13 +171,13 @@ PCA9685_ServoDrv::PCA9685_ServoDrv(PinName sda, PinName scl, uint8_t numServos,
         _dutyValue[i] = 0;
     }
     
-    // chequea si el dispositivo est presente
+    // chequea si el dispositivo está presente
     if (_i2c->write(_addr, NULL, 0) != 0){
         _stat = NotPresent;
         return;
     }
     
-    // establece configuracin por defecto para el driver:
+    // establece configuración por defecto para el driver:
     //  * Auto-incremento activado
     //  * Modo normal y salida invertida (no requiere driver auxiliar)
     if(_i2c->write(_addr, (const char*)INIT_CONFIG, sizeof(INIT_CONFIG)) != 0){
@@ -232,6 +241,9 @@ PCA9685_ServoDrv::ErrorResult PCA9685_ServoDrv::setServoAngle(uint8_t servoId, u
     uint16_t duty = getDutyFromAngle(servoId, angle);
     
     if(update){
+        if(isBusy()){
+            return WriteError;
+        }
         uint8_t buffer[5];
         buffer[0] = PCA9685_SERVO0_ON_L+(servoId*4);
         buffer[1] = 0; //ON_L always 0
@@ -262,6 +274,9 @@ PCA9685_ServoDrv::ErrorResult PCA9685_ServoDrv::setServoDuty(uint8_t servoId, ui
         return InvalidArguments;
     
     if(update){
+        if(isBusy()){
+            return WriteError;
+        }
         uint8_t buffer[5];
         buffer[0] = PCA9685_SERVO0_ON_L+(servoId*4);
         buffer[1] = 0; //ON_L always 0
@@ -311,26 +326,11 @@ uint16_t PCA9685_ServoDrv::getServoDuty(uint8_t servoId){
 
 //------------------------------------------------------------------------------------
 PCA9685_ServoDrv::ErrorResult PCA9685_ServoDrv::updateAll(){
-    uint8_t i,j;
     uint8_t buffer[1+(ServoCount*4)];
-
-    // setup buffer address
-    j=0;
-    buffer[j++] = PCA9685_SERVO0_ON_L;
-    // setup servo values
-    for(i=0;i<_num_servos;i++){
-        buffer[j++] = 0; //ON_L always 0
-        buffer[j++] = 0; //ON_H always 0
-        buffer[j++] = (uint8_t)(_dutyValue[i] & 0x00ff);
-        buffer[j++] = (uint8_t)((_dutyValue[i] >> 8) & 0x00ff);
-    }
-    // reset unused servos
-    for(i=_num_servos;i<ServoCount;i++){
-        buffer[j++] = 0;
-        buffer[j++] = 0;
-        buffer[j++] = 0;
-        buffer[j++] = 0;
+    if(isBusy()){
+        return WriteError;
     }
+    uint8_t j = buildFrame(buffer);
     // write buffer and check errors
     if(_i2c->write(_addr, (const char*)buffer, j) != 0)
         return WriteError;
@@ -342,10 +342,30 @@ PCA9685_ServoDrv::ErrorResult PCA9685_ServoDrv::updateAll(){
 }
 
 
+//------------------------------------------------------------------------------------
+PCA9685_ServoDrv::ErrorResult PCA9685_ServoDrv::updateAllAsync(Callback<void(ErrorResult)> doneCb){
+    if(isBusy()){
+        return WriteError;
+    }
+    // sin bus dma el envío es bloqueante y el resultado se notifica antes de retornar
+    if(!_dma){
+        doneCb.call(updateAll());
+        return Success;
+    }
+    _doneCb = doneCb;
+    uint8_t j = buildFrame(_frame);
+    _dma->transmit(_addr, _frame, j, _dmaCpltCb, _dmaErrCb);
+    return Success;
+}
+
+
 //------------------------------------------------------------------------------------
 PCA9685_ServoDrv::ErrorResult PCA9685_ServoDrv::readServoDuty(uint8_t servoId, uint16_t* duty){
     char addr = PCA9685_SERVO0_ON_L+(servoId*4);
     char buffer[4];
+    if(isBusy()){
+        return ReadError;
+    }
 	
     // set read pointer at position 0
     if(_i2c->write(_addr, &addr, 1) != 0){
@@ -422,6 +442,9 @@ PCA9685_ServoDrv::ErrorResult PCA9685_ServoDrv::getAllDuty(){
     char addr = PCA9685_SERVO0_ON_L;
     char buffer[96];
 	uint8_t i;
+    if(isBusy()){
+        return ReadError;
+    }
 
     // set read pointer at position 0
     if(_i2c->write(_addr, &addr, 1) != 0){
@@ -447,6 +470,9 @@ PCA9685_ServoDrv::ErrorResult PCA9685_ServoDrv::getDriverContent(void){
     char addr = 0;
     char buffer[96];
     buffer[0] = 0;
+    if(isBusy()){
+        return ReadError;
+    }
     // set read pointer at position 0
     if(_i2c->write(_addr, &addr, 1) != SUCCESS)
         return WriteError;
@@ -461,3 +487,42 @@ PCA9685_ServoDrv::ErrorResult PCA9685_ServoDrv::getDriverContent(void){
     return Success;
 }
 
+
+//------------------------------------------------------------------------------------
+uint8_t PCA9685_ServoDrv::buildFrame(uint8_t* buffer){
+    uint8_t i,j;
+    // setup buffer address
+    j=0;
+    buffer[j++] = PCA9685_SERVO0_ON_L;
+    // setup servo values
+    for(i=0;i<_num_servos;i++){
+        buffer[j++] = 0; //ON_L always 0
+        buffer[j++] = 0; //ON_H always 0
+        buffer[j++] = (uint8_t)(_dutyValue[i] & 0x00ff);
+        buffer[j++] = (uint8_t)((_dutyValue[i] >> 8) & 0x00ff);
+    }
+    // reset unused servos
+    for(i=_num_servos;i<ServoCount;i++){
+        buffer[j++] = 0;
+        buffer[j++] = 0;
+        buffer[j++] = 0;
+        buffer[j++] = 0;
+    }
+    return j;
+}
+
+
+//------------------------------------------------------------------------------------
+void PCA9685_ServoDrv::onUpdateDone(){
+    // Habilita las salidas pwm
+    if(_oe){
+        _oe->write(0);
+    }
+    _doneCb.call(Success);
+}
+
+
+//------------------------------------------------------------------------------------
+void PCA9685_ServoDrv::onUpdateError(DMA_I2C::ErrorResult err){
+    _doneCb.call((err == DMA_I2C::NACK_ERROR)? DeviceUndetected : WriteError);
+}
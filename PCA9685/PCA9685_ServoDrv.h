@@ -5,8 +5,13 @@
  *      Author: raulMrello
  *
  *	PCA9685 es el driver del chip PCS9685 que mediante un bus I2C proporciona el acceso a 16 canales PWM de 12bit.
- *  Permite frecuencias pwm desde 24Hz hasta 1526Hz. Para el control de servos, la frecuencia tpica suele ser de
- *  50Hz (20ms) y los pulsos pwm suelen ir de 1ms (ngulo de 0) a 2ms (ngulo de 180).
+ *  Permite frecuencias pwm desde 24Hz hasta 1526Hz. Para el control de servos, la frecuencia típica suele ser de
+ *  50Hz (20ms) y los pulsos pwm suelen ir de 1ms (ángulo de 0º) a 2ms (ángulo de 180º).
+ *
+ *  Opcionalmente (use_dma), el bus i2c se gestiona mediante DMA_I2C, por lo que además de los servicios bloqueantes,
+ *  updateAllAsync envía la trama completa de los 16 canales (65 bytes, ~650us a 1MHz) por DMA sin bloquear el hilo
+ *  llamante. El bus dma reserva dos canales DMA. Mientras dura el envío, los servicios que acceden al bus devuelven
+ *  WriteError o ReadError (ver isBusy).
  *  
  */
  
@@ -15,6 +20,7 @@
 #define _PCA9685_H_
  
 #include "mbed.h"
+#include "DMA_I2C.h"
 
 
 //------------------------------------------------------------------------------------
@@ -27,9 +33,9 @@ class PCA9685_ServoDrv{
     
     
     /** Configuraciones fijas */
-    static const uint8_t ServoCount = 16;       // Nmero de servos controlables
-    static const uint8_t MaxAngleValue = 180;   /// ngulo mximo de giro del servo
-    static const uint8_t MinAngleValue = 0;     /// ngulo mnimo de giro del servo
+    static const uint8_t ServoCount = 16;       // Número de servos controlables
+    static const uint8_t MaxAngleValue = 180;   /// Ángulo máximo de giro del servo
+    static const uint8_t MinAngleValue = 0;     /// Ángulo mínimo de giro del servo
     
     
     /** Estado del dispositivo */
@@ -52,15 +58,16 @@ class PCA9685_ServoDrv{
     
 
     /** Constructor por defecto
-     * @parm sda Lnea sda del bus i2c
-     * @parm scl Lnea scl del bus i2c
-     * @param numServos Nmero de servos controlados
-     * @param addr Direccin i2c, por defecto = 0 (80h + 0)
-     * @param pwm_period_us Periodo de la seal pwm en us
-     * @param oe Lnea /oe (opcional) para habilitar la salida pwm (por defecto NC sin uso)
+     * @parm sda Línea sda del bus i2c
+     * @parm scl Línea scl del bus i2c
+     * @param numServos Número de servos controlados
+     * @param addr Dirección i2c, por defecto = 0 (80h + 0)
+     * @param pwm_period_us Periodo de la señal pwm en us
+     * @param oe Línea /oe (opcional) para habilitar la salida pwm (por defecto NC sin uso)
      * @param hz Oscilador del chip i2c
+     * @param use_dma True para gestionar el bus mediante DMA_I2C a 1MHz (updateAllAsync no bloqueante)
      */
-    PCA9685_ServoDrv(PinName sda, PinName scl, uint8_t numServos = ServoCount, uint8_t addr=0, uint32_t pwm_period_us=20000, PinName oe=NC, uint32_t hz=25000000);
+    PCA9685_ServoDrv(PinName sda, PinName scl, uint8_t numServos = ServoCount, uint8_t addr=0, uint32_t pwm_period_us=20000, PinName oe=NC, uint32_t hz=25000000, bool use_dma=false);
 
     
     /** Destructor
@@ -74,12 +81,18 @@ class PCA9685_ServoDrv{
     Status getState() { return _stat; }
     
     
-    /** Establece los rangos mnimo y mximo del pulso pwm en us para un canal pwm. No pueden exceder el valor
-     *  mximo configurado en _period_us
+    /** Indica si hay un envío dma de updateAllAsync en curso, durante el cual no se puede acceder al bus
+     *  @return True si está en curso
+     */
+    bool isBusy() { return (_dma && _dma->isBusy()); }
+    
+    
+    /** Establece los rangos mínimo y máximo del pulso pwm en us para un canal pwm. No pueden exceder el valor
+     *  máximo configurado en _period_us
      * @param servoId Servo id (0 to 15)
-     * @param min_angle Mnimo ngulo
-     * @param max_angle Maximo ngulo
-     * @param min_duty Mnimo duty
+     * @param min_angle Mínimo ángulo
+     * @param max_angle Maximo ángulo
+     * @param min_duty Mínimo duty
      * @param max_duty Maximo duty
      * @return error code 
      */
@@ -87,11 +100,11 @@ class PCA9685_ServoDrv{
     
     
     
-    /** Establece un ngulo para un servo concreto y opcionalmente actualiza el chip para que tome valor
-     *  de forma instantnea
+    /** Establece un ángulo para un servo concreto y opcionalmente actualiza el chip para que tome valor
+     *  de forma instantánea
      * @param servoId Servo id (0 to 15)
      * @param angle Angulo entre 0 y 180
-     * @param update True (escribe en chip), False (slo actualiza variable)
+     * @param update True (escribe en chip), False (sólo actualiza variable)
      * @return error code 
      */
     ErrorResult setServoAngle(uint8_t servoId, uint8_t angle, bool update=false);
@@ -100,26 +113,26 @@ class PCA9685_ServoDrv{
     /** Establece el pulso de un canal pwm
      * @param servoId Servo id (0 to 15)
      * @param duty  Duty value (0 to 4096) 
-     * @param update True (escribe en chip), False (slo actualiza variable)
+     * @param update True (escribe en chip), False (sólo actualiza variable)
      * @return error code 
      */
     ErrorResult setServoDuty(uint8_t servoId, uint16_t duty, bool update=false);    
     
     
-    /** Lee los rangos mnimo y mximo del pulso pwm en us para un canal pwm
+    /** Lee los rangos mínimo y máximo del pulso pwm en us para un canal pwm
      * @param servoId Servo id (0 to 15)
-     * @param min_angle Mnimo ngulo
-     * @param max_angle Maximo ngulo
-     * @param min_duty Mnimo duty
+     * @param min_angle Mínimo ángulo
+     * @param max_angle Maximo ángulo
+     * @param min_duty Mínimo duty
      * @param max_duty Maximo duty
      * @return error code 
      */
     ErrorResult getServoRanges(uint8_t servoId, int16_t* min_angle, int16_t* max_angle, uint16_t* min_duty, uint16_t* max_duty);
     
     
-    /** Obtiene el ngulo para un servo concreto
+    /** Obtiene el ángulo para un servo concreto
      * @param servoId Servo id (0 to 15)
-     * @return angle Obtiene el ngulo entre 0 y 180
+     * @return angle Obtiene el Ángulo entre 0 y 180
      */
     uint8_t getServoAngle(uint8_t servoId);
 
@@ -131,61 +144,72 @@ class PCA9685_ServoDrv{
     uint16_t getServoDuty(uint8_t servoId);
     
     
-    /** Enva los pulsos en _dutyValue al chip i2c
-     * @return Cdigo de error
+    /** Envía los pulsos en _dutyValue al chip i2c
+     * @return Código de error
      */    
     ErrorResult updateAll();  
     
     
+    /** Envía los pulsos en _dutyValue al chip i2c por DMA, sin bloquear. La trama se copia en un buffer interno, 
+     *  por lo que _dutyValue puede modificarse durante el envío. Sin use_dma, el envío es el de updateAll y doneCb
+     *  se invoca antes de retornar
+     * @param doneCb Callback invocada al finalizar (contexto ISR) con Success, WriteError o DeviceUndetected (el
+     *        chip no responde)
+     * @return Success si se solicita el envío (un fallo al iniciarlo también se notifica por doneCb), WriteError si
+     *         hay otro en curso
+     */    
+    ErrorResult updateAllAsync(Callback<void(ErrorResult)> doneCb);  
+    
+    
     /** Lee del chip i2c, el valor real del duty correspondiente a un servo
      *  @param servoId Servo 
-     *  @param duty Recibe el valor del duty ledo
-     *  @return Cdigo de error
+     *  @param duty Recibe el valor del duty leído
+     *  @return Código de error
      */    
     ErrorResult readServoDuty(uint8_t servoId, uint16_t* duty);
 
 
-    /** Obtiene el duty equivalente a un ngulo de giro dado para un servo en concreto
+    /** Obtiene el duty equivalente a un ángulo de giro dado para un servo en concreto
      * @param servoId Identificador del servo
-     * @param angle ngulo en grados
+     * @param angle Ángulo en grados
      * @return Recibe el valor del pulso (0...4096)
      */
     uint16_t getDutyFromAngle(uint8_t servoId, uint8_t angle);    
 
 
-    /** Obtiene el ngulo equivalente a un duty para un servo dado, cuyos rangos han sido ajustados
+    /** Obtiene el ángulo equivalente a un duty para un servo dado, cuyos rangos han sido ajustados
      * @param servoId Identificador del servo
-     * @param duty Duty en nmero de cuentas
-     * @return Recibe el valor del ngulo (0..180)
+     * @param duty Duty en número de cuentas
+     * @return Recibe el valor del ángulo (0..180)
      */
     uint16_t getAngleFromDuty(uint8_t servoId, uint16_t duty); 
     
   
 	/** getNVDataSize()
-     *  Obtiene el tamao de los datos NV
+     *  Obtiene el tamaño de los datos NV
      */
     uint32_t getNVDataSize(){ return(sizeof(NVData_t)); }
     
   
 	/** setNVData()
      *  Actualiza los datos NVData
-     *  @param data Datos de recuperacin
-     *  @return 0 si es correcto, !=0 si los datos son incorrectos o invlidos
+     *  @param data Datos de recuperación
+     *  @return 0 si es correcto, !=0 si los datos son incorrectos o inválidos
      */
     int setNVData(void* data);
     
   
 	/** getNVData()
      *  Lee los datos NVData
-     *  @param data Recibe los datos NV de recuperacin
+     *  @param data Recibe los datos NV de recuperación
      */
     void getNVData(uint32_t* data); 
     
     
   protected:
-    static const uint16_t MaxAllowedDuty = 4095;    /// Valor mximo del duty
+    static const uint16_t MaxAllowedDuty = 4095;    /// Valor máximo del duty
         
-    /** Estructura de datos con los parmetros de calibracin */    
+    /** Estructura de datos con los parámetros de calibración */    
     struct NVData_t{
         int16_t minAngle[ServoCount];
         int16_t maxAngle[ServoCount];
@@ -200,19 +224,24 @@ class PCA9685_ServoDrv{
     uint16_t    _minDuty[ServoCount];          /// Duty inferior por servo
     uint16_t    _maxDuty[ServoCount];          /// Duty superior por servo
     uint16_t    _dutyValue[ServoCount];         /// Duty actual por servo
-    uint16_t    _angleValue[ServoCount];        /// ngulo actual por servo
-    uint8_t     _addr;                          /// Direccin driver I2C
+    uint16_t    _angleValue[ServoCount];        /// Ángulo actual por servo
+    uint8_t     _addr;                          /// Dirección driver I2C
     uint32_t    _hz;                            /// Frecuencia clock chip PCA
     uint32_t    _period_us;                     /// Periodo pwm
     uint32_t    _freq;                          /// Frecuencia
     I2C*        _i2c;                           /// Driver i2c
+    DMA_I2C*    _dma;                           /// Driver i2c con dma (el mismo que _i2c) o NULL
     DigitalOut* _oe;                            /// Salida /OE para el chip PCA
     Status       _stat;                         /// Estado de funcionamiento
-    uint8_t     _num_servos;                    /// Nmero de servos  
+    uint8_t     _num_servos;                    /// Número de servos  
+    uint8_t     _frame[1+(ServoCount*4)];       /// Trama de updateAllAsync
+    Callback<void(ErrorResult)> _doneCb;        /// Callback de fin de updateAllAsync
+    Callback<void()> _dmaCpltCb;                /// Callbacks de DMA_I2C
+    Callback<void(DMA_I2C::ErrorResult)> _dmaErrCb;
   
   
     /** Obtiene el valor de los duty en el chip y los copia a la variable _dutyValue
-     * @return Cdigo de error
+     * @return Código de error
      */    
     ErrorResult getAllDuty();    
 
@@ -221,6 +250,18 @@ class PCA9685_ServoDrv{
      * @returns error code <= 0
      */
     ErrorResult getDriverContent(void);    
+
+
+    /** Construye la trama de actualización de todos los canales
+     * @param buffer Buffer de destino (1+(ServoCount*4) bytes)
+     * @return Tamaño de la trama
+     */
+    uint8_t buildFrame(uint8_t* buffer);
+
+
+    /** Callbacks de fin y error del envío dma de updateAllAsync (contexto ISR) */
+    void onUpdateDone();
+    void onUpdateError(DMA_I2C::ErrorResult err);
     
 };
 
@@ -10,7 +10,7 @@
 // **************************************************************************
 
 
-/** Macro de impresin de trazas de depuracin */
+/** Macro de impresión de trazas de depuración */
 #define DEBUG_TRACE(format, ...)    if(logger){logger->printf(format, ##__VA_ARGS__);}
 
 
@@ -18,16 +18,16 @@
 // *********** OBJETOS  *****************************************************
 // **************************************************************************
 
-/** Canal de comunicacin remota */
+/** Canal de comunicación remota */
 static MQSerialBridge* qserial;
 static Logger* logger;
 
 /** Driver control de servos */
 static PCA9685_ServoDrv* servodrv;
-/** Callbacks de publicacin-suscripcin */
+/** Callbacks de publicación-suscripción */
 static MQ::PublishCallback _pc;
 static MQ::SubscribeCallback _sc;
-/** Nmero de servos mximo */
+/** Número de servos máximo */
 static const uint8_t SERVO_COUNT = 12;
 /** Control de servos habilitados */
 bool enabled[SERVO_COUNT];
@@ -71,7 +71,7 @@ static void subscCb(const char* topic, void* msg, uint16_t msg_len){
         if(num == 1 || num == 2){
             memcpy(id, &topic[5], num);
             id[num] = 0;
-            DEBUG_TRACE("\r\nGirando servo %s a %s...", id, (char*)msg);        
+            DEBUG_TRACE("\r\nGirando servo %s a %sº...", id, (char*)msg);        
             if(servodrv->setServoAngle(atoi(id), atoi((char*)msg), true) != PCA9685_ServoDrv::Success){
                 DEBUG_TRACE("ERROR!!");
                 return;
@@ -85,7 +85,7 @@ static void subscCb(const char* topic, void* msg, uint16_t msg_len){
     }
     
     if(strstr(topic, "/mov/cmd")!=0){
-        DEBUG_TRACE("\r\nTBD Iniciando trayecto por defecto 180 en 1s");   
+        DEBUG_TRACE("\r\nTBD Iniciando trayecto por defecto 180º en 1s");   
         uint8_t duty_servo = 0;
         uint16_t duty_from = servodrv->getDutyFromAngle(duty_servo, 0);
         uint16_t duty_to = servodrv->getDutyFromAngle(duty_servo, 180);
@@ -114,7 +114,7 @@ static void subscCb(const char* topic, void* msg, uint16_t msg_len){
             memcpy(id, &topic[5], num);
             id[num] = 0;
             uint8_t deg = servodrv->getServoAngle(atoi(id));
-            DEBUG_TRACE("\r\nServo %s girado a %d", id, deg);        
+            DEBUG_TRACE("\r\nServo %s girado a %dº", id, deg);        
         }
         else{
             DEBUG_TRACE("\r\nError en el topic %s", topic);        
@@ -131,7 +131,7 @@ static void subscCb(const char* topic, void* msg, uint16_t msg_len){
             }
         }
         if(!any){
-            DEBUG_TRACE("\r\nNingn Servo activado.",);
+            DEBUG_TRACE("\r\nNingún Servo activado.",);
         }
         return;
     }
@@ -144,7 +144,7 @@ static void subscCb(const char* topic, void* msg, uint16_t msg_len){
 void test_PCA9685(){
             
     // --------------------------------------
-    // Inicia el canal de comunicacin remota
+    // Inicia el canal de comunicación remota
     //  - Pines USBTX, USBRX a 115200bps y 256 bytes para buffers
     //  - Configurado por defecto en modo texto
     qserial = new MQSerialBridge(USBTX, USBRX, 115200, 256);
@@ -163,13 +163,13 @@ void test_PCA9685(){
 
     // --------------------------------------
     // Creo driver de control para los servos
-    //  - Direccin I2C = 0h
-    //  - Nmero de servos controlables = 12 (0 al 11)    
+    //  - Dirección I2C = 0h
+    //  - Número de servos controlables = 12 (0 al 11)    
     DEBUG_TRACE("\r\nCreando Driver PCA9685...");    
     servodrv = new PCA9685_ServoDrv(PB_7, PB_6, SERVO_COUNT, 0);
     
-    // espero a que est listo
-    DEBUG_TRACE("\r\nListo?... ");
+    // espero a que esté listo
+    DEBUG_TRACE("\r\n¿Listo?... ");
     do{
         Thread::yield();
     }while(servodrv->getState() != PCA9685_ServoDrv::Ready);
@@ -185,8 +185,8 @@ void test_PCA9685(){
     }
     DEBUG_TRACE("OK");
     
-    // situo todos a 0 y doy la orden sincronizada
-    DEBUG_TRACE("\r\nGirando servos a 0... ");
+    // situo todos a 0º y doy la orden sincronizada
+    DEBUG_TRACE("\r\nGirando servos a 0º... ");
     for(uint8_t i=0;i<SERVO_COUNT;i++){
         if(servodrv->setServoAngle(i, 0) != PCA9685_ServoDrv::Success){
             DEBUG_TRACE("ERR_servo_%d\r\n...", i);
@@ -205,9 +205,9 @@ void test_PCA9685(){
     DEBUG_TRACE("\r\n- Activar topic-bridge: mqserialbridge/suscr TOPIC");    
     DEBUG_TRACE("\r\n- Activar servoX:       test/servo_enable/cmd X");    
     DEBUG_TRACE("\r\n- Ver servos activos:   test/servo_enable/sta 0");        
-    DEBUG_TRACE("\r\n- Mover servoX D:      servoX/deg/cmd D");    
+    DEBUG_TRACE("\r\n- Mover servoX Dº:      servoX/deg/cmd D");    
     DEBUG_TRACE("\r\n- Trayecto servoX:      servoX/mov/cmd Di,Df,Tus");    
-    DEBUG_TRACE("\r\n- Ver ngulo de servoX: servoX/deg/sta 0");    
+    DEBUG_TRACE("\r\n- Ver ángulo de servoX: servoX/deg/sta 0");    
     
 }
 
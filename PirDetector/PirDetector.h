@@ -36,7 +36,7 @@
  * @author raulMrello
  * @see API 
  *
- * <b>PirDetector</b> Clase que notifica eventos de deteccin en un sensor PIR de proximidad.
+ * <b>PirDetector</b> Clase que notifica eventos de detección en un sensor PIR de proximidad.
  */
 class PirDetector {
 public:
@@ -46,28 +46,28 @@ public:
      * Constructor.
      * Configura los gpio necesarios para controlar el registro de desplazamiento
      * @param gpio_pir Entrada del sensor PIR
-     * @param activeHigh Nivel lgico de la deteccin True=nivel_alto 
+     * @param activeHigh Nivel lógico de la detección True=nivel_alto 
      * @param logger Objeto logger
      */
 	PirDetector(PinName gpio_pir, bool activeHigh, Logger* logger);
 
     /** enable()
      *
-     * Habilita o deshabilita  la notificacin de enventos
-     * @param flag Flag para activar o desactivar la notificacin
+     * Habilita o deshabilita  la notificación de enventos
+     * @param flag Flag para activar o desactivar la notificación
      */
 	void enable(bool flag, Callback<void()> cb=0);
 
     /** getValue()
      *
-     * Lee el estado de deteccin
-     * @return Valor de deteccin 0 o 1.
+     * Lee el estado de detección
+     * @return Valor de detección 0 o 1.
      */
 	int getValue(){ return _iin->read();}
 	
     /** isrHandler()
      *
-     * Manejador propio de las interrupciones de deteccin
+     * Manejador propio de las interrupciones de detección
      */
 	void isrHandler();		
 protected:
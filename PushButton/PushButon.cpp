@@ -12,8 +12,8 @@
 //------------------------------------------------------------------------------------
 //--- PRIVATE TYPES ------------------------------------------------------------------
 //------------------------------------------------------------------------------------
-/** Macro para imprimir trazas de depuracin, siempre que se haya configurado un objeto
- *	Logger vlido (ej: _debug)
+/** Macro para imprimir trazas de depuración, siempre que se haya configurado un objeto
+ *	Logger válido (ej: _debug)
  */
 
 #define DEBUG_TRACE(format, ...)			\
@@ -42,13 +42,13 @@ PushButton::PushButton(PinName btn, uint32_t id, LogicLevel level, PinMode mode,
     _level = level;
     _id = id;
     
-    // Desactiva las callbacks de notificacin
+    // Desactiva las callbacks de notificación
     DEBUG_TRACE("\r\n[PushBtn]....... Desactivando callbacks");
     _pressCb = callback(&nullCallback);
     _holdCb = callback(&nullCallback);
     _releaseCb = callback(&nullCallback);
 
-    // Asocia manejadores de interrupcin
+    // Asocia manejadores de interrupción
     DEBUG_TRACE("\r\n[PushBtn]....... Deteniendo ticker");
     _tick_filt = new RtosTimer(callback(this, &PushButton::isrFilterCallback), osTimerOnce, "BtnTmrFilt");
     _tick_hold = new RtosTimer(callback(this, &PushButton::isrTickCallback), osTimerPeriodic, "BtnTmrHold");
@@ -184,7 +184,7 @@ void PushButton::isrFilterCallback(){
         return;
     }
 
-    // No debera llegar a este punto nunca, pero por si acaso, reasigna isr's
+    // No debería llegar a este punto nunca, pero por si acaso, reasigna isr's
     DEBUG_TRACE("\r\n[PushBtn]....... ERR_LEVEL");
     _tick_hold->stop();
 //    _tick.detach();
@@ -4,11 +4,11 @@
  *  Created on: Sep 2017
  *      Author: raulMrello
  *
- *	PushButton es el mdulo encargado de gestionar los eventos generados por un pulsador asociado a un GPIO de entrada
- *  Podr generar eventos de pulsacin "Press", de mantenimiento "Hold" y de liberacin "Release", para los que proporcionar
+ *	PushButton es el módulo encargado de gestionar los eventos generados por un pulsador asociado a un GPIO de entrada
+ *  Podrá generar eventos de pulsación "Press", de mantenimiento "Hold" y de liberación "Release", para los que proporcionará
  *  una callback.
- *  Puesto que es un mdulo que responde a eventos hardware, no tendr asociado un hilo de ejecucin de propio y deber ser
- *  el mdulo controlador, el que se encargue de procesar las callbacks asociadas a los eventos de pulsacin.
+ *  Puesto que es un módulo que responde a eventos hardware, no tendrá asociado un hilo de ejecución de propio y deberá ser
+ *  el módulo controlador, el que se encargue de procesar las callbacks asociadas a los eventos de pulsación.
  */
  
 #ifndef __PushButton__H
@@ -31,7 +31,7 @@ class PushButton {
   
   
 	/** enablePressEvents
-     *  Instala callback para procesar los eventos de pulsacin
+     *  Instala callback para procesar los eventos de pulsación
      *  @param pressCb Callback a instalar
      */
     void enablePressEvents(Callback<void(uint32_t)>pressCb);
@@ -40,20 +40,20 @@ class PushButton {
 	/** enableHoldEvents
      *  Instala callback para procesar los eventos de mantenimiento
      *  @param holdCb Callback a instalar
-     *  @param millis Milisegundos tras los que se genera el evento peridico
+     *  @param millis Milisegundos tras los que se genera el evento periódico
      */
     void enableHoldEvents(Callback<void(uint32_t)>holdCb, uint32_t millis);
   
     
 	/** enableReleaseEvents
-     *  Instala callback para procesar los eventos de liberacin
+     *  Instala callback para procesar los eventos de liberación
      *  @param releaseCb Callback a instalar
      */
     void enableReleaseEvents(Callback<void(uint32_t)>releaseCb);
   
   
 	/** disablePressEvents
-     *  Desinstala callback para procesar los eventos de pulsacin
+     *  Desinstala callback para procesar los eventos de pulsación
      */
     void disablePressEvents();
   
@@ -63,7 +63,7 @@ class PushButton {
     void disableHoldEvents();
   
 	/** disableReleaseEvents
-     *  Desinstala callback para procesar los eventos de liberacin
+     *  Desinstala callback para procesar los eventos de liberación
      */
     void disableReleaseEvents();
          
@@ -71,18 +71,18 @@ class PushButton {
 
     static const uint32_t GlitchFilterTimeoutUs = 20000;    /// Por defecto 20ms de timeout antiglitch desde el cambio de nivel
     InterruptIn* _iin;						/// InterruptIn asociada
-    LogicLevel _level;                      /// Nivel lgico
-    Callback<void(uint32_t)> _pressCb;      /// Callback para notificar eventos de pulsacin
+    LogicLevel _level;                      /// Nivel lógico
+    Callback<void(uint32_t)> _pressCb;      /// Callback para notificar eventos de pulsación
     Callback<void(uint32_t)> _holdCb;       /// Callback para notificar eventos de mantenimiento
-    Callback<void(uint32_t)> _releaseCb;    /// Callback para notificar eventos de liberacin
-    Ticker _tick;                           /// Timer para la notificacin de eventos de mantenimiento
+    Callback<void(uint32_t)> _releaseCb;    /// Callback para notificar eventos de liberación
+    Ticker _tick;                           /// Timer para la notificación de eventos de mantenimiento
     RtosTimer* _tick_filt;
     RtosTimer* _tick_hold;
 	bool _enable_ticker;                    /// Habilita funcionamiento del ticker
     uint32_t _hold_us;                      /// Microsegundos entre eventos hold
     uint32_t _id;                           /// Identificador del pulsador
-    bool _defdbg;							/// Flag para activar las trazas de depuracin por defecto
-    uint8_t _curr_value;					/// Valor recien ledo del InterruptIn
+    bool _defdbg;							/// Flag para activar las trazas de depuración por defecto
+    uint8_t _curr_value;					/// Valor recien leído del InterruptIn
 
 	/** isrRiseCallback
      *  ISR para procesar eventos de cambio de nivel
@@ -95,17 +95,17 @@ class PushButton {
     void isrFallCallback();
   
 	/** isrFilterCallback
-     *  ISR para procesar eventos de temporizacin tras filtrado de glitches en cambios de nivel
+     *  ISR para procesar eventos de temporización tras filtrado de glitches en cambios de nivel
      */
     void isrFilterCallback();
   
 	/** tickCallback
-     *  ISR para procesar eventos de temporizacin
+     *  ISR para procesar eventos de temporización
      */
     void isrTickCallback();
 
 	/** enableRiseFallCallbacks
-     *  Ajsuta las callbacks en funcin del nivel lgico actual
+     *  Ajsuta las callbacks en función del nivel lógico actual
      */
     void enableRiseFallCallbacks();
   
@@ -4,11 +4,11 @@
  *  Created on: Sep 2017
  *      Author: raulMrello
  *
- *	Relay es el mdulo encargado de gestionar la activacin y apagado de un Rel. Es posible generar patrones de encendido
- *  en caso de que se pueda controlar con dos lneas distintas. De forma que active a mxima potencia durante un tiempo
- *  y posteriormente desactive una de las lneas para mantener una corriente de mantenimiento inferior.
- *  En el constructor, se puede configurar el funcionamiento del mdulo para no tener que hacer nada ms al encender o apagar
- *  el rel
+ *	Relay es el módulo encargado de gestionar la activación y apagado de un Relé. Es posible generar patrones de encendido
+ *  en caso de que se pueda controlar con dos líneas distintas. De forma que active a máxima potencia durante un tiempo
+ *  y posteriormente desactive una de las líneas para mantener una corriente de mantenimiento inferior.
+ *  En el constructor, se puede configurar el funcionamiento del módulo para no tener que hacer nada más al encender o apagar
+ *  el relé
  *
  */
  
@@ -20,30 +20,30 @@
    
 class Relay{
   public:
-    /** Tiempo en ms por defecto, que durar la activacin a mxima corriente antes de bajar a corriente de mantenimiento */
+    /** Tiempo en ms por defecto, que durará la activación a máxima corriente antes de bajar a corriente de mantenimiento */
     static const uint32_t DefaultMaxCurrentTime = 100;
         
-    /** Configuracin del nivel lgico de activacin del rel */
+    /** Configuración del nivel lógico de activación del relé */
 	enum RelayLogicLevel{
-		OnIsLowLevel,       /// El rel se activa con una salida a nivel bajo
-		OnIsHighLevel       /// El rel se activa con una salida a nivel alto
+		OnIsLowLevel,       /// El relé se activa con una salida a nivel bajo
+		OnIsHighLevel       /// El relé se activa con una salida a nivel alto
 	};
     
-    /** Tipo de estado en el que se puede encontrar un rel */
+    /** Tipo de estado en el que se puede encontrar un relé */
     enum RelayStat{
         RelayIsOff,         /// Desactivado 
         RelayIsOn,          /// Activado        
     };
         
 	/** Constructor
-     *  Durante la construccin del objeto, se asignan los pines de control (1 o 2), la lgica de activacin, y
+     *  Durante la construcción del objeto, se asignan los pines de control (1 o 2), la lógica de activación, y
      *  el tiempo que debe proporcionarse la corriente de pico antes de bajar a la corriente de mantenimiento, en 
-     *  el caso de utilizar una configuracin de doble nivel.
-     *  @param id Identificador del rel
-     *  @param gpio_high GPIO conectado al canal de mxima corriente
+     *  el caso de utilizar una configuración de doble nivel.
+     *  @param id Identificador del relé
+     *  @param gpio_high GPIO conectado al canal de máxima corriente
      *  @param gpio_low GPIO conectado al canal de corriente de mantenimiento. Si no se utiliza dejar valor
      *          NC por defecto (NC=not connected)
-     *  @param level Nivel de activacin lgico 
+     *  @param level Nivel de activación lógico 
      *  @param time_lowcurr_us Tiempo para bajar a doble nivel en us
      */
     Relay(uint32_t id, PinName gpio_high, PinName gpio_low = NC, RelayLogicLevel level = OnIsHighLevel, uint32_t time_lowcurr_us = (1000 * DefaultMaxCurrentTime));
@@ -51,51 +51,51 @@ class Relay{
   
   
 	/** turnOnHigh
-     *  Inicia el encendido del rel a mxima potencia. Instala callback para notificar cuando debe pasar a doble nivel
-     *  @param turnLowCb Callback a notificar cuando deba bajar a doble nivel, indicando el _id del rel.
+     *  Inicia el encendido del relé a máxima potencia. Instala callback para notificar cuando debe pasar a doble nivel
+     *  @param turnLowCb Callback a notificar cuando deba bajar a doble nivel, indicando el _id del relé.
      */
     void turnOnHigh(Callback<void(uint32_t)> *turnLowCb = NULL);
   
     
 	/** turnOnLow
-     *  Mantiene el rel activado con corriente de mantenimiento
+     *  Mantiene el relé activado con corriente de mantenimiento
      */
     void turnOnLow();
   
   
 	/** turnOff
-     *  Apaga el rel
+     *  Apaga el relé
      */
     void turnOff();
   
   
 	/** getState
-     *  Obtiene el estado actual del rel
+     *  Obtiene el estado actual del relé
      *  @return RelayStat
      */
     RelayStat getState(){ return _stat; }   
   
   
 	/** getId
-     *  Obtiene el identificador del rel
+     *  Obtiene el identificador del relé
      *  @return Identificador
      */
     uint32_t getId(){ return _id; }       
              
   private:
 
-    uint32_t _id;               /// Identificador del rel
+    uint32_t _id;               /// Identificador del relé
     uint32_t _delay_lowcurr_us; /// Retado para el doble nivel en us
     DigitalOut* _out_high;      /// Salida de alta corriente
     DigitalOut* _out_low;       /// Salida de corriente de mantenimiento
-    RelayLogicLevel _level;     /// Nivel de activacin lgico
-    RelayStat _stat;            /// Estado de ejecucin (Off, On)
+    RelayLogicLevel _level;     /// Nivel de activación lógico
+    RelayStat _stat;            /// Estado de ejecución (Off, On)
     Ticker _tick_lowcurr;       /// Temporizador para el doble nivel de corriente
     Callback<void(uint32_t)> *_turnLowCb;    /// Callback para notificar paso a bajo nivel
   
   
 	/** isrTicker
-     *  Rutina de interrupcin del ticker asociado a la bajada a doble nivel
+     *  Rutina de interrupción del ticker asociado a la bajada a doble nivel
      */
     void isrTicker();  
 };
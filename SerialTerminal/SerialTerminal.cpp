@@ -21,8 +21,8 @@
     
     @file          SerialTerminal.h 
     @purpose       Clase que implementa un terminal serie para recibir comandos
-                   remotos. Utiliza nicamente el pin Rx. Proporciona callbacks
-                   para notificar el fin de recepcin, el fallo por timeout y el 
+                   remotos. Utiliza únicamente el pin Rx. Proporciona callbacks
+                   para notificar el fin de recepción, el fallo por timeout y el 
                    fallo por desborde de buffer. Utiliza un caracter para detectar
                    el fin de trama.
     @date          Jul 2017
@@ -69,15 +69,15 @@ void SerialTerminal::onRxData(){
             _cb_rx_ovf.call();
             return;
         }
-        // almacena el dato en el buffer de recepcin
+        // almacena el dato en el buffer de recepción
         _databuf[_recv++] = d;        
-        // en modo eof, si coincide con l, termina y notifica
+        // en modo eof, si coincide con él, termina y notifica
         if(_mode == ReceiveWithEofCharacter && d == _eof){
             _tmr.detach();
             attach(0, (SerialBase::IrqType)RxIrq);
             _cb_rx.call();
         }
-        // en modo proc, si el proceso cumple la condicin de finalizacin, termina y notifica
+        // en modo proc, si el proceso cumple la condición de finalización, termina y notifica
         else if(_mode == ReceiveWithDedicatedHandling && _cb_proc.call((uint8_t*)_databuf, _recv)){
             _tmr.detach();
             attach(0, (SerialBase::IrqType)RxIrq);
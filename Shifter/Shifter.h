@@ -37,7 +37,7 @@
  * @see API 
  *
  * <b>Shifter</b> Clase que paraleliza datos seria, controlando una serie de registros dedesplazamiento
- * conectados en cascada, para conseguir un nmero de salidas N en paralelo y sincronizadas.
+ * conectados en cascada, para conseguir un número de salidas N en paralelo y sincronizadas.
  */
 class Shifter {
 public:
@@ -46,10 +46,10 @@ public:
      *
      * Constructor.
      * Configura los gpio necesarios para controlar el registro de desplazamiento
-     * @param gpio_oe	Salida para controla el registro de salida a los pines fsicos /OE
+     * @param gpio_oe	Salida para controla el registro de salida a los pines físicos /OE
      * @param gpio_srclr Salida para controlar el reset del registro de desplazamiento /SRCLR
      * @param gpio_rclk Salida de reloj del registro de desplazamiento RCLK _/\_
-     * @param gpio_srclk Salida de reloj del registro de acumulacin SRCLK _/\_
+     * @param gpio_srclk Salida de reloj del registro de acumulación SRCLK _/\_
      * @param gpio_ser Salida para inyectar datos serie
      * @param logger Objeto logger
      */
@@ -57,18 +57,18 @@ public:
 
     /** write()
      *
-     * Paraleliza un stream de datos serie, de tamao "count"
+     * Paraleliza un stream de datos serie, de tamaño "count"
      * @param data	Stream de datos para actualizar las salidas del registro a un valor deseado.
-     * @param count Nmero de bits del registro a controlar
+     * @param count Número de bits del registro a controlar
      */
 	void write(uint8_t* data, uint8_t count);
 
     /** simulate()
      *
-     * Simula un envo de datos. til para realizar pruebas funcionales sin enviar movimientos a los motores y poder verificar
-	 * rangos mximos sin que sufra la estructura si hay algn error de implementacin.
+     * Simula un envío de datos. Útil para realizar pruebas funcionales sin enviar movimientos a los motores y poder verificar
+	 * rangos máximos sin que sufra la estructura si hay algún error de implementación.
      * @param data	Stream de datos para actualizar las salidas del registro a un valor deseado.
-     * @param count Nmero de bits del registro a controlar
+     * @param count Número de bits del registro a controlar
      */
 	void simulate(uint8_t* data, uint8_t count){}
 		
@@ -30,7 +30,7 @@
 
 //- PRIVATE -----------------------------------------------------------------------
 
-#define STEP_RESOLUTION     0.087890625f        // (360)/4096steps
+#define STEP_RESOLUTION     0.087890625f        // (360º)/4096steps
 
 const uint8_t wave_drive[]={0x08, 0x04, 0x02, 0x01, 0x08, 0x04, 0x02, 0x01};
 const uint8_t full_step[] ={0x0c, 0x06, 0x03, 0x09, 0x0c, 0x06, 0x03, 0x09};
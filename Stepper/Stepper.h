@@ -37,8 +37,8 @@
  * @see API 
  *
  * <b>Stepper</b> Clase encargada de generar las siguientes activaciones de un motor paso a paso, basadas en una orden
- * previamente solicitada. Las activaciones tendrn en cuenta el modo de trabajo del motor para saber el nmero de pasos
- * a realizar, as como la configuracin de los pines (wave_drive, full_step o half_step).
+ * previamente solicitada. Las activaciones tendrán en cuenta el modo de trabajo del motor para saber el número de pasos
+ * a realizar, así como la configuración de los pines (wave_drive, full_step o half_step).
  */
 class Stepper {
 public:
@@ -61,23 +61,23 @@ public:
     /** setRange()
      *
      * Establece el rango angular permitido
-     * @param maxdeg Lmite positivo
-     * @param mindeg Lmite negativo
+     * @param maxdeg Límite positivo
+     * @param mindeg Límite negativo
      */
 	void setRange(int16_t maxdeg, int16_t mindeg){_max_deg_limit = maxdeg; _min_deg_limit = mindeg;}
     
     /** ready()
      *
-     * Obtiene el estado del driver, indicando si est listo para una nueva operacin o si por lo
-     * contrario, est ocupado, realizando una pendiente.
+     * Obtiene el estado del driver, indicando si está listo para una nueva operación o si por lo
+     * contrario, está ocupado, realizando una pendiente.
      * @return Estado actual [true|false] [listo|ocupado]
      */
 	bool ready(){return ((_steps > 0)? false : true);}
 
     /** request()
      *
-     * Solicita un nuevo movimiento basado en un nmero de grados y un sentido concreto
-     * @param degrees Nmero de grados a girar
+     * Solicita un nuevo movimiento basado en un número de grados y un sentido concreto
+     * @param degrees Número de grados a girar
      * @param clockwise Flag para indicar el sentido de giro
      * @return Estado actual de las salidas a las que conectar el driver (x x x x IN1 IN2 IN3 IN4)
      */
@@ -85,33 +85,33 @@ public:
 
     /** next()
      *
-     * Obtiene la siguiente configuracin de las salidas en la operacin en curso. En caso de que
-     * la operacin haya concludo, se obtendr siempre el estado final.
+     * Obtiene la siguiente configuración de las salidas en la operación en curso. En caso de que
+     * la operación haya concluído, se obtendrá siempre el estado final.
      * @return Estado actual de las salidas a las que conectar el driver (x x x x IN1 IN2 IN3 IN4)
      */
 	uint8_t next();
 
     /** getSteps()
      *
-     * Obtiene el nmero de pasos que quedan para finalizar la orden actual
-     * @return Nmero de pasos pendientes
+     * Obtiene el número de pasos que quedan para finalizar la orden actual
+     * @return Número de pasos pendientes
      */
 	uint16_t getSteps(){return _steps;}
     
     /** getDegrees()
      *
-     * Obtiene el ngulo de giro actual
-     * @return Nmero de pasos pendientes
+     * Obtiene el ángulo de giro actual
+     * @return Número de pasos pendientes
      */
 	float getDegrees(){return _degrees;}
     
     /** isOOL()
      *
-     * Chequea si est fuera de rango en el siguiente movimiento
+     * Chequea si está fuera de rango en el siguiente movimiento
 	 * @param clockwise Sentido de giro
-	 * @param checklimit Chequea si est fuera de rango sin tener en cuenta el sentido
+	 * @param checklimit Chequea si está fuera de rango sin tener en cuenta el sentido
 	 *	de giro clockwise
-     * @return True si est fuera de rango.
+     * @return True si está fuera de rango.
      */
 	bool isOOL(bool clockwise, bool checklimit = false);
     
@@ -0,0 +1,261 @@
+/*
+ * WS281xAnimCodec.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  WS281xAnimCodec define el contenedor de animaciones pregrabadas para tiras WS281x y su codificador/decodificador.
+ *  No depende de mbed, de forma que la misma cabecera la utilizan el reproductor (WS281xAnimPlayer) y la herramienta
+ *  de host que genera los ficheros (tools/ws281x_anim_encode.cpp).
+ *
+ *  Formato (little-endian):
+ *
+ *  Cabecera (HeaderSize bytes):
+ *      'W' 'S' 'A' 'N'   magic
+ *      uint8_t           versión (Version)
+ *      uint8_t           flags (reservado, 0)
+ *      uint16_t          leds por frame
+ *      uint16_t          frames por segundo
+ *      uint16_t          intervalo entre keyframes
+ *      uint32_t          número de frames
+ *      uint32_t          tamaño en bytes de la sección de frames, que sigue a la cabecera
+ *
+ *  Cada frame:
+ *      uint8_t           tipo (KeyFrame, DeltaFrame)
+ *      uint16_t          tamaño en bytes de las operaciones
+ *      operaciones       secuencia de operaciones que recorren los leds desde el 0:
+ *                        byte de operación = (código << 6) | (n - 1), con n de 1 a MaxRun leds
+ *                        - OpSkip:    n leds sin cambios respecto al frame anterior
+ *                        - OpLiteral: n colores RGB (3 bytes cada uno)
+ *                        - OpRepeat:  un color RGB repetido en n leds
+ *
+ *  El tamaño de las operaciones de un frame es de 16 bits, por lo que los frames admiten como máximo MaxLeds leds.
+ *
+ *  Un KeyFrame no contiene OpSkip y se decodifica sin depender del anterior (el primer frame siempre lo es). Los
+ *  leds no cubiertos por las operaciones de un frame no cambian.
+ *
+ */
+
+
+#ifndef WS281XANIMCODEC_H
+#define WS281XANIMCODEC_H
+
+#include <stdint.h>
+#include <string.h>
+
+
+//------------------------------------------------------------------------------------
+//- CLASS WS281xAnimCodec ------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+class WS281xAnimCodec {
+  public:
+
+    static const uint8_t Version = 1;               /// Versión del formato
+    static const uint8_t HeaderSize = 20;           /// Bytes de la cabecera
+    static const uint8_t FrameHeaderSize = 3;       /// Bytes de la cabecera de cada frame
+    static const uint8_t MaxRun = 64;               /// Leds máximos por operación
+    static const uint16_t MaxLeds = 21731;          /// Leds máximos por frame, para que las operaciones de un frame
+                                                    /// (maxFrameSize - FrameHeaderSize) quepan en su tamaño de 16 bits
+
+    /** Tipos de frame */
+    enum FrameType{
+        KeyFrame = 0,
+        DeltaFrame = 1,
+    };
+
+    /** Códigos de operación */
+    enum OpCode{
+        OpSkip = 0,
+        OpLiteral = 1,
+        OpRepeat = 2,
+    };
+
+    /** @struct Header_t
+     *  @brief Cabecera del contenedor
+     */
+    struct Header_t{
+        uint16_t num_leds;                          /// Leds por frame
+        uint16_t fps;                               /// Frames por segundo
+        uint16_t key_interval;                      /// Frames entre keyframes
+        uint32_t frames;                            /// Número de frames
+        uint32_t data_size;                         /// Bytes de la sección de frames
+    };
+
+
+    /** @fn maxFrameSize()
+     *  @brief Tamaño máximo de un frame codificado (cabecera incluida), para dimensionar buffers
+     *  @param num_leds Leds por frame
+     */
+    static uint32_t maxFrameSize(uint16_t num_leds){
+        return FrameHeaderSize + ((num_leds + MaxRun - 1) / MaxRun) + (3 * (uint32_t)num_leds);
+    }
+
+
+    /** @fn writeHeader()
+     *  @brief Serializa la cabecera
+     *  @param hdr Cabecera
+     *  @param out Destino (HeaderSize bytes)
+     */
+    static void writeHeader(const Header_t& hdr, uint8_t* out){
+        out[0] = 'W'; out[1] = 'S'; out[2] = 'A'; out[3] = 'N';
+        out[4] = Version;
+        out[5] = 0;
+        put16(&out[6], hdr.num_leds);
+        put16(&out[8], hdr.fps);
+        put16(&out[10], hdr.key_interval);
+        put32(&out[12], hdr.frames);
+        put32(&out[16], hdr.data_size);
+    }
+
+
+    /** @fn readHeader()
+     *  @brief Valida y deserializa la cabecera
+     *  @param in Origen (HeaderSize bytes)
+     *  @param hdr Cabecera resultante
+     *  @return True si la cabecera es válida
+     */
+    static bool readHeader(const uint8_t* in, Header_t& hdr){
+        if(in[0] != 'W' || in[1] != 'S' || in[2] != 'A' || in[3] != 'N' || in[4] != Version){
+            return false;
+        }
+        hdr.num_leds = get16(&in[6]);
+        hdr.fps = get16(&in[8]);
+        hdr.key_interval = get16(&in[10]);
+        hdr.frames = get32(&in[12]);
+        hdr.data_size = get32(&in[16]);
+        // cada frame ocupa al menos su cabecera: una sección de frames menor es un fichero truncado o corrupto
+        return (hdr.num_leds > 0 && hdr.num_leds <= MaxLeds && hdr.frames > 0 && 
+                hdr.data_size >= (uint64_t)hdr.frames * FrameHeaderSize);
+    }
+
+
+    /** @fn encodeFrame()
+     *  @brief Codifica un frame. Los leds iguales al frame anterior se saltan y los tramos de un mismo color se
+     *         codifican una única vez
+     *  @param prev Frame anterior (RGB, 3 bytes por led) o 0 para generar un KeyFrame
+     *  @param cur Frame a codificar (RGB, 3 bytes por led)
+     *  @param num_leds Leds por frame (máximo MaxLeds)
+     *  @param out Destino (al menos maxFrameSize(num_leds) bytes)
+     *  @return Bytes escritos en out, cabecera del frame incluida, o 0 si num_leds excede MaxLeds
+     */
+    static uint32_t encodeFrame(const uint8_t* prev, const uint8_t* cur, uint16_t num_leds, uint8_t* out){
+        if(num_leds > MaxLeds){
+            return 0;
+        }
+        uint8_t* op = &out[FrameHeaderSize];
+        uint16_t i = 0;
+        while(i < num_leds){
+            // tramo sin cambios
+            uint16_t n = 0;
+            while(prev && (i + n) < num_leds && n < MaxRun && sameLed(prev, cur, i + n)){
+                n++;
+            }
+            if(n > 0){
+                *op++ = (OpSkip << 6) | (n - 1);
+                i += n;
+                continue;
+            }
+            // tramo de un mismo color
+            n = 1;
+            while((i + n) < num_leds && n < MaxRun && sameLed(cur, cur, i, i + n)){
+                n++;
+            }
+            if(n > 1){
+                *op++ = (OpRepeat << 6) | (n - 1);
+                memcpy(op, &cur[3 * i], 3);
+                op += 3;
+                i += n;
+                continue;
+            }
+            // colores sueltos, hasta el siguiente tramo sin cambios o de un mismo color
+            n = 1;
+            while((i + n) < num_leds && n < MaxRun && !(prev && sameLed(prev, cur, i + n)) &&
+                  !((i + n + 1) < num_leds && sameLed(cur, cur, i + n, i + n + 1))){
+                n++;
+            }
+            *op++ = (OpLiteral << 6) | (n - 1);
+            memcpy(op, &cur[3 * i], 3 * n);
+            op += 3 * n;
+            i += n;
+        }
+        uint32_t size = op - &out[FrameHeaderSize];
+        out[0] = (prev)? DeltaFrame : KeyFrame;
+        put16(&out[1], (uint16_t)size);
+        return FrameHeaderSize + size;
+    }
+
+
+    /** @fn decodeFrame()
+     *  @brief Decodifica las operaciones de un frame
+     *  @param in Lector de bytes, con un método uint8_t next()
+     *  @param size Bytes de operaciones del frame
+     *  @param num_leds Leds por frame
+     *  @param out Destino, con un método put(uint16_t led, uint8_t red, uint8_t green, uint8_t blue)
+     *  @return True si las operaciones son coherentes con el número de leds
+     */
+    template <class Reader, class Sink>
+    static bool decodeFrame(Reader& in, uint16_t size, uint16_t num_leds, Sink& out){
+        uint16_t led = 0;
+        while(size > 0){
+            uint8_t op = in.next();
+            uint16_t n = (op & (MaxRun - 1)) + 1;
+            size--;
+            if((uint32_t)led + n > num_leds){
+                return false;
+            }
+            switch(op >> 6){
+                case OpSkip:
+                    break;
+                case OpRepeat:{
+                    if(size < 3){
+                        return false;
+                    }
+                    uint8_t r = in.next(), g = in.next(), b = in.next();
+                    size -= 3;
+                    for(uint16_t i = 0; i < n; i++){
+                        out.put(led + i, r, g, b);
+                    }
+                    break;
+                }
+                case OpLiteral:{
+                    if(size < (3 * n)){
+                        return false;
+                    }
+                    for(uint16_t i = 0; i < n; i++){
+                        uint8_t r = in.next(), g = in.next(), b = in.next();
+                        out.put(led + i, r, g, b);
+                    }
+                    size -= 3 * n;
+                    break;
+                }
+                default:
+                    return false;
+            }
+            led += n;
+        }
+        return true;
+    }
+
+
+  protected:
+
+    /** Compara el led i de a con el led j de b */
+    static inline bool sameLed(const uint8_t* a, const uint8_t* b, uint16_t i, uint16_t j){
+        return (a[3 * i] == b[3 * j] && a[(3 * i) + 1] == b[(3 * j) + 1] && a[(3 * i) + 2] == b[(3 * j) + 2]);
+    }
+
+    /** Compara el led i de dos frames */
+    static inline bool sameLed(const uint8_t* a, const uint8_t* b, uint16_t i){
+        return sameLed(a, b, i, i);
+    }
+
+    static inline void put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+    static inline void put32(uint8_t* p, uint32_t v) { put16(p, (uint16_t)v); put16(&p[2], (uint16_t)(v >> 16)); }
+    static inline uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+    static inline uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(&p[2]) << 16); }
+};
+
+
+#endif   /* WS281XANIMCODEC_H */
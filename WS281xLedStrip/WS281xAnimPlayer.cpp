@@ -0,0 +1,178 @@
+/*
+ * WS281xAnimPlayer.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ */
+
+#include "WS281xAnimPlayer.h"
+
+
+
+//------------------------------------------------------------------------------------
+//- STATIC ---------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+
+
+
+//------------------------------------------------------------------------------------
+//- PUBLIC CLASS IMPL. ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+WS281xAnimPlayer::WS281xAnimPlayer(WS281xLedStrip* strip, BlockDevice* bd, bd_addr_t addr, uint16_t read_ahead){
+    _strip = strip;
+    _bd = bd;
+    _addr = addr;
+    _head = 0;
+    _tail = 0;
+    _read_pos = 0;
+    _frame = 0;
+    _underruns = 0;
+    _loop = false;
+    _finished = false;
+    _valid = false;
+    _playing = false;
+    memset(&_header, 0, sizeof(_header));
+    // el tamaño se redondea a potencia de 2 para indexar el buffer con una máscara
+    _size = 1;
+    while(_size < read_ahead){
+        _size <<= 1;
+    }
+    _buf = (uint8_t*)Heap::memAlloc(_size);
+}
+
+
+//------------------------------------------------------------------------------------
+WS281xAnimPlayer::~WS281xAnimPlayer(){
+    stop();
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xAnimPlayer::open(){
+    _valid = false;
+    if(!_strip || !_bd || !_buf || _strip->getBufferMode() == WS281xLedStrip::Palette){
+        return false;
+    }
+    uint8_t hdr[WS281xAnimCodec::HeaderSize];
+    if(_bd->read(hdr, _addr, WS281xAnimCodec::HeaderSize) != 0 || !WS281xAnimCodec::readHeader(hdr, _header)){
+        return false;
+    }
+    // el frame más grande debe caber en el buffer, o nunca llegaría a estar completo
+    if(_header.num_leds > _strip->getNumLeds() || WS281xAnimCodec::maxFrameSize(_header.num_leds) > _size){
+        return false;
+    }
+    _head = 0;
+    _tail = 0;
+    _read_pos = 0;
+    _frame = 0;
+    _underruns = 0;
+    _finished = false;
+    _valid = true;
+    fill();
+    return true;
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xAnimPlayer::play(bool loop){
+    if(!_valid || _header.fps == 0){
+        return false;
+    }
+    setLoop(loop);
+    _playing = _strip->startScheduler(_header.fps, callback(this, &WS281xAnimPlayer::render));
+    return _playing;
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xAnimPlayer::stop(){
+    // sólo se detiene el planificador que instaló play(), no el de otro render de la aplicación
+    if(_strip && _playing){
+        _strip->stopScheduler();
+    }
+    _playing = false;
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t WS281xAnimPlayer::fill(){
+    if(!_valid){
+        return 0;
+    }
+    uint32_t total = 0;
+    for(;;){
+        uint32_t used = _head - _tail;
+        uint32_t free = _size - used;
+        if(free == 0){
+            break;
+        }
+        // al final de la sección de frames se vuelve al primero (que siempre es KeyFrame) o se termina
+        if(_read_pos >= _header.data_size){
+            if(!_loop){
+                break;
+            }
+            _read_pos = 0;
+        }
+        uint32_t offset = _head & (_size - 1);
+        uint32_t n = _size - offset;
+        n = (n < free)? n : free;
+        n = (n < (_header.data_size - _read_pos))? n : (_header.data_size - _read_pos);
+        if(n == 0 || _bd->read(&_buf[offset], _addr + WS281xAnimCodec::HeaderSize + _read_pos, n) != 0){
+            break;
+        }
+        _read_pos += n;
+        total += n;
+        // los datos se publican al consumidor una vez leídos
+        _head += n;
+    }
+    return total;
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xAnimPlayer::nextFrame(){
+    if(!_valid || _finished){
+        return false;
+    }
+    uint32_t avail = _head - _tail;
+    if(avail < WS281xAnimCodec::FrameHeaderSize){
+        _underruns++;
+        return false;
+    }
+    RingReader in = {_buf, _size - 1, _tail};
+    uint8_t type = in.next();
+    uint16_t size = in.next();
+    size |= (uint16_t)in.next() << 8;
+    if(avail < (uint32_t)(WS281xAnimCodec::FrameHeaderSize + size)){
+        _underruns++;
+        return false;
+    }
+    StripSink out = {_strip};
+    if(type > WS281xAnimCodec::DeltaFrame || !WS281xAnimCodec::decodeFrame(in, size, _header.num_leds, out)){
+        _finished = true;
+        return false;
+    }
+    _tail += WS281xAnimCodec::FrameHeaderSize + size;
+    if(++_frame >= _header.frames){
+        _frame = 0;
+        _finished = !_loop;
+    }
+    return true;
+}
+
+
+
+//------------------------------------------------------------------------------------
+//- PROTECTED CLASS IMPL. ------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+void WS281xAnimPlayer::render(){
+    nextFrame();
+}
@@ -0,0 +1,171 @@
+/*
+ * WS281xAnimPlayer.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  WS281xAnimPlayer reproduce sobre una tira WS281xLedStrip animaciones con el formato de WS281xAnimCodec, leídas
+ *  desde un BlockDevice (normalmente SPIFBlockDevice).
+ *
+ *  La lectura y la decodificación están desacopladas mediante un buffer circular de lectura anticipada:
+ *  - fill() lee de la flash todo el espacio libre del buffer. Se invoca desde un hilo de la aplicación (puede
+ *    bloquearse lo que tarde la flash).
+ *  - nextFrame() decodifica un frame desde el buffer, sin acceder a la flash. Sólo escribe los leds que cambian
+ *    (OpLiteral y OpRepeat), y el codificador de la tira sólo recodifica los que cambian de color. Si el frame no está
+ *    completo en el buffer, no se modifica la tira y se contabiliza un underrun.
+ *
+ *  play() instala nextFrame() como render del planificador de frames de la tira (startScheduler), de forma que la
+ *  animación avanza a los fps del fichero y en contexto ISR. Si se invoca nextFrame() manualmente, la aplicación
+ *  debe publicar el frame con flush() o show().
+ *
+ *  El buffer tiene un único productor (fill) y un único consumidor (nextFrame), por lo que no requiere cerrojos.
+ *
+ */
+
+
+#ifndef WS281XANIMPLAYER_H
+#define WS281XANIMPLAYER_H
+
+
+#include "mbed.h"
+#include "BlockDevice.h"
+#include "WS281xLedStrip.h"
+#include "WS281xAnimCodec.h"
+
+//------------------------------------------------------------------------------------
+//- CLASS WS281xAnimPlayer -----------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+class WS281xAnimPlayer {
+  public:
+
+    static const uint16_t DefaultReadAhead = 2048;  /// Tamaño por defecto del buffer de lectura anticipada
+
+    /** @fn WS281xAnimPlayer()
+     *  @brief Constructor
+     *  @param strip Tira de leds
+     *  @param bd Dispositivo de bloques que contiene la animación
+     *  @param addr Dirección de la cabecera de la animación en el dispositivo
+     *  @param read_ahead Tamaño del buffer de lectura anticipada (potencia de 2, al menos el frame más grande)
+     */
+    WS281xAnimPlayer(WS281xLedStrip* strip, BlockDevice* bd, bd_addr_t addr = 0, uint16_t read_ahead = DefaultReadAhead);
+
+
+    /** @fn ~WS281xAnimPlayer()
+     *  @brief Destructor, que detiene la reproducción
+     */
+    virtual ~WS281xAnimPlayer();
+
+
+    /** @fn open()
+     *  @brief Lee y valida la cabecera, y llena el buffer de lectura anticipada desde el primer frame
+     *  @return True si la animación es válida y cabe en la tira, False también si la tira está en modo Palette
+     */
+    bool open();
+
+
+    /** @fn play()
+     *  @brief Inicia la reproducción a los fps de la animación mediante el planificador de la tira
+     *  @param loop True para repetir la animación indefinidamente
+     *  @return True si se inicia
+     */
+    bool play(bool loop = true);
+
+
+    /** @fn stop()
+     *  @brief Detiene la reproducción. Sólo detiene el planificador de la tira si lo inició play()
+     */
+    void stop();
+
+
+    /** @fn setLoop()
+     *  @brief Selecciona la repetición indefinida de la animación (también la selecciona play)
+     *  @param loop True para repetir
+     */
+    void setLoop(bool loop) { _loop = loop; }
+
+
+    /** @fn fill()
+     *  @brief Lee de la flash el espacio libre del buffer de lectura anticipada (contexto de hilo)
+     *  @return Bytes leídos
+     */
+    uint32_t fill();
+
+
+    /** @fn nextFrame()
+     *  @brief Decodifica el siguiente frame en la tira si está completo en el buffer (admite contexto ISR)
+     *  @return True si se ha decodificado un frame
+     */
+    bool nextFrame();
+
+
+    /** @fn isFinished()
+     *  @brief Indica si se ha decodificado el último frame (sin repetición) o se ha encontrado un frame erróneo
+     */
+    bool isFinished() { return _finished; }
+
+
+    /** @fn getHeader()
+     *  @brief Obtiene la cabecera de la animación (tras open)
+     */
+    const WS281xAnimCodec::Header_t& getHeader() { return _header; }
+
+
+    /** @fn getFrame()
+     *  @brief Obtiene el índice del siguiente frame a decodificar
+     */
+    uint32_t getFrame() { return _frame; }
+
+
+    /** @fn getUnderruns()
+     *  @brief Obtiene el número de frames no decodificados por falta de datos en el buffer
+     */
+    uint32_t getUnderruns() { return _underruns; }
+
+
+  protected:
+
+    /** Lector de bytes del buffer circular para WS281xAnimCodec::decodeFrame */
+    struct RingReader{
+        const uint8_t* buf;
+        uint32_t mask;
+        uint32_t pos;
+        inline uint8_t next() { return buf[(pos++) & mask]; }
+    };
+
+    /** Destino de WS281xAnimCodec::decodeFrame, que escribe los leds en la tira */
+    struct StripSink{
+        WS281xLedStrip* strip;
+        inline void put(uint16_t led, uint8_t red, uint8_t green, uint8_t blue){
+            WS281xLedStrip::Color_t color = {red, green, blue};
+            strip->putPixel(led, color);
+        }
+    };
+
+    WS281xLedStrip* _strip;                     /// Tira de leds
+    BlockDevice* _bd;                           /// Dispositivo con la animación
+    bd_addr_t _addr;                            /// Dirección de la cabecera
+    WS281xAnimCodec::Header_t _header;          /// Cabecera de la animación
+    uint8_t* _buf;                              /// Buffer de lectura anticipada
+    uint32_t _size;                             /// Tamaño del buffer (potencia de 2)
+    volatile uint32_t _head;                    /// Bytes escritos en el buffer (fill)
+    volatile uint32_t _tail;                    /// Bytes consumidos del buffer (nextFrame)
+    uint32_t _read_pos;                         /// Siguiente byte a leer de la sección de frames
+    uint32_t _frame;                            /// Siguiente frame a decodificar
+    uint32_t _underruns;                        /// Frames sin datos suficientes en el buffer
+    bool _loop;                                 /// Repetición indefinida
+    volatile bool _finished;                    /// Reproducción finalizada
+    bool _valid;                                /// Cabecera válida
+    bool _playing;                              /// Planificador de la tira iniciado por play()
+
+
+    /** @fn render()
+     *  @brief Render del planificador de la tira: decodifica el siguiente frame
+     */
+    void render();
+};
+
+
+
+#endif   /* WS281XANIMPLAYER_H */
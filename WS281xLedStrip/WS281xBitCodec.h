@@ -0,0 +1,159 @@
+/*
+ * WS281xBitCodec.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  WS281xBitCodec define la codificación de los bits WS281x en el buffer dma y su decodificación. No depende de mbed,
+ *  de forma que la misma cabecera la utilizan WS281xLedStrip (codificación), sus tests (decodificación del buffer
+ *  enviado) y la prueba de host que comprueba ambas (tools/ws281x_codec_test.cpp).
+ *
+ *  Dos representaciones, ambas con el MSB primero:
+ *
+ *  - Backend timer: un valor duty por bit, en elementos de 1, 2 o 4 bytes (ancho del buffer dma). bit_low y bit_high
+ *    son los duty de un bit a 0 y a 1.
+ *  - Backend SPI: un símbolo de 3 o 4 bits spi por bit, empaquetados en bytes: 1..0 (100, 1000) para un bit a 0 y
+ *    11..0 (110, 1100) para un bit a 1. Un byte de color ocupa symbol_bits bytes.
+ *
+ *  La codificación se resuelve con tablas de nibbles (4 bits WS281x por entrada) que se construyen una única vez.
+ *
+ */
+
+
+#ifndef WS281XBITCODEC_H
+#define WS281XBITCODEC_H
+
+#include <stdint.h>
+
+
+//------------------------------------------------------------------------------------
+//- STRUCT WS281xBitCodec ------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+struct WS281xBitCodec {
+
+    /** @fn buildNibbleLut()
+     *  @brief Construye la tabla nibble->duty del backend timer en el ancho de elemento T
+     *  @param lut Tabla de destino (16 entradas de 4 valores)
+     *  @param bit_low Duty de un bit a 0
+     *  @param bit_high Duty de un bit a 1
+     */
+    template <typename T> static void buildNibbleLut(T (*lut)[4], uint32_t bit_low, uint32_t bit_high){
+        for(uint8_t n = 0; n < 16; n++){
+            for(uint8_t b = 0; b < 4; b++){
+                lut[n][b] = (T)(((n & (0x08 >> b)) != 0)? bit_high : bit_low);
+            }
+        }
+    }
+
+
+    /** @fn encodeByte()
+     *  @brief Codifica un byte en 8 valores duty consecutivos copiando las entradas de sus dos nibbles
+     *  @param dst Posición del buffer en la que escribir los 8 valores
+     *  @param lut Tabla de nibbles en el ancho del buffer (ver buildNibbleLut)
+     *  @param value Byte a codificar
+     */
+    template <typename T> static inline void encodeByte(T* dst, const T (*lut)[4], uint8_t value){
+        const T* hi = lut[value >> 4];
+        const T* lo = lut[value & 0x0F];
+        dst[0] = hi[0]; dst[1] = hi[1]; dst[2] = hi[2]; dst[3] = hi[3];
+        dst[4] = lo[0]; dst[5] = lo[1]; dst[6] = lo[2]; dst[7] = lo[3];
+    }
+
+
+    /** @fn buildSpiNibbles()
+     *  @brief Construye la tabla nibble->símbolos del backend SPI (4 x symbol_bits bits por entrada)
+     *  @param table Tabla de destino (16 entradas)
+     *  @param symbol_bits Bits spi por bit WS281x (3 o 4)
+     */
+    static void buildSpiNibbles(uint16_t* table, uint8_t symbol_bits){
+        uint16_t sym_low = 1 << (symbol_bits - 1);
+        uint16_t sym_high = sym_low | (sym_low >> 1);
+        for(uint8_t n = 0; n < 16; n++){
+            table[n] = 0;
+            for(uint8_t b = 0; b < 4; b++){
+                table[n] = (table[n] << symbol_bits) | (((n & (0x08 >> b)) != 0)? sym_high : sym_low);
+            }
+        }
+    }
+
+
+    /** @fn encodeSpiByte()
+     *  @brief Codifica un byte como 8 símbolos spi (symbol_bits bytes)
+     *  @param dst Posición del buffer en la que escribir los símbolos
+     *  @param table Tabla de nibbles (ver buildSpiNibbles)
+     *  @param symbol_bits Bits spi por bit WS281x (3 o 4)
+     *  @param value Byte a codificar
+     *  @return Posición siguiente a los bytes escritos
+     */
+    static inline uint8_t* encodeSpiByte(uint8_t* dst, const uint16_t* table, uint8_t symbol_bits, uint8_t value){
+        uint32_t sym = ((uint32_t)table[value >> 4] << (4 * symbol_bits)) | table[value & 0x0F];
+        if(symbol_bits == 4){
+            *dst++ = (uint8_t)(sym >> 24);
+        }
+        *dst++ = (uint8_t)(sym >> 16);
+        *dst++ = (uint8_t)(sym >> 8);
+        *dst++ = (uint8_t)sym;
+        return dst;
+    }
+
+
+    /** @fn readDuty()
+     *  @brief Lee un valor duty de un buffer con elementos de 'width' bytes
+     */
+    static inline uint32_t readDuty(const uint8_t* src, uint8_t width){
+        return (width == 1)? *src : (width == 2)? *(const uint16_t*)src : *(const uint32_t*)src;
+    }
+
+
+    /** @fn decodePwm()
+     *  @brief Decodifica 'bits' valores duty consecutivos (backend timer)
+     *  @param src Primer elemento
+     *  @param width Ancho de los elementos en bytes (1, 2 o 4)
+     *  @param bits Bits a decodificar (como máximo 32)
+     *  @param bit_low Duty de un bit a 0
+     *  @param bit_high Duty de un bit a 1
+     *  @return Valor decodificado, MSB primero, o -1 si algún elemento no es bit_low ni bit_high
+     */
+    static int64_t decodePwm(const uint8_t* src, uint8_t width, uint8_t bits, uint32_t bit_low, uint32_t bit_high){
+        uint32_t value = 0;
+        for(uint8_t b = 0; b < bits; b++, src += width){
+            uint32_t duty = readDuty(src, width);
+            if(duty != bit_low && duty != bit_high){
+                return -1;
+            }
+            value = (value << 1) | ((duty == bit_high)? 1 : 0);
+        }
+        return value;
+    }
+
+
+    /** @fn decodeSpi()
+     *  @brief Decodifica 'bits' símbolos spi consecutivos (backend SPI)
+     *  @param src Byte que contiene el primer símbolo, alineado al MSB
+     *  @param symbol_bits Bits spi por bit WS281x (3 o 4)
+     *  @param bits Bits a decodificar (como máximo 32)
+     *  @return Valor decodificado, MSB primero, o -1 si algún símbolo no es válido
+     */
+    static int64_t decodeSpi(const uint8_t* src, uint8_t symbol_bits, uint8_t bits){
+        uint8_t sym_low = 1 << (symbol_bits - 1);
+        uint8_t sym_high = sym_low | (sym_low >> 1);
+        uint32_t value = 0;
+        for(uint8_t b = 0; b < bits; b++){
+            uint8_t sym = 0;
+            for(uint8_t i = 0; i < symbol_bits; i++){
+                uint32_t pos = (b * symbol_bits) + i;
+                sym = (sym << 1) | ((src[pos / 8] >> (7 - (pos % 8))) & 1);
+            }
+            if(sym != sym_low && sym != sym_high){
+                return -1;
+            }
+            value = (value << 1) | ((sym == sym_high)? 1 : 0);
+        }
+        return value;
+    }
+};
+
+
+#endif   /* WS281XBITCODEC_H */
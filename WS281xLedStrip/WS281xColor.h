@@ -0,0 +1,80 @@
+/*
+ * WS281xColor.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  WS281xColor agrupa las conversiones de color de las tiras WS281x que no dependen del hardware. No depende de mbed,
+ *  de forma que la misma cabecera la utilizan WS281xLedStrip y la herramienta de host que mide su precisión y su
+ *  velocidad (tools/ws281x_hsv_bench.cpp).
+ *
+ *  hsvToRgb es una plantilla sobre el tipo de color de destino, que sólo debe tener los miembros red, green y blue
+ *  de 8 bits (WS281xLedStrip::Color_t).
+ *
+ */
+
+
+#ifndef WS281XCOLOR_H
+#define WS281XCOLOR_H
+
+#include <stdint.h>
+
+
+//------------------------------------------------------------------------------------
+//- STRUCT WS281xColor ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+struct WS281xColor {
+
+    /** @struct Hsv_t
+     *  @brief Definición de un color HSV de 24-bit. El tono ocupa el círculo completo en 0..255 (256 = 360º)
+     */
+    struct Hsv_t{
+        uint8_t hue;
+        uint8_t sat;
+        uint8_t val;
+    };
+
+
+    /** @fn div255()
+     *  @brief Cociente x/255 redondeado al entero más próximo, sin división. Exacto para 0 <= x <= 255*255
+     */
+    static inline uint8_t div255(uint32_t x){
+        x += 128;
+        return (uint8_t)((x + (x >> 8)) >> 8);
+    }
+
+
+    /** @fn hsvToRgb()
+     *  @brief Convierte un color HSV a RGB con aritmética entera, sin divisiones (x/255 se resuelve con sumas y
+     *         desplazamientos)
+     *  @param hsv Color HSV
+     *  @param rgb Color RGB resultante
+     */
+    template <typename C> static inline void hsvToRgb(const Hsv_t& hsv, C& rgb){
+        if(hsv.sat == 0){
+            rgb.red = rgb.green = rgb.blue = hsv.val;
+            return;
+        }
+        // 6 sectores de 256/6 tonos: sector = (h*6)/256, posición dentro del sector en 0..255
+        uint16_t h6 = (uint16_t)hsv.hue * 6;
+        uint8_t sector = h6 >> 8;
+        uint8_t rem = h6 & 0xFF;
+        uint8_t v = hsv.val;
+        uint8_t p = div255(v * (255 - hsv.sat));
+        uint8_t q = div255(v * (255 - div255(hsv.sat * rem)));
+        uint8_t t = div255(v * (255 - div255(hsv.sat * (255 - rem))));
+        switch(sector){
+            case 0:  rgb.red = v; rgb.green = t; rgb.blue = p; break;
+            case 1:  rgb.red = q; rgb.green = v; rgb.blue = p; break;
+            case 2:  rgb.red = p; rgb.green = v; rgb.blue = t; break;
+            case 3:  rgb.red = p; rgb.green = q; rgb.blue = v; break;
+            case 4:  rgb.red = t; rgb.green = p; rgb.blue = v; break;
+            default: rgb.red = v; rgb.green = p; rgb.blue = q; break;
+        }
+    }
+};
+
+
+#endif   /* WS281XCOLOR_H */
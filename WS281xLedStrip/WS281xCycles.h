@@ -0,0 +1,88 @@
+/*
+ * WS281xCycles.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  WS281xCycles proporciona un contador de ciclos de muy bajo coste para instrumentar el pipeline de WS281xLedStrip.
+ *  En el target utiliza el contador DWT->CYCCNT del Cortex-M4 (una lectura de registro, a SystemCoreClock). Sin DWT
+ *  (compilación en host, que no incluye mbed.h) utiliza un reloj monótono en nanosegundos.
+ *
+ *  El contador es de 32 bits y desborda (a 80MHz cada 53s), por lo que sólo debe usarse para medir intervalos
+ *  cortos mediante la diferencia de dos lecturas.
+ *
+ */
+
+
+#ifndef WS281XCYCLES_H
+#define WS281XCYCLES_H
+
+// sólo el target (compilador ARM) dispone de mbed y del DWT de CMSIS. En host se usa std::chrono
+#if defined(__arm__) || defined(__ICCARM__)
+#include "mbed.h"
+#endif
+#if !defined(DWT)
+#include <stdint.h>
+#include <chrono>
+#endif
+
+
+//------------------------------------------------------------------------------------
+//- CLASS WS281xCycles ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+class WS281xCycles {
+  public:
+
+    /** @fn enable()
+     *  @brief Habilita el contador de ciclos (DWT) si no lo está
+     */
+    static void enable(){
+#if defined(DWT)
+        if((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0){
+            CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+            DWT->CYCCNT = 0;
+            DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        }
+#endif
+    }
+
+
+    /** @fn now()
+     *  @brief Lectura actual del contador
+     *  @return Ciclos (target) o nanosegundos (host)
+     */
+    static inline uint32_t now(){
+#if defined(DWT)
+        return DWT->CYCCNT;
+#else
+        return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+
+    /** @fn frequency()
+     *  @brief Frecuencia del contador
+     *  @return Hz
+     */
+    static inline uint32_t frequency(){
+#if defined(DWT)
+        return SystemCoreClock;
+#else
+        return 1000000000;
+#endif
+    }
+
+
+    /** @fn toUs()
+     *  @brief Convierte ciclos del contador a microsegundos
+     */
+    static inline uint32_t toUs(uint32_t cycles){
+        return (uint32_t)(((uint64_t)cycles * 1000000) / frequency());
+    }
+};
+
+
+#endif   /* WS281XCYCLES_H */
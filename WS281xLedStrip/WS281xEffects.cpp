@@ -0,0 +1,348 @@
+/*
+ * WS281xEffects.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ */
+
+#include "WS281xEffects.h"
+
+
+
+//------------------------------------------------------------------------------------
+//- STATIC ---------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+
+
+
+
+//------------------------------------------------------------------------------------
+//- PUBLIC CLASS IMPL. ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+WS281xEffects::WS281xEffects(WS281xLedStrip* strip, uint32_t tick_us){ 
+    _strip = strip;
+    _tick_us = (tick_us > 0)? tick_us : DefaultTickUs;
+    for(uint8_t i = 0; i < MaxEffects; i++){
+        _effects[i].type = NoEffect;
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+WS281xEffects::~WS281xEffects(){ 
+    stop();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xEffects::start(){
+    _tick.attach_us(callback(this, &WS281xEffects::tick), _tick_us);
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xEffects::stop(){
+    _tick.detach();
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::fade(uint16_t from, uint16_t to, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end, uint32_t ms){
+    return setupFade(alloc(from, to), start, end, ms);
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::fade(WS281xSegment* seg, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end, uint32_t ms){
+    return setupFade(alloc(seg), start, end, ms);
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::gradient(uint16_t from, uint16_t to, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end){
+    return setupGradient(alloc(from, to), start, end);
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::gradient(WS281xSegment* seg, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end){
+    return setupGradient(alloc(seg), start, end);
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::chase(uint16_t from, uint16_t to, const WS281xLedStrip::Color_t& color, const WS281xLedStrip::Color_t& background, 
+                            uint16_t width, uint32_t step_ms){
+    return setupChase(alloc(from, to), color, background, width, step_ms);
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::chase(WS281xSegment* seg, const WS281xLedStrip::Color_t& color, const WS281xLedStrip::Color_t& background, 
+                            uint16_t width, uint32_t step_ms){
+    return setupChase(alloc(seg), color, background, width, step_ms);
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::propagate(uint16_t from, uint16_t to, const WS281xLedStrip::Color_t& color, uint32_t step_ms){
+    return setupPropagation(alloc(from, to), color, step_ms);
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::propagate(WS281xSegment* seg, const WS281xLedStrip::Color_t& color, uint32_t step_ms){
+    return setupPropagation(alloc(seg), color, step_ms);
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xEffects::cancel(int8_t id){
+    if(id >= 0 && id < MaxEffects){
+        _effects[id].type = NoEffect;
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xEffects::cancelAll(){
+    for(uint8_t i = 0; i < MaxEffects; i++){
+        _effects[i].type = NoEffect;
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xEffects::tick(){
+    bool changed = false;
+    for(uint8_t i = 0; i < MaxEffects; i++){
+        Effect_t& e = _effects[i];
+        if(e.type == NoEffect || --e.wait > 0){
+            continue;
+        }
+        e.wait = e.period;
+        bool done = false;
+        switch(e.type){
+            case Fade:          done = stepFade(e); break;
+            case Gradient:      done = stepGradient(e); break;
+            case Chase:         done = stepChase(e); break;
+            case Propagation:   done = stepPropagation(e); break;
+            default:            break;
+        }
+        changed = true;
+        if(done){
+            e.type = NoEffect;
+        }
+    }
+    // una única codificación por tick para todos los efectos
+    if(changed){
+        _strip->flush();
+    }
+}
+
+
+
+//------------------------------------------------------------------------------------
+//- PROTECTED CLASS IMPL. ------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::alloc(uint16_t from, uint16_t to){
+    if(!_strip || _strip->getBufferMode() == WS281xLedStrip::Palette){
+        return -1;
+    }
+    if(to > _strip->getNumLeds()){
+        to = _strip->getNumLeds();
+    }
+    if(from >= to){
+        return -1;
+    }
+    int8_t id = -1;
+    for(uint8_t i = 0; i < MaxEffects; i++){
+        Effect_t& e = _effects[i];
+        if(e.type == NoEffect){
+            if(id < 0){
+                id = i;
+            }
+            continue;
+        }
+        // los segmentos de efectos simultáneos no pueden solaparse
+        if(from < e.to && e.from < to){
+            return -1;
+        }
+    }
+    if(id >= 0){
+        _effects[id].from = from;
+        _effects[id].to = to;
+        _effects[id].len = to - from;
+        _effects[id].map = 0;
+    }
+    return id;
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::alloc(WS281xSegment* seg){
+    if(!seg || seg->getStrip() != _strip || seg->getNumLeds() == 0){
+        return -1;
+    }
+    int8_t id = alloc(seg->_first, seg->_last + 1);
+    if(id >= 0){
+        _effects[id].len = seg->getNumLeds();
+        _effects[id].map = seg->_map;
+    }
+    return id;
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::setupFade(int8_t id, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end, uint32_t ms){
+    if(id < 0){
+        return -1;
+    }
+    Effect_t& e = _effects[id];
+    e.back = end;
+    e.pos = msToTicks(ms);
+    setupRamp(e, start, end, e.pos);
+    e.period = 1;
+    e.wait = 1;
+    // el tipo se asigna al final, cuando el efecto ya es visible para la ISR
+    e.type = Fade;
+    return id;
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::setupGradient(int8_t id, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end){
+    if(id < 0){
+        return -1;
+    }
+    Effect_t& e = _effects[id];
+    setupRamp(e, start, end, (e.len > 1)? (e.len - 1) : 1);
+    e.period = 1;
+    e.wait = 1;
+    e.type = Gradient;
+    return id;
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::setupChase(int8_t id, const WS281xLedStrip::Color_t& color, const WS281xLedStrip::Color_t& background, 
+                                 uint16_t width, uint32_t step_ms){
+    if(id < 0){
+        return -1;
+    }
+    Effect_t& e = _effects[id];
+    e.color = color;
+    e.back = background;
+    e.width = (width == 0)? 1 : (width > e.len)? e.len : width;
+    // pos fuera del segmento indica que el primer paso debe dibujar el segmento completo
+    e.pos = e.len;
+    e.period = msToTicks(step_ms);
+    e.wait = 1;
+    e.type = Chase;
+    return id;
+}
+
+
+//------------------------------------------------------------------------------------
+int8_t WS281xEffects::setupPropagation(int8_t id, const WS281xLedStrip::Color_t& color, uint32_t step_ms){
+    if(id < 0){
+        return -1;
+    }
+    Effect_t& e = _effects[id];
+    e.color = color;
+    e.pos = 0;
+    e.period = msToTicks(step_ms);
+    e.wait = 1;
+    e.type = Propagation;
+    return id;
+}
+
+
+//------------------------------------------------------------------------------------
+uint16_t WS281xEffects::msToTicks(uint32_t ms){
+    uint32_t ticks = (ms * 1000) / _tick_us;
+    return (ticks == 0)? 1 : (ticks > 0xFFFF)? 0xFFFF : (uint16_t)ticks;
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xEffects::setupRamp(Effect_t& e, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end, uint16_t steps){
+    // la única división se hace aquí; el redondeo se incluye en el acumulador inicial
+    e.acc[0] = ((int32_t)start.red << 16) + 0x8000;
+    e.acc[1] = ((int32_t)start.green << 16) + 0x8000;
+    e.acc[2] = ((int32_t)start.blue << 16) + 0x8000;
+    e.step[0] = (((int32_t)end.red - start.red) << 16) / steps;
+    e.step[1] = (((int32_t)end.green - start.green) << 16) / steps;
+    e.step[2] = (((int32_t)end.blue - start.blue) << 16) / steps;
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xEffects::fillSegment(const Effect_t& e, const WS281xLedStrip::Color_t& color){
+    for(uint16_t i = 0; i < e.len; i++){
+        _strip->putPixel(ledAt(e, i), color);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xEffects::stepFade(Effect_t& e){
+    // el último paso aplica el color final exacto
+    if(--e.pos == 0){
+        fillSegment(e, e.back);
+        return true;
+    }
+    advanceRamp(e);
+    fillSegment(e, rampColor(e));
+    return false;
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xEffects::stepGradient(Effect_t& e){
+    for(uint16_t i = 0; i < e.len; i++){
+        _strip->putPixel(ledAt(e, i), rampColor(e));
+        advanceRamp(e);
+    }
+    return true;
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xEffects::stepChase(Effect_t& e){
+    if(e.pos >= e.len){
+        fillSegment(e, e.back);
+        for(uint16_t i = 0; i < e.width; i++){
+            _strip->putPixel(ledAt(e, i), e.color);
+        }
+        e.pos = 0;
+        return false;
+    }
+    // sólo cambian la cola que sale del bloque y la cabeza que entra
+    uint16_t head = e.pos + e.width;
+    if(head >= e.len){
+        head -= e.len;
+    }
+    _strip->putPixel(ledAt(e, e.pos), e.back);
+    _strip->putPixel(ledAt(e, head), e.color);
+    if(++e.pos == e.len){
+        e.pos = 0;
+    }
+    return false;
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xEffects::stepPropagation(Effect_t& e){
+    _strip->putPixel(ledAt(e, e.pos), e.color);
+    return (++e.pos >= e.len);
+}
+
@@ -0,0 +1,318 @@
+/*
+ * WS281xEffects.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  WS281xEffects es un motor de efectos incrementales para una tira WS281xLedStrip: fundidos, degradados, 
+ *  persecuciones (chase) y propagaciones de color.
+ *
+ *  Todos los efectos avanzan desde un único Ticker (por defecto cada 20ms) y cada efecto actúa sobre un segmento 
+ *  [from, to) de la tira, de forma que sólo se modifican los leds que el efecto afecta en cada tick. Se admiten 
+ *  hasta MaxEffects efectos simultáneos siempre que sus segmentos no se solapen.
+ *
+ *  Las interpolaciones de color se realizan en aritmética de punto fijo 16.16: los incrementos se calculan una única
+ *  vez al crear el efecto y en cada tick sólo se suman.
+ *
+ *  Los efectos también pueden aplicarse sobre una vista WS281xSegment de la misma tira (tramos invertidos, con
+ *  separación entre leds...). En ese caso el efecto recorre la vista completa y, para detectar solapes, se considera
+ *  que ocupa toda la zona física entre su primer y su último led.
+ *
+ *  Los efectos y la codificación de cada tick (flush) se ejecutan en contexto ISR. Mientras el motor esté en marcha,
+ *  los segmentos afectados no deben modificarse desde la aplicación; el resto de la tira sí, incluso con commits
+ *  simultáneos, ya que WS281xLedStrip protege su mapa de leds pendientes con secciones críticas (ver Concurrencia
+ *  en WS281xLedStrip.h).
+ *
+ *  Los efectos escriben colores RGB, por lo que sobre una tira en modo Palette no se crea ninguno (devuelven -1).
+ *
+ */
+ 
+ 
+#ifndef WS281XEFFECTS_H
+#define WS281XEFFECTS_H
+
+ 
+#include "mbed.h"
+#include "WS281xLedStrip.h"
+#include "WS281xSegment.h"
+
+//------------------------------------------------------------------------------------
+//- CLASS WS281xEffects --------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+class WS281xEffects {
+  public:
+
+    static const uint8_t MaxEffects = 8;            /// Número máximo de efectos simultáneos
+    static const uint32_t DefaultTickUs = 20000;    /// Periodo de actualización por defecto (50Hz)
+
+    /** Tipos de efecto */
+    enum EffectType{
+        NoEffect,
+        Fade,
+        Gradient,
+        Chase,
+        Propagation,
+    };
+	
+    /** @fn WS281xEffects()
+     *  @brief Constructor, que asocia la tira sobre la que actúan los efectos
+     *  @param strip Tira de leds
+     *  @param tick_us Periodo de actualización de los efectos en microsegundos
+     */
+    WS281xEffects(WS281xLedStrip* strip, uint32_t tick_us = DefaultTickUs);
+
+	
+    /** @fn ~WS281xEffects()
+     *  @brief Destructor, que detiene el motor
+     */
+    virtual ~WS281xEffects();
+
+	
+    /** @fn start()
+     *  @brief Inicia la actualización periódica de los efectos
+     */
+    void start();
+
+	
+    /** @fn stop()
+     *  @brief Detiene la actualización periódica, los efectos quedan congelados
+     */
+    void stop();
+
+	
+    /** @fn fade()
+     *  @brief Fundido del segmento [from, to) entre dos colores
+     *  @param from Primer led del segmento
+     *  @param to Led siguiente al último del segmento
+     *  @param seg Vista WS281xSegment de la tira, como alternativa a [from, to)
+     *  @param start Color inicial
+     *  @param end Color final
+     *  @param ms Duración del fundido
+     *  @return Identificador del efecto o -1 si no hay hueco o el segmento se solapa con otro efecto
+     */
+    int8_t fade(uint16_t from, uint16_t to, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end, uint32_t ms);
+    int8_t fade(WS281xSegment* seg, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end, uint32_t ms);
+
+	
+    /** @fn gradient()
+     *  @brief Degradado lineal del segmento [from, to) entre dos colores. Se dibuja en el siguiente tick
+     *  @param from Primer led del segmento
+     *  @param to Led siguiente al último del segmento
+     *  @param seg Vista WS281xSegment de la tira, como alternativa a [from, to)
+     *  @param start Color del primer led
+     *  @param end Color del último led
+     *  @return Identificador del efecto o -1 si no hay hueco o el segmento se solapa con otro efecto
+     */
+    int8_t gradient(uint16_t from, uint16_t to, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end);
+    int8_t gradient(WS281xSegment* seg, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end);
+
+	
+    /** @fn chase()
+     *  @brief Bloque de leds que recorre el segmento [from, to) de forma cíclica sobre un color de fondo
+     *  @param from Primer led del segmento
+     *  @param to Led siguiente al último del segmento
+     *  @param seg Vista WS281xSegment de la tira, como alternativa a [from, to)
+     *  @param color Color del bloque
+     *  @param background Color de fondo
+     *  @param width Número de leds del bloque
+     *  @param step_ms Tiempo entre desplazamientos de un led
+     *  @return Identificador del efecto o -1 si no hay hueco o el segmento se solapa con otro efecto
+     */
+    int8_t chase(uint16_t from, uint16_t to, const WS281xLedStrip::Color_t& color, const WS281xLedStrip::Color_t& background, 
+                 uint16_t width, uint32_t step_ms);
+    int8_t chase(WS281xSegment* seg, const WS281xLedStrip::Color_t& color, const WS281xLedStrip::Color_t& background, 
+                 uint16_t width, uint32_t step_ms);
+
+	
+    /** @fn propagate()
+     *  @brief Propaga un color led a led desde el inicio hasta el final del segmento [from, to)
+     *  @param from Primer led del segmento
+     *  @param to Led siguiente al último del segmento
+     *  @param seg Vista WS281xSegment de la tira, como alternativa a [from, to)
+     *  @param color Color a propagar
+     *  @param step_ms Tiempo entre leds
+     *  @return Identificador del efecto o -1 si no hay hueco o el segmento se solapa con otro efecto
+     */
+    int8_t propagate(uint16_t from, uint16_t to, const WS281xLedStrip::Color_t& color, uint32_t step_ms);
+    int8_t propagate(WS281xSegment* seg, const WS281xLedStrip::Color_t& color, uint32_t step_ms);
+
+	
+    /** @fn cancel()
+     *  @brief Cancela un efecto, dejando sus leds en el estado actual
+     *  @param id Identificador del efecto
+     */
+    void cancel(int8_t id);
+
+	
+    /** @fn cancelAll()
+     *  @brief Cancela todos los efectos
+     */
+    void cancelAll();
+
+	
+    /** @fn isRunning()
+     *  @brief Indica si un efecto sigue en curso
+     *  @param id Identificador del efecto
+     *  @return True si no ha finalizado ni se ha cancelado
+     */
+    bool isRunning(int8_t id) { return (id >= 0 && id < MaxEffects && _effects[id].type != NoEffect); }
+
+	
+    /** @fn tick()
+     *  @brief Avanza un paso todos los efectos en curso. Lo invoca el Ticker interno, aunque puede invocarse 
+     *         directamente con el motor detenido (p.ej. desde un planificador propio)
+     */
+    void tick();
+    
+        
+  protected:       
+
+    /** @struct Effect_t
+     *  @brief Estado de un efecto
+     */
+    struct Effect_t{
+        volatile EffectType type;               /// Tipo de efecto (NoEffect si el hueco está libre)
+        uint16_t from;                          /// Primer led físico de la zona ocupada
+        uint16_t to;                            /// Led físico siguiente al último de la zona ocupada
+        uint16_t len;                           /// Leds del segmento
+        const uint16_t* map;                    /// Índices físicos de una vista WS281xSegment (0 si es un rango directo)
+        WS281xLedStrip::Color_t color;          /// Color principal
+        WS281xLedStrip::Color_t back;           /// Color final (Fade) o de fondo (Chase)
+        int32_t acc[3];                         /// Componentes R, G, B en punto fijo 16.16
+        int32_t step[3];                        /// Incremento de cada componente por tick (o por led en Gradient)
+        uint16_t period;                        /// Ticks entre pasos
+        uint16_t wait;                          /// Ticks hasta el siguiente paso
+        uint16_t pos;                           /// Posición actual dentro del segmento o pasos restantes (Fade)
+        uint16_t width;                         /// Leds del bloque (Chase)
+    };
+
+    WS281xLedStrip* _strip;                     /// Tira sobre la que se aplican los efectos
+    uint32_t _tick_us;                          /// Periodo de actualización
+    Ticker _tick;                               /// Ticker de actualización
+    Effect_t _effects[MaxEffects];              /// Efectos en curso
+
+	
+    /** @fn alloc()
+     *  @brief Busca un hueco libre para un efecto sobre el segmento [from, to)
+     *  @return Índice del hueco o -1 si no hay hueco, el segmento no es válido o se solapa con otro efecto
+     */
+    int8_t alloc(uint16_t from, uint16_t to);
+
+	
+    /** @fn alloc()
+     *  @brief Busca un hueco libre para un efecto sobre una vista de la tira
+     *  @return Índice del hueco o -1 si no hay hueco, la vista no es de esta tira o se solapa con otro efecto
+     */
+    int8_t alloc(WS281xSegment* seg);
+
+	
+    /** @fn ledAt()
+     *  @brief Obtiene el led físico correspondiente a una posición del segmento de un efecto
+     */
+    static inline uint16_t ledAt(const Effect_t& e, uint16_t pos){
+        return (e.map)? e.map[pos] : (e.from + pos);
+    }
+
+	
+    /** @fn setupFade()
+     *  @brief Inicializa un fundido en el hueco reservado 'id'
+     *  @return id o -1 si no se pudo reservar el hueco
+     */
+    int8_t setupFade(int8_t id, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end, uint32_t ms);
+
+	
+    /** @fn setupGradient()
+     *  @brief Inicializa un degradado en el hueco reservado 'id'
+     *  @return id o -1 si no se pudo reservar el hueco
+     */
+    int8_t setupGradient(int8_t id, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end);
+
+	
+    /** @fn setupChase()
+     *  @brief Inicializa un chase en el hueco reservado 'id'
+     *  @return id o -1 si no se pudo reservar el hueco
+     */
+    int8_t setupChase(int8_t id, const WS281xLedStrip::Color_t& color, const WS281xLedStrip::Color_t& background, 
+                      uint16_t width, uint32_t step_ms);
+
+	
+    /** @fn setupPropagation()
+     *  @brief Inicializa una propagación en el hueco reservado 'id'
+     *  @return id o -1 si no se pudo reservar el hueco
+     */
+    int8_t setupPropagation(int8_t id, const WS281xLedStrip::Color_t& color, uint32_t step_ms);
+
+	
+    /** @fn msToTicks()
+     *  @brief Convierte un tiempo a ticks del motor (mínimo 1)
+     */
+    uint16_t msToTicks(uint32_t ms);
+
+	
+    /** @fn setupRamp()
+     *  @brief Calcula el acumulador y el incremento en punto fijo para ir de un color a otro en 'steps' pasos
+     */
+    static void setupRamp(Effect_t& e, const WS281xLedStrip::Color_t& start, const WS281xLedStrip::Color_t& end, uint16_t steps);
+
+	
+    /** @fn rampColor()
+     *  @brief Obtiene el color actual del acumulador en punto fijo
+     */
+    static inline WS281xLedStrip::Color_t rampColor(const Effect_t& e){
+        WS281xLedStrip::Color_t c;
+        c.red = (uint8_t)(e.acc[0] >> 16);
+        c.green = (uint8_t)(e.acc[1] >> 16);
+        c.blue = (uint8_t)(e.acc[2] >> 16);
+        return c;
+    }
+
+	
+    /** @fn advanceRamp()
+     *  @brief Avanza el acumulador un paso
+     */
+    static inline void advanceRamp(Effect_t& e){
+        e.acc[0] += e.step[0];
+        e.acc[1] += e.step[1];
+        e.acc[2] += e.step[2];
+    }
+
+	
+    /** @fn fillSegment()
+     *  @brief Aplica un color a todo el segmento de un efecto
+     */
+    void fillSegment(const Effect_t& e, const WS281xLedStrip::Color_t& color);
+
+	
+    /** @fn stepFade()
+     *  @brief Avanza un fundido
+     *  @return True si el efecto ha finalizado
+     */
+    bool stepFade(Effect_t& e);
+
+	
+    /** @fn stepGradient()
+     *  @brief Dibuja un degradado
+     *  @return True (el efecto finaliza tras dibujarse)
+     */
+    bool stepGradient(Effect_t& e);
+
+	
+    /** @fn stepChase()
+     *  @brief Desplaza el bloque de un chase un led
+     *  @return False (el efecto no finaliza hasta cancelarse)
+     */
+    bool stepChase(Effect_t& e);
+
+	
+    /** @fn stepPropagation()
+     *  @brief Propaga el color al siguiente led
+     *  @return True si el color ha alcanzado el final del segmento
+     */
+    bool stepPropagation(Effect_t& e);
+};    
+
+
+
+#endif   /* WS281XEFFECTS_H */
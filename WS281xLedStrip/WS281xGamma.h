@@ -0,0 +1,79 @@
+/*
+ * WS281xGamma.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  WS281xGamma proporciona tablas de corrección gamma de 256 entradas generadas en tiempo de compilación (constexpr,
+ *  requiere C++11). El exponente se selecciona como parámetro de plantilla en décimas: WS281xGamma<22>::table es la
+ *  tabla para gamma 2.2, y queda almacenada en flash sin coste alguno en el arranque.
+ *
+ *  Cada entrada se calcula como round(255 * (i/255)^gamma) mediante series de ln y exp evaluadas por el compilador.
+ *
+ */
+
+
+#ifndef WS281XGAMMA_H
+#define WS281XGAMMA_H
+
+#include <stdint.h>
+
+
+//------------------------------------------------------------------------------------
+//- STRUCT WS281xGammaMath -----------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+struct WS281xGammaMath {
+
+    /** Serie de ln(x) = 2 * sum(t^(2k+1)/(2k+1)), t=(x-1)/(x+1), con x en [1,2) */
+    static constexpr double lnTerm(double t, double t2, int k){
+        return (k > 20)? 0.0 : (t / (2 * k + 1)) + lnTerm(t * t2, t2, k + 1);
+    }
+
+    /** ln(x) para x >= 1, reduciendo el argumento a [1,2) */
+    static constexpr double ln(double x, int k = 0){
+        return (x >= 2.0)? ln(x / 2.0, k + 1) :
+                           (k * 0.69314718055994530942) + 2.0 * lnTerm((x - 1) / (x + 1), ((x - 1) / (x + 1)) * ((x - 1) / (x + 1)), 0);
+    }
+
+    /** Serie de exp(x) = sum(x^k/k!) */
+    static constexpr double expTerm(double x, double term, int k){
+        return (k > 80)? 0.0 : term + expTerm(x, (term * x) / (k + 1), k + 1);
+    }
+
+    /** Valor corregido de un nivel 0..255 para un exponente gamma (en décimas) */
+    static constexpr uint8_t value(int i, int gamma_x10){
+        return (i == 0)? 0 : (uint8_t)((255.0 * expTerm((gamma_x10 / 10.0) * (ln(i) - ln(255)), 1.0, 0)) + 0.5);
+    }
+};
+
+
+//------------------------------------------------------------------------------------
+//- STRUCT WS281xGamma ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+template <int GammaX10>
+struct WS281xGamma {
+    static const uint8_t table[256];
+};
+
+
+#define WS281X_GAMMA_1(i)   WS281xGammaMath::value((i), GammaX10)
+#define WS281X_GAMMA_4(i)   WS281X_GAMMA_1(i), WS281X_GAMMA_1(i+1), WS281X_GAMMA_1(i+2), WS281X_GAMMA_1(i+3)
+#define WS281X_GAMMA_16(i)  WS281X_GAMMA_4(i), WS281X_GAMMA_4(i+4), WS281X_GAMMA_4(i+8), WS281X_GAMMA_4(i+12)
+#define WS281X_GAMMA_64(i)  WS281X_GAMMA_16(i), WS281X_GAMMA_16(i+16), WS281X_GAMMA_16(i+32), WS281X_GAMMA_16(i+48)
+
+template <int GammaX10>
+const uint8_t WS281xGamma<GammaX10>::table[256] = {
+    WS281X_GAMMA_64(0), WS281X_GAMMA_64(64), WS281X_GAMMA_64(128), WS281X_GAMMA_64(192)
+};
+
+#undef WS281X_GAMMA_64
+#undef WS281X_GAMMA_16
+#undef WS281X_GAMMA_4
+#undef WS281X_GAMMA_1
+
+
+#endif   /* WS281XGAMMA_H */
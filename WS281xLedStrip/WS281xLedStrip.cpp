@@ -13,6 +13,7 @@
 //- STATIC ---------------------------------------------------------------------------
 //------------------------------------------------------------------------------------
 
+static void unhandled_callback(){}
 
 
 
@@ -24,23 +25,452 @@
 
 
 //------------------------------------------------------------------------------------
-WS281xLedStrip::WS281xLedStrip(PinName pin, uint32_t hz, uint16_t num_leds) : DMA_PwmOut(pin, hz){ 
-    _num_leds = num_leds;
-    _buffer_size = ((_num_leds * ColorBits) + ResetTimeBits) * sizeof(uint32_t);
-    _color_buffer = (uint32_t*)Heap::memAlloc(_buffer_size);
-    if(_color_buffer){
-        memset(_color_buffer, ResetTimeValue, _buffer_size);        
+WS281xLedStrip::WS281xLedStrip(PinName pin, uint32_t hz, uint16_t num_leds, DMA_PwmOut::DutyWidth width, BufferMode mode, uint16_t stream_leds) 
+        : WS281xLedStrip(pin, hz, num_leds, width, mode, stream_leds, ColorBits, ResetTimeBits, BitLowPercent, BitHighPercent){ 
+}
+
+
+//------------------------------------------------------------------------------------
+WS281xLedStrip::WS281xLedStrip(PinName pin, uint32_t hz, uint16_t num_leds, DMA_PwmOut::DutyWidth width, BufferMode mode, uint16_t stream_leds,
+                               uint8_t led_bits, uint16_t reset_bits, uint8_t low_percent, uint8_t high_percent){ 
+    _pwm = new DMA_PwmOut(pin, hz, width);
+    _width = _pwm->getDutyWidth();
+    _spi = 0;
+    _symbol_bits = 0;
+    // cada bit ocupa un elemento de _width bytes, cuyo ancho efectivo lo decide DMA_PwmOut en función del periodo
+    _led_size = led_bits * _width;
+    _reset_size = reset_bits * _width;
+    _bitLow = _pwm->getTickPercent(low_percent);
+    _bitHigh = _pwm->getTickPercent(high_percent);
+    // precalcula la tabla de codificación: cada nibble se traduce a 4 valores duty (MSB primero). Las vistas de la
+    // unión se solapan, por lo que sólo se rellena la del ancho de elemento del buffer dma
+    switch(_width){
+        case DMA_PwmOut::DutyWidth8:    WS281xBitCodec::buildNibbleLut(_nibble_lut.u8, _bitLow, _bitHigh); break;
+        case DMA_PwmOut::DutyWidth16:   WS281xBitCodec::buildNibbleLut(_nibble_lut.u16, _bitLow, _bitHigh); break;
+        default:                        WS281xBitCodec::buildNibbleLut(_nibble_lut.u32, _bitLow, _bitHigh); break;
+    }
+    setEncoder(&WS281xLedStrip::encodeColor<uint8_t>, &WS281xLedStrip::encodeColor<uint16_t>, &WS281xLedStrip::encodeColor<uint32_t>);
+    setup(hz, num_leds, mode, stream_leds, led_bits, reset_bits);
+    // los errores de la dma del timer cancelan el envío en curso igual que los de la dma spi
+    _pwm->dmaSetErrorCb(callback(this, &WS281xLedStrip::onDmaError));
+}
+
+
+//------------------------------------------------------------------------------------
+WS281xLedStrip::WS281xLedStrip(DMA_SPI* spi, uint32_t spi_hz, uint16_t num_leds, SpiSymbol symbol, BufferMode mode, uint16_t stream_leds){ 
+    // sin canal pwm: las rutas de envío, parada y modo de refresco eligen el backend según _spi
+    _pwm = 0;
+    _width = DMA_PwmOut::DutyWidth8;
+    _spi = spi;
+    _symbol_bits = symbol;
+    _led_size = (ColorBits * _symbol_bits) / 8;
+    _reset_size = ((ResetTimeBits * _symbol_bits) + 7) / 8;
+    _bitLow = 0;
+    _bitHigh = 0;
+    // precalcula la tabla de codificación: cada nibble se traduce a 4 símbolos (1..0 para un 0, 11..0 para un 1)
+    WS281xBitCodec::buildSpiNibbles(_spi_nibble, _symbol_bits);
+    _encoder = &WS281xLedStrip::encodeSpi;
+    setup(spi_hz / symbol, num_leds, mode, stream_leds, ColorBits, ResetTimeBits);
+    if(_spi){
+        _spi->dmaSetCircular(true);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+WS281xLedStrip::~WS281xLedStrip(){
+    // al destruir el canal pwm se detiene su dma y se libera su canal
+    if(_pwm){
+        delete(_pwm);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::start(){
+    startDma(false);
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::stop(){
+    stopScheduler();
+    if(_spi){
+        _spi->dmaStop();
     }
-    _bitLow = DMA_PwmOut::getTickPercent(32);
-    _bitHigh = DMA_PwmOut::getTickPercent(64);
+    else{
+        _pwm->dmaStop();
+    }
+    _sending = false;
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xLedStrip::setRefreshMode(RefreshMode mode){
+    if(isStreaming() && mode != Continuous){
+        return false;
+    }
+    _refresh = mode;
+    if(_spi){
+        _spi->dmaSetCircular(_refresh == Continuous);
+        return true;
+    }
+    _pwm->dmaSetOneShot(_refresh == OneShot);
+    return true;
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xLedStrip::startScheduler(uint16_t fps, Callback<void()> render_cb){
+    if(fps == 0){
+        return false;
+    }
+    stopScheduler();
+    _renderCb = render_cb;
+    _frame_cnt = 0;
+    _frame_budget = WS281xCycles::frequency() / fps;
+    if(_refresh == OneShot){
+        // el primer frame se renderiza ya, y se envía en el primer tick
+        _renderCb.call();
+        _frame_ready = true;
+        _sched = true;
+        _frameTick.attach_us(callback(this, &WS281xLedStrip::onFrameTick), 1000000 / fps);
+        return true;
+    }
+    uint32_t div = getFrameRate() / fps;
+    _frame_div = (div == 0)? 1 : (div > 0xFFFF)? 0xFFFF : (uint16_t)div;
+    _sched = true;
+    return true;
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::stopScheduler(){
+    _sched = false;
+    _frameTick.detach();
+    _frame_ready = false;
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t WS281xLedStrip::getFrameRate(){
+    // bits WS281x por frame: en el backend SPI cada uno ocupa _symbol_bits bits del buffer
+    uint32_t elements = (isStreaming())? ((_reset_slots + _num_leds) * _led_bits) : 
+                        (_spi)? ((_buffer_size * 8) / _symbol_bits) : (_buffer_size / _width);
+    return (elements)? (_hz / elements) : 0;
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::getStats(Stats_t& snapshot){
+    core_util_critical_section_enter();
+    snapshot = _stats;
+    core_util_critical_section_exit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::resetStats(){
+    core_util_critical_section_enter();
+    memset(&_stats, 0, sizeof(Stats_t));
+    _encode_acc = 0;
+    core_util_critical_section_exit();
 }
 
 
 //------------------------------------------------------------------------------------
 void WS281xLedStrip::setRange(uint16_t from, uint16_t to, const Color_t& color){
-    for(int i = from; i < to; i++){
-        applyColor(i, color);
+    if(to > _num_leds){
+        to = _num_leds;
+    }
+    if(!_color_buffer || !_pixels || from >= to){
+        return;
     }
+    // en modo Streaming sólo se actualiza el framebuffer, la codificación se hace al vuelo
+    if(_mode == Streaming){
+        for(uint16_t i = from; i < to; i++){
+            _pixels[i] = color;
+        }
+        return;
+    }
+    // marca únicamente los leds que cambian de color. Los descartados se publican una sola vez al final
+    uint32_t skipped = 0;
+    for(uint16_t i = from; i < to; i++){
+        if(!storePixel(i, color)){
+            skipped++;
+        }
+    }
+    addStat(_stats.skipped, skipped);
+    autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::setPixels(uint16_t offset, const Color_t* src, uint16_t n){
+    if(!_color_buffer || !_pixels || !src || offset >= _num_leds){
+        return;
+    }
+    if(n > (_num_leds - offset)){
+        n = _num_leds - offset;
+    }
+    if(_mode == Streaming){
+        memcpy(&_pixels[offset], src, n * sizeof(Color_t));
+        return;
+    }
+    uint32_t skipped = 0;
+    for(uint16_t i = 0; i < n; i++){
+        if(!storePixel(offset + i, src[i])){
+            skipped++;
+        }
+    }
+    addStat(_stats.skipped, skipped);
+    autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::fillPattern(uint16_t offset, const Color_t* pattern, uint16_t patlen, uint16_t n){
+    if(!_color_buffer || !_pixels || !pattern || patlen == 0 || offset >= _num_leds){
+        return;
+    }
+    if(n > (_num_leds - offset)){
+        n = _num_leds - offset;
+    }
+    // el índice del patrón se avanza sin divisiones
+    uint16_t p = 0;
+    if(_mode == Streaming){
+        for(uint16_t i = offset; i < (offset + n); i++){
+            _pixels[i] = pattern[p];
+            if(++p == patlen){
+                p = 0;
+            }
+        }
+        return;
+    }
+    uint32_t skipped = 0;
+    for(uint16_t i = offset; i < (offset + n); i++){
+        if(!storePixel(i, pattern[p])){
+            skipped++;
+        }
+        if(++p == patlen){
+            p = 0;
+        }
+    }
+    addStat(_stats.skipped, skipped);
+    autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::setPixelsHSV(uint16_t offset, const Hsv_t* src, uint16_t n){
+    if(!_color_buffer || !_pixels || !src || offset >= _num_leds){
+        return;
+    }
+    if(n > (_num_leds - offset)){
+        n = _num_leds - offset;
+    }
+    Color_t color;
+    for(uint16_t i = 0; i < n; i++){
+        hsvToRgb(src[i], color);
+        putPixel(offset + i, color);
+    }
+    autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xLedStrip::enableDithering(){
+    if(_hires_map){
+        return true;
+    }
+    if(!_dirty || !_pixels){
+        return false;
+    }
+    _hires = (Color16_t*)Heap::memAlloc(_num_leds * sizeof(Color16_t));
+    _dither_err = (Color_t*)Heap::memAlloc(_num_leds * sizeof(Color_t));
+    _frac_map = (uint32_t*)Heap::memAlloc(getDirtySize());
+    uint32_t* hires_map = (uint32_t*)Heap::memAlloc(getDirtySize());
+    if(!_hires || !_dither_err || !_frac_map || !hires_map){
+        return false;
+    }
+    memset(_frac_map, 0, getDirtySize());
+    memset(hires_map, 0, getDirtySize());
+    // el mapa se publica al final, ya que su presencia habilita el dithering en storePixel y commit
+    _hires_map = hires_map;
+    return true;
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::setRange16(uint16_t from, uint16_t to, const Color16_t& color){
+    if(to > _num_leds){
+        to = _num_leds;
+    }
+    if(!_color_buffer || !_hires_map || from >= to){
+        return;
+    }
+    for(uint16_t i = from; i < to; i++){
+        storeHires(i, color);
+    }
+    autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::setPixels16(uint16_t offset, const Color16_t* src, uint16_t n){
+    if(!_color_buffer || !_hires_map || !src || offset >= _num_leds){
+        return;
+    }
+    if(n > (_num_leds - offset)){
+        n = _num_leds - offset;
+    }
+    for(uint16_t i = 0; i < n; i++){
+        storeHires(offset + i, src[i]);
+    }
+    autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::setIndexRange(uint16_t from, uint16_t to, uint8_t index){
+    if(to > _num_leds){
+        to = _num_leds;
+    }
+    if(!_indices || from >= to){
+        return;
+    }
+    memset(&_indices[from], index, to - from);
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::setIndices(uint16_t offset, const uint8_t* src, uint16_t n){
+    if(!_indices || !src || offset >= _num_leds){
+        return;
+    }
+    if(n > (_num_leds - offset)){
+        n = _num_leds - offset;
+    }
+    memcpy(&_indices[offset], src, n);
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::setPaletteEntry(uint8_t index, const Color_t& color){
+    if(_palette){
+        _palette[index] = color;
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::setPalette(uint8_t first, const Color_t* colors, uint16_t count){
+    if(!_palette || !colors){
+        return;
+    }
+    if(count > (PaletteSize - first)){
+        count = PaletteSize - first;
+    }
+    memcpy(&_palette[first], colors, count * sizeof(Color_t));
+}
+
+
+//------------------------------------------------------------------------------------
+uint16_t WS281xLedStrip::commit(){
+    if(!_dirty || !_color_buffer){
+        return 0;
+    }
+    uint32_t t0 = WS281xCycles::now();
+    // cada commit es un frame de dithering: los leds fraccionarios cambiados quedan marcados en _dirty
+    if(_frac_map){
+        ditherStep();
+    }
+    // un commit desde una ISR (WS281xEffects) puede interrumpir a otro de la aplicación: al terminar se restaura la
+    // tabla que estuviera aplicando
+    const uint8_t* lut = _lut;
+    uint8_t* last = 0;
+    uint16_t last_led = 0;
+    bool last_raw = false;
+    uint16_t count = 0;
+    for(uint16_t w = 0; w < getDirtySize()/sizeof(uint32_t); w++){
+        if(_dirty[w] == 0){
+            continue;
+        }
+        // la palabra se consume en sección crítica para no perder los leds que marque una ISR entre lectura y borrado
+        core_util_critical_section_enter();
+        uint32_t bits = _dirty[w];
+        _dirty[w] = 0;
+        core_util_critical_section_exit();
+        for(uint16_t led = (w << 5); bits != 0 && led < _num_leds; led++, bits >>= 1){
+            if((bits & 1) == 0){
+                continue;
+            }
+            uint8_t* dst = &_color_buffer[_reset_size + (led * _led_size)];
+            // si coincide con el último led codificado se replica su patrón
+            bool raw = isHires(led);
+            if(last && raw == last_raw && sameColor(_pixels[led], _pixels[last_led])){
+                memcpy(dst, last, _led_size);
+            }
+            else{
+                // los leds con dithering ya contienen el nivel de salida y se codifican con la identidad
+                _lut = (raw)? WS281xGamma<10>::table : _level_lut;
+                encodeAt(dst, _pixels[led]);
+            }
+            last = dst;
+            last_led = led;
+            last_raw = raw;
+            count++;
+        }
+    }
+    _lut = lut;
+    // commit se ejecuta desde la aplicación y desde las ISR: los contadores se publican juntos en sección crítica
+    uint32_t cycles = WS281xCycles::now() - t0;
+    core_util_critical_section_enter();
+    _stats.encoded += count;
+    _encode_acc += cycles;
+    core_util_critical_section_exit();
+    return count;
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xLedStrip::show(){
+    if(_refresh == OneShot){
+        return startDma(false);
+    }
+    if(_mode != DoubleBuffer || _swap_pending){
+        return false;
+    }
+    commit();
+    _swap_pending = true;
+    return true;
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::setGamma(const uint8_t* table){
+    _gamma = table;
+    updateLevels();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::setBrightness(uint8_t level){
+    _brightness = level;
+    updateLevels();
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t WS281xLedStrip::getMemorySaved(){
+    uint32_t legacy_size = ((_num_leds * _led_bits) + _reset_bits) * sizeof(uint32_t);
+    uint32_t used_size = _buffer_size + ((_pixels)? (_num_leds * sizeof(Color_t)) : 0);
+    used_size += (_indices)? _num_leds : 0;
+    used_size += (_palette)? (PaletteSize * sizeof(Color_t)) : 0;
+    used_size += (_dirty)? getDirtySize() : 0;
+    used_size += (_hires_map)? ((_num_leds * (sizeof(Color16_t) + sizeof(Color_t))) + (2 * getDirtySize())) : 0;
+    used_size += (_front_buffer)? (_buffer_size + getDirtySize()) : 0;
+    return (legacy_size > used_size)? (legacy_size - used_size) : 0;
 }
 
 
@@ -50,27 +480,408 @@ void WS281xLedStrip::setRange(uint16_t from, uint16_t to, const Color_t& color){
 //------------------------------------------------------------------------------------
 
 
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::setup(uint32_t hz, uint16_t num_leds, BufferMode mode, uint16_t stream_leds, uint8_t led_bits, uint16_t reset_bits){
+    _led_bits = led_bits;
+    _reset_bits = reset_bits;
+    _reset_slots = (_reset_bits + _led_bits - 1) / _led_bits;
+    _num_leds = num_leds;
+    _mode = mode;
+    _refresh = Continuous;
+    _sending = false;
+    _frameCb = callback(unhandled_callback);
+    _renderCb = callback(unhandled_callback);
+    _sched = false;
+    _frame_ready = false;
+    _frame_div = 1;
+    _frame_cnt = 0;
+    _hz = hz;
+    _frame_ends = 0;
+    _pixels = 0;
+    _hires = 0;
+    _dither_err = 0;
+    _hires_map = 0;
+    _frac_map = 0;
+    _lut = _level_lut;
+    _dirty = 0;
+    _front_dirty = 0;
+    _frame_budget = 0;
+    resetStats();
+    WS281xCycles::enable();
+    _front_buffer = 0;
+    _swap_pending = false;
+    _stream_leds = (stream_leds > 0)? stream_leds : DefaultStreamLeds;
+    _stream_slot = 0;
+    _dmaHalfCb = callback(this, &WS281xLedStrip::onDmaHalf);
+    _dmaCpltCb = callback(this, &WS281xLedStrip::onDmaCplt);
+    _dmaErrCb = callback(this, &WS281xLedStrip::onSpiError);
+    _spi_error = false;
+    _indices = 0;
+    _palette = 0;
+    if(_mode == Palette){
+        // 1 byte por led y paleta de 256 colores, inicialmente todos los leds con el índice 0 (negro)
+        _indices = (uint8_t*)Heap::memAlloc(_num_leds);
+        if(_indices){
+            memset(_indices, 0, _num_leds);
+        }
+        _palette = (Color_t*)Heap::memAlloc(PaletteSize * sizeof(Color_t));
+        if(_palette){
+            memset(_palette, 0, PaletteSize * sizeof(Color_t));
+        }
+    }
+    else{
+        _pixels = (Color_t*)Heap::memAlloc(_num_leds * sizeof(Color_t));
+        if(_pixels){
+            memset(_pixels, 0, _num_leds * sizeof(Color_t));
+        }
+    }
+    if(isStreaming()){
+        _buffer_size = 2 * _stream_leds * _led_size;
+    }
+    else{
+        // el elemento final a 0 ocupa un elemento del timer o un byte spi
+        _buffer_size = (_num_leds * _led_size) + _reset_size + ((_spi)? IdleBits : (IdleBits * _width));
+        // inicialmente todos los leds están pendientes de codificar (a negro)
+        _dirty = (uint32_t*)Heap::memAlloc(getDirtySize());
+        if(_dirty){
+            memset(_dirty, 0xFF, getDirtySize());
+        }
+    }
+    _color_buffer = (uint8_t*)Heap::memAlloc(_buffer_size);
+    if(_color_buffer){
+        memset(_color_buffer, ResetTimeValue, _buffer_size);        
+    }
+    if(_mode == DoubleBuffer){
+        _front_buffer = (uint8_t*)Heap::memAlloc(_buffer_size);
+        if(_front_buffer){
+            memset(_front_buffer, ResetTimeValue, _buffer_size);        
+        }
+        _front_dirty = (uint32_t*)Heap::memAlloc(getDirtySize());
+        if(_front_dirty){
+            memset(_front_dirty, 0xFF, getDirtySize());
+        }
+    }
+    // sin corrección gamma y con brillo máximo, la tabla de niveles es la identidad
+    _gamma = 0;
+    _brightness = 255;
+    for(uint16_t i = 0; i < 256; i++){
+        _level_lut[i] = (uint8_t)i;
+    }
+    // no se codifica nada aquí: un formato de pixel derivado aún no ha instalado su codificador. Todos los leds
+    // quedan pendientes y se codifican en la primera escritura o al iniciar la dma
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xLedStrip::startDma(bool arm_only){
+    if(!_color_buffer){
+        return false;
+    }
+    if(_refresh == OneShot){
+        // no se modifica el buffer en envío; en DoubleBuffer el nuevo frame se codifica en el trasero y se intercambia
+        if(_sending){
+            return false;
+        }
+        commit();
+        if(_mode == DoubleBuffer){
+            _swap_pending = true;
+        }
+    }
+    else if(_mode == SingleBuffer){
+        // codifica lo pendiente, incluido el frame inicial a negro si aún no se ha escrito ningún led
+        commit();
+    }
+    if(isStreaming()){
+        // precarga ambas mitades desde el inicio del frame y deja que las interrupciones continúen
+        _stream_slot = 0;
+        fillStream(_color_buffer);
+        fillStream(&_color_buffer[_stream_leds * _led_size]);
+        return runDma(_color_buffer, arm_only);
+    }
+    if(_mode == DoubleBuffer){
+        if(!_front_buffer){
+            return false;
+        }
+        // sin dma en marcha, un show() previo se resuelve directamente
+        if(_swap_pending){
+            swapBuffers();
+            _swap_pending = false;
+        }
+        return runDma(_front_buffer, arm_only);
+    }
+    return runDma(_color_buffer, arm_only);
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xLedStrip::runDma(uint8_t* buf, bool arm_only){
+    if(_spi){
+        // el bus spi no comparte base de tiempos con otras tiras, por lo que no se puede armar en fase
+        if(arm_only){
+            return false;
+        }
+        // los errores de inicio se notifican de forma síncrona mediante onSpiError
+        _sending = (_refresh == OneShot);
+        _spi_error = false;
+        _spi->transmit(buf, _buffer_size, _dmaHalfCb, _dmaCpltCb, _dmaErrCb);
+        return !_spi_error;
+    }
+    if(_refresh == OneShot){
+        _sending = true;
+        DMA_PwmOut::ErrorResult err = (arm_only)? _pwm->dmaArm(buf, _buffer_size/_width, _dmaHalfCb, _dmaCpltCb) :
+                                                  _pwm->dmaSend(buf, _buffer_size/_width, _dmaCpltCb);
+        if(err != DMA_PwmOut::NO_ERRORS){
+            _sending = false;
+            addStat(_stats.dma_errors, 1);
+        }
+        return (err == DMA_PwmOut::NO_ERRORS);
+    }
+    // en todos los modos se instalan las callbacks, el fin de buffer marca el fin de cada frame
+    DMA_PwmOut::ErrorResult err = (arm_only)? _pwm->dmaArm(buf, _buffer_size/_width, _dmaHalfCb, _dmaCpltCb) :
+                                              _pwm->dmaStart(buf, _buffer_size/_width, _dmaHalfCb, _dmaCpltCb);
+    if(err != DMA_PwmOut::NO_ERRORS){
+        addStat(_stats.dma_errors, 1);
+    }
+    return (err == DMA_PwmOut::NO_ERRORS);
+}
+
+
 //------------------------------------------------------------------------------------
 void WS281xLedStrip::applyColor(uint16_t led, const Color_t& color){
-    // calcula la posicin base del led, excluyendo los bits dedicados al tiempo de reset
-    uint16_t pos = ResetTimeBits + (led * ColorBits);    
-    uint8_t c13 = ColorBits/3;
-    uint8_t c23 = (2*ColorBits)/3;
-    
-    uint8_t mask = 0x80;
-    for(int i = pos; i < (pos + c13); i++){
-        _color_buffer[i] = ((color.green & mask) != 0)? _bitHigh : _bitLow;
-        mask = ((mask >> 1) & 0x7F);
-    }
-    mask = 0x80;
-    for(int i = (pos+c13); i < (pos + c23); i++){
-        _color_buffer[i] = ((color.red & mask) != 0)? _bitHigh : _bitLow;
-        mask = ((mask >> 1) & 0x7F);
-    }
-    mask = 0x80;
-    for(int i = (pos+c23); i < (pos + ColorBits); i++){
-        _color_buffer[i] = ((color.blue & mask) != 0)? _bitHigh : _bitLow;
-        mask = ((mask >> 1) & 0x7F);
+    // calcula la posición base del led, excluyendo los bits dedicados al tiempo de reset
+    encodeAt(&_color_buffer[_reset_size + (led * _led_size)], color);
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::updateLevels(){
+    // el brillo se aplica tras la corrección gamma (espacio lineal de intensidad)
+    uint16_t scale = (uint16_t)_brightness + 1;
+    for(uint16_t i = 0; i < 256; i++){
+        uint16_t level = (_gamma)? _gamma[i] : i;
+        _level_lut[i] = (uint8_t)((level * scale) >> 8);
+    }
+    // los niveles de salida de los leds con dithering dependen de la tabla
+    if(_hires_map){
+        for(uint16_t led = 0; led < _num_leds; led++){
+            if(isHires(led)){
+                storeHires(led, _hires[led]);
+            }
+        }
+    }
+    // en Streaming la tabla se aplica en el siguiente frame, en el resto se recodifica toda la tira
+    if(_dirty){
+        memset(_dirty, 0xFF, getDirtySize());
+    }
+    if(_front_dirty){
+        memset(_front_dirty, 0xFF, getDirtySize());
+    }
+    autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::flush(){
+    // si show() no se acepta (envío o intercambio pendiente), los leds siguen marcados para el siguiente flush
+    if(_refresh == OneShot || _mode == DoubleBuffer){
+        show();
+        return;
+    }
+    if(_mode == SingleBuffer){
+        commit();
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::storeHires(uint16_t led, const Color16_t& color){
+    uint32_t mask = (1u << (led & 31));
+    bool was_hires = ((_hires_map[led >> 5] & mask) != 0);
+    _hires[led] = color;
+    _hires_map[led >> 5] |= mask;
+    uint16_t red = level16(color.red);
+    uint16_t green = level16(color.green);
+    uint16_t blue = level16(color.blue);
+    if(((red | green | blue) & 0xFF) == 0){
+        // nivel entero: se fija una única vez y no tiene coste en los siguientes frames
+        _frac_map[led >> 5] &= ~mask;
+        Color_t out = {(uint8_t)(red >> 8), (uint8_t)(green >> 8), (uint8_t)(blue >> 8)};
+        if(!was_hires || !sameColor(_pixels[led], out)){
+            _pixels[led] = out;
+            markDirty(led);
+        }
+        return;
+    }
+    // al entrar en dithering el error parte de media unidad (redondeo al más próximo en el primer frame)
+    if((_frac_map[led >> 5] & mask) == 0){
+        _frac_map[led >> 5] |= mask;
+        _dither_err[led].red = 0x80;
+        _dither_err[led].green = 0x80;
+        _dither_err[led].blue = 0x80;
+    }
+    if(!was_hires){
+        markDirty(led);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::ditherStep(){
+    for(uint16_t w = 0; w < getDirtySize()/sizeof(uint32_t); w++){
+        uint32_t bits = _frac_map[w];
+        for(uint16_t led = (w << 5); bits != 0 && led < _num_leds; led++, bits >>= 1){
+            if((bits & 1) != 0){
+                ditherPixel(led);
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::ditherPixel(uint16_t led){
+    const Color16_t& color = _hires[led];
+    Color_t& err = _dither_err[led];
+    Color_t out;
+    out.red = ditherLevel(level16(color.red), err.red);
+    out.green = ditherLevel(level16(color.green), err.green);
+    out.blue = ditherLevel(level16(color.blue), err.blue);
+    if(!sameColor(_pixels[led], out)){
+        _pixels[led] = out;
+        markDirty(led);
+    }
+}
+
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::fillStream(uint8_t* dst){
+    uint32_t t0 = WS281xCycles::now();
+    uint32_t ledsize = _led_size;
+    uint32_t slots = _reset_slots + _num_leds;
+    uint8_t half = (dst == _color_buffer)? 0x01 : 0x02;
+    _frame_ends &= ~half;
+    for(uint16_t i = 0; i < _stream_leds; i++, dst += ledsize){
+        if(_stream_slot < _reset_slots){
+            memset(dst, ResetTimeValue, ledsize);
+        }
+        else if(_pixels){
+            encodeAt(dst, _pixels[_stream_slot - _reset_slots]);
+        }
+        else if(_indices && _palette){
+            // modo Palette: el color se resuelve al codificar, por lo que un cambio de paleta es inmediato
+            encodeAt(dst, _palette[_indices[_stream_slot - _reset_slots]]);
+        }
+        else{
+            memset(dst, ResetTimeValue, ledsize);
+        }
+        if(++_stream_slot >= slots){
+            _stream_slot = 0;
+            _frame_ends |= half;
+        }
+    }
+    addStat(_encode_acc, WS281xCycles::now() - t0);
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::onDmaHalf(){
+    if(isStreaming()){
+        // la mitad enviada contenía el último led de un frame
+        if(_frame_ends & 0x01){
+            frameDone();
+        }
+        fillStream(_color_buffer);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::onDmaCplt(){
+    // DMA_PwmOut ya ha dejado la salida a nivel bajo
+    if(_refresh == OneShot){
+        _sending = false;
+        frameDone();
+        return;
+    }
+    if(isStreaming()){
+        if(_frame_ends & 0x02){
+            frameDone();
+        }
+        fillStream(&_color_buffer[_stream_leds * _led_size]);
+        return;
+    }
+    // la dma acaba de volver al inicio del buffer (tiempo de reset), se reapunta al buffer trasero
+    if(_mode == DoubleBuffer && _swap_pending){
+        swapBuffers();
+        if(_spi){
+            _spi->dmaSetBuffer(_front_buffer);
+        }
+        else{
+            _pwm->dmaSetBuffer(_front_buffer);
+        }
+        _swap_pending = false;
+    }
+    frameDone();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::onDmaError(){
+    _sending = false;
+    addStat(_stats.dma_errors, 1);
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::onSpiError(DMA_SPI::ErrorResult){
+    _spi_error = true;
+    onDmaError();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::frameDone(){
+    // la codificación acumulada desde el frame anterior se atribuye a este. Una ISR de mayor prioridad (efectos,
+    // planificador) puede estar sumando a _encode_acc, por lo que se consume en sección crítica
+    core_util_critical_section_enter();
+    _stats.frames++;
+    _stats.encode_last = _encode_acc;
+    _stats.encode_total += _encode_acc;
+    if(_encode_acc > _stats.encode_max){
+        _stats.encode_max = _encode_acc;
+    }
+    _encode_acc = 0;
+    core_util_critical_section_exit();
+    _frameCb.call();
+    if(!_sched){
+        return;
+    }
+    // en OneShot el siguiente frame se renderiza ya y lo envía el ticker
+    if(_refresh == OneShot){
+        _renderCb.call();
+        _frame_ready = true;
+        return;
+    }
+    if(++_frame_cnt >= _frame_div){
+        _frame_cnt = 0;
+        uint32_t t0 = WS281xCycles::now();
+        _renderCb.call();
+        flush();
+        if((WS281xCycles::now() - t0) > _frame_budget){
+            addStat(_stats.missed, 1);
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xLedStrip::onFrameTick(){
+    // si el frame anterior aún se está enviando, se reintenta en el siguiente tick y este se pierde
+    if(_frame_ready && show()){
+        _frame_ready = false;
+        return;
     }
+    addStat(_stats.missed, 1);
 }
 
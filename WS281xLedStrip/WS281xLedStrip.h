@@ -4,18 +4,92 @@
  *  Created on: Oct 2017
  *      Author: raulMrello
  *
- *  WS281xLedStrip es un mdulo C++ que gestiona la iluminacin de un array de Leds direccionables tipo WS2811, WS2812...
- *  El mdulo permite operaciones de alto nivel como degradados, fundidos, propagaciones de color, grupos, etc...
+ *  WS281xLedStrip es un módulo C++ que gestiona la iluminación de un array de Leds direccionables tipo WS2811, WS2812...
+ *  El módulo permite operaciones de alto nivel como degradados, fundidos, propagaciones de color, grupos, etc...
+ *  mediante el motor de efectos WS281xEffects.
  *
  *  La velocidad del puerto es de 800Kbps con lo que se requiere el uso del driver DMA_PwmOut para dar soporte a la alta
- *  velocidad de actuacin.
+ *  velocidad de actuación.
  *
- *  El protocolo establece un tiempo de reset de >50us y despus se envan datos en formato 24bit para cada led, con esta
+ *  El protocolo establece un tiempo de reset de >50us y después se envían datos en formato 24bit para cada led, con esta
  *  estructura: g7g6..g1g0r7r6..r1r0b7b6...b1b0 siendo el MSB el primer bit enviado.
  *                                                         ____
- *  Los bits a 0 se codifican como una seal de este tipo /    \________ donde el tON=400ns(32%) y tOFF=850ns(68%)
+ *  Los bits a 0 se codifican como una señal de este tipo /    \________ donde el tON=400ns(32%) y tOFF=850ns(68%)
  *                                                         ________
- *  Los bits a 1 se codifican como una seal de este tipo /        \____ donde el tON=800ns(64%) y tOFF=450ns(36%)
+ *  Los bits a 1 se codifican como una señal de este tipo /        \____ donde el tON=800ns(64%) y tOFF=450ns(36%)
+ *
+ *  Cada bit ocupa un elemento del buffer dma, cuyo ancho (8, 16 o 32 bits) se selecciona en el constructor. A 800KHz
+ *  con SystemCoreClock=80MHz el periodo es de 100 ticks, por lo que con DutyWidth8 cada led ocupa 24 bytes en lugar
+ *  de 96.
+ *
+ *  Backend SPI (constructor con DMA_SPI): como alternativa al timer, cada bit WS281x se codifica como un símbolo de
+ *  3 bits spi (100 / 110) o de 4 bits (1000 / 1100) que se envían por MOSI con DMA_SPI, por lo que cada led ocupa 9
+ *  o 12 bytes y TIM1 queda libre. Con SPI1 a 2.5MHz (80MHz/32), un bit a 0 tiene tON=400ns y un bit a 1 tON=800ns,
+ *  con periodos de 1.2us (3 bits) o 1.6us (4 bits). El API, los modos de buffer y de refresco son los mismos; la
+ *  dma de transmisión es circular en Continuous y de un único envío en OneShot. No admite formatos de pixel
+ *  (WS281xPixelFormat.h) ni arranque en fase con WS281xMultiStrip. El transporte (canal DMA_PwmOut propio o bus 
+ *  DMA_SPI externo) es un miembro de la tira, por lo que su API de timer y dma no forma parte de la de la tira.
+ *
+ *  Modos de buffer (BufferMode):
+ *  - SingleBuffer: toda la tira se codifica en un único buffer dma que se envía de forma circular.
+ *  - Streaming: se mantiene un framebuffer RGB de 3 bytes por led y un buffer dma circular de 2 x stream_leds leds
+ *    que se rellena por mitades desde las interrupciones half/complete de la DMA. La RAM del buffer dma deja de
+ *    depender de la longitud de la tira. El tiempo de reset se redondea a un número entero de leds.
+ *  - DoubleBuffer: dos buffers dma completos. setRange escribe en el buffer trasero y show() solicita el intercambio,
+ *    que se realiza en la interrupción de fin de buffer (justo al inicio del tiempo de reset) reapuntando la DMA al
+ *    buffer trasero, sin copias ni bloqueos. No debe modificarse la tira hasta que isSwapPending() devuelva false.
+ *
+ *  - Palette: igual que Streaming, pero el framebuffer es de 1 byte por led con índices a una paleta de 256 colores,
+ *    que se resuelven al codificar. Cambiar una entrada de la paleta recolorea todos los leds con ese índice en el
+ *    siguiente frame sin tocar los índices. Los leds se modifican con setIndexRange/setIndices; los métodos con
+ *    colores RGB (setRange, setPixels...) no tienen efecto en este modo, y las vistas, efectos y reproductores
+ *    (WS281xSegment, WS281xMatrix, WS281xEffects, WS281xAnimPlayer) rechazan estas tiras.
+ *
+ *  En los modos SingleBuffer y DoubleBuffer se mantiene una copia RGB de la tira y un mapa de bits de leds modificados
+ *  por cada buffer dma. setRange sólo marca los leds cuyo color cambia realmente y commit() codifica únicamente esos
+ *  leds. En SingleBuffer setRange invoca commit() automáticamente; en DoubleBuffer lo hace show(), y el mapa de bits
+ *  propio de cada buffer permite poner al día el buffer trasero tras un intercambio sin copiar el frame anterior.
+ *
+ *  Modos de refresco (RefreshMode), en SingleBuffer y DoubleBuffer:
+ *  - Continuous: la DMA retransmite el buffer de forma circular (comportamiento por defecto).
+ *  - OneShot: cada show() codifica los cambios y envía un único frame seguido del tiempo de reset. Al terminar, la
+ *    salida queda a nivel bajo, la DMA y el timer quedan en reposo y se notifica la callback instalada con
+ *    attachFrameCb. En SingleBuffer setRange ya no codifica automáticamente, se hace en show().
+ *
+ *  Antes de codificarse, cada componente de color pasa por una tabla de niveles de 256 entradas que combina la
+ *  corrección gamma (tablas WS281xGamma generadas en compilación) y el brillo global. Cambiar el brillo o la gamma
+ *  sólo recalcula esa tabla; los colores almacenados no se modifican.
+ *
+ *  Sincronización de frames: la callback instalada con attachFrameCb se invoca desde la interrupción dma cada vez
+ *  que un frame completo ha salido por la línea, en cualquier modo (en Streaming con la granularidad de media 
+ *  ventana). startScheduler añade un planificador a frecuencia fija que invoca una callback de render justo tras
+ *  cada frame, de forma que el render del siguiente frame se solapa con la transmisión:
+ *  - Continuous: el reloj es la propia DMA. Cada N frames (N = getFrameRate()/fps) se invoca el render y a
+ *    continuación flush(); en DoubleBuffer el nuevo frame se intercambia en el siguiente fin de buffer.
+ *  - OneShot: un Ticker a la frecuencia solicitada envía el último frame renderizado y, al terminar su envío, se
+ *    invoca el render del siguiente.
+ *  El render se ejecuta en contexto ISR, igual que los efectos de WS281xEffects.
+ *
+ *  Instrumentación: getStats() devuelve una copia coherente de los contadores del pipeline (leds codificados, frames
+ *  enviados, errores dma y frames perdidos por el planificador) y del tiempo de codificación por frame, medido con
+ *  WS281xCycles (DWT en el target). commit() y el relleno del anillo en Streaming acumulan sus ciclos, que se 
+ *  atribuyen al frame cuyo fin notifica la dma a continuación. Un frame se considera perdido si en OneShot el tick
+ *  del planificador llega con el frame anterior aún en envío, o si en Continuous el render y su codificación duran
+ *  más que el periodo del planificador. Comparando encode_last con el periodo de frame se distingue si el cuello
+ *  de botella es el render/codificación o la transmisión.
+ *
+ *  Dithering temporal (SingleBuffer y DoubleBuffer, tras enableDithering): setRange16/setPixels16 definen colores de
+ *  16 bits por componente (8 bits enteros y 8 de fracción). El nivel de salida se obtiene interpolando la tabla de
+ *  niveles con la fracción, y cada commit() (un frame) redondea ese nivel a 8 bits acumulando el error del frame
+ *  anterior, de forma que la media temporal reproduce el nivel exacto. Sólo los leds cuyo nivel de salida tiene
+ *  fracción se recalculan en cada commit(), y el codificador sólo recodifica los que cambian de valor. En 
+ *  Continuous la aplicación debe invocar commit() (o flush) a la cadencia de frames deseada.
+ *
+ *  Concurrencia: commit() (y setRange, setPixels, flush... que lo invocan) puede ejecutarse en contexto ISR (efectos
+ *  de WS281xEffects, render del planificador) mientras la aplicación modifica otros leds de la misma tira. El mapa
+ *  de leds pendientes se marca y se consume en secciones críticas de una palabra, por lo que ningún cambio se pierde
+ *  y las interrupciones sólo se bloquean durante unos pocos ciclos, nunca durante la codificación. Cada led debe
+ *  modificarse desde un único contexto, y el dithering no admite commits concurrentes.
  *
  */
  
@@ -26,6 +100,11 @@
  
 #include "mbed.h"
 #include "DMA_PwmOut.h"
+#include "DMA_SPI.h"
+#include "WS281xGamma.h"
+#include "WS281xColor.h"
+#include "WS281xBitCodec.h"
+#include "WS281xCycles.h"
 #include "Heap.h"
 
 //------------------------------------------------------------------------------------
@@ -33,72 +112,786 @@
 //------------------------------------------------------------------------------------
 
 
-class WS281xLedStrip : public DMA_PwmOut {
+class WS281xLedStrip {
+    friend class WS281xMultiStrip;
   public:
 	
     /** @struct Color_t
-     *  @brief Definicin de un color RGB de 24-bit
+     *  @brief Definición de un color RGB de 24-bit
      */
     struct Color_t{
         uint8_t red;
         uint8_t green;
         uint8_t blue;
     };
+	
+    /** Color HSV de 24-bit (ver WS281xColor) */
+    typedef WS281xColor::Hsv_t Hsv_t;
+
+    /** @struct Color16_t
+     *  @brief Color de 16 bits por componente (8.8: el byte alto es el nivel de 8 bits y el bajo su fracción)
+     */
+    struct Color16_t{
+        uint16_t red;
+        uint16_t green;
+        uint16_t blue;
+    };
+
+    /** Modo de gestión del buffer dma */
+    enum BufferMode{
+        SingleBuffer,
+        Streaming,
+        DoubleBuffer,
+        Palette,
+    };
+
+    static const uint16_t PaletteSize = 256;    /// Colores de la paleta en modo Palette
+
+    /** Modo de refresco de la tira */
+    enum RefreshMode{
+        Continuous,
+        OneShot,
+    };
+
+    /** Bits spi por cada bit WS281x (backend SPI) */
+    enum SpiSymbol{
+        SpiSymbol3 = 3,
+        SpiSymbol4 = 4,
+    };
+
+    static const uint16_t DefaultStreamLeds = 8;    /// Leds por cada mitad del buffer dma en modo Streaming
+
+    /** @struct Stats_t
+     *  @brief Contadores del pipeline. Los tiempos están en ciclos de WS281xCycles (ver WS281xCycles::toUs)
+     */
+    struct Stats_t{
+        uint32_t encoded;       /// Leds codificados en el buffer dma
+        uint32_t skipped;       /// Leds descartados por no cambiar de color
+        uint32_t frames;        /// Frames enviados (fin de frame notificado por la dma)
+        uint32_t encode_last;   /// Ciclos de codificación atribuidos al último frame enviado
+        uint32_t encode_max;    /// Ciclos máximos de codificación de un frame
+        uint64_t encode_total;  /// Ciclos de codificación acumulados (media por frame = encode_total / frames)
+        uint32_t dma_errors;    /// Errores al iniciar una transferencia dma o notificados por ella
+        uint32_t missed;        /// Frames del planificador que no se han enviado a tiempo
+    };
 
 	
     /** @fn WS281xLedStrip()
-     *  @brief Constructor, que asocia un manejador DMA_PwmOut y un n de leds
+     *  @brief Constructor, que crea un canal DMA_PwmOut propio en el pin y asocia un nº de leds
      *  @param pin Pin de salida
      *  @param hz Frecuencia del ciclo pwm
-     *  @param num_leds Nmero de leds en la tira
+     *  @param num_leds Número de leds en la tira
+     *  @param width Ancho de cada elemento del buffer dma (por defecto 32 bits)
+     *  @param mode Modo de gestión del buffer dma
+     *  @param stream_leds Leds codificados en cada mitad del buffer dma (sólo en modos Streaming y Palette)
+     */
+    WS281xLedStrip(PinName pin, uint32_t hz, uint16_t num_leds, DMA_PwmOut::DutyWidth width = DMA_PwmOut::DutyWidth32, 
+                   BufferMode mode = SingleBuffer, uint16_t stream_leds = DefaultStreamLeds);
+
+	
+    /** @fn WS281xLedStrip()
+     *  @brief Constructor con backend SPI: la tira se conecta a MOSI y los bits se envían como símbolos spi
+     *  @param spi Bus spi con dma, ya configurado a la frecuencia spi_hz (el resto de su configuración es la por defecto)
+     *  @param spi_hz Frecuencia del bus spi (p.ej. 2500000)
+     *  @param num_leds Número de leds en la tira
+     *  @param symbol Bits spi por bit WS281x
+     *  @param mode Modo de gestión del buffer dma
+     *  @param stream_leds Leds codificados en cada mitad del buffer dma (sólo en modos Streaming y Palette)
      */
-    WS281xLedStrip(PinName pin, uint32_t hz, uint16_t num_leds);
+    WS281xLedStrip(DMA_SPI* spi, uint32_t spi_hz, uint16_t num_leds, SpiSymbol symbol = SpiSymbol3, 
+                   BufferMode mode = SingleBuffer, uint16_t stream_leds = DefaultStreamLeds);
 
 	
     /** @fn ~WS281xLedStrip()
-     *  @brief Destructor por defecto
+     *  @brief Destructor, que libera el canal DMA_PwmOut propio (el bus DMA_SPI es externo)
      */
-    virtual ~WS281xLedStrip(){}
+    virtual ~WS281xLedStrip();
 
 	
     /** @fn start()
-     *  @brief Inicia la salida va dma
+     *  @brief Inicia la salida vía dma. En modo OneShot envía un único frame, igual que show()
      */
-    void start() { DMA_PwmOut::dmaStart(_color_buffer, _buffer_size/sizeof(uint32_t)); }
+    void start();
 
 	
     /** @fn stop()
-     *  @brief Detiene la salida va dma
+     *  @brief Detiene la salida vía dma y el planificador de frames
      */
-    void stop() { DMA_PwmOut::dmaStop(); }
+    void stop();
+
+	
+    /** @fn setRefreshMode()
+     *  @brief Selecciona el refresco continuo o por frames (show). Debe invocarse con la salida detenida
+     *  @param mode Modo de refresco
+     *  @return True si se acepta, False si el modo de buffer no lo permite (Streaming y Palette sólo admiten Continuous)
+     */
+    bool setRefreshMode(RefreshMode mode);
+
+	
+    /** @fn getRefreshMode()
+     *  @brief Obtiene el modo de refresco
+     *  @return Modo de refresco
+     */
+    RefreshMode getRefreshMode() { return _refresh; }
+
+	
+    /** @fn getBufferMode()
+     *  @brief Obtiene el modo de buffer
+     *  @return Modo de buffer
+     */
+    BufferMode getBufferMode() { return _mode; }
+
+	
+    /** @fn attachFrameCb()
+     *  @brief Instala la callback de fin de envío de un frame (contexto ISR)
+     *  @param frame_cb Callback a invocar
+     */
+    void attachFrameCb(Callback<void()> frame_cb) { _frameCb = frame_cb; }
+
+	
+    /** @fn startScheduler()
+     *  @brief Inicia el planificador de frames a frecuencia fija. Debe invocarse con la salida en marcha en 
+     *         Continuous; en OneShot el propio planificador envía los frames
+     *  @param fps Frames por segundo (en Continuous se redondea a un divisor de getFrameRate())
+     *  @param render_cb Callback de render, invocada tras cada frame enviado (contexto ISR)
+     *  @return True si se inicia, False si fps es 0
+     */
+    bool startScheduler(uint16_t fps, Callback<void()> render_cb);
+
+	
+    /** @fn stopScheduler()
+     *  @brief Detiene el planificador de frames
+     */
+    void stopScheduler();
+
+	
+    /** @fn getFrameRate()
+     *  @brief Obtiene los frames por segundo que transmite la DMA en modo Continuous
+     */
+    uint32_t getFrameRate();
+
+	
+    /** @fn isSending()
+     *  @brief Indica si hay un frame en envío (modo OneShot)
+     *  @return True hasta que finaliza el envío del frame
+     */
+    bool isSending() { return _sending; }
 
 	
     /** @fn setRange()
      *  @brief Establece el color de un rango de leds
-     *  @param from Led desde el que se cambiar el color (incluido 0)
-     *  @param to Led hasta el que se cambiar el color (incluido _num_leds-1)
+     *  @param from Led desde el que se cambiará el color (incluido 0)
+     *  @param to Led hasta el que se cambiará el color (incluido _num_leds-1)
      *  @param color Referencia al color a cambiar
      */
     void setRange(uint16_t from, uint16_t to, const Color_t& color);
+
+	
+    /** @fn setPixels()
+     *  @brief Copia un bloque de colores consecutivos en la tira (p.ej. un frame renderizado o decodificado)
+     *  @param offset Primer led a modificar
+     *  @param src Colores de origen
+     *  @param n Número de leds a copiar (se recorta al final de la tira)
+     */
+    void setPixels(uint16_t offset, const Color_t* src, uint16_t n);
+
+	
+    /** @fn fillPattern()
+     *  @brief Rellena un bloque de leds repitiendo un patrón de colores
+     *  @param offset Primer led a modificar
+     *  @param pattern Patrón de colores
+     *  @param patlen Número de colores del patrón
+     *  @param n Número de leds a rellenar (se recorta al final de la tira)
+     */
+    void fillPattern(uint16_t offset, const Color_t* pattern, uint16_t patlen, uint16_t n);
+
+	
+    /** @fn setPixelsHSV()
+     *  @brief Convierte a RGB y copia un bloque de colores HSV consecutivos (ver hsvToRgb)
+     *  @param offset Primer led a modificar
+     *  @param src Colores HSV de origen
+     *  @param n Número de leds a copiar (se recorta al final de la tira)
+     */
+    void setPixelsHSV(uint16_t offset, const Hsv_t* src, uint16_t n);
+
+	
+    /** @fn enableDithering()
+     *  @brief Reserva los buffers de dithering temporal (6 bytes de color, 3 de error y 2 bits por led)
+     *  @return True si se activa, False en los modos Streaming y Palette o si no hay memoria
+     */
+    bool enableDithering();
+
+	
+    /** @fn setRange16()
+     *  @brief Cambia el color de 16 bits por componente de un rango de leds (requiere enableDithering)
+     *  @param from Led desde el que se cambiará el color (incluido)
+     *  @param to Led hasta el que se cambiará el color (excluido)
+     *  @param color Color 8.8
+     */
+    void setRange16(uint16_t from, uint16_t to, const Color16_t& color);
+
+	
+    /** @fn setPixels16()
+     *  @brief Copia un bloque de colores de 16 bits por componente (requiere enableDithering)
+     *  @param offset Primer led a modificar
+     *  @param src Colores 8.8 de origen
+     *  @param n Número de leds a copiar (se recorta al final de la tira)
+     */
+    void setPixels16(uint16_t offset, const Color16_t* src, uint16_t n);
+
+	
+    /** @fn hsvToRgb()
+     *  @brief Convierte un color HSV a RGB con aritmética entera, sin divisiones (ver WS281xColor::hsvToRgb)
+     *  @param hsv Color HSV
+     *  @param rgb Color RGB resultante
+     */
+    static inline void hsvToRgb(const Hsv_t& hsv, Color_t& rgb){
+        WS281xColor::hsvToRgb(hsv, rgb);
+    }
+
+	
+    /** @fn setIndexRange()
+     *  @brief Asigna un índice de la paleta a un rango de leds (modo Palette)
+     *  @param from Led desde el que se cambiará el índice (incluido)
+     *  @param to Led hasta el que se cambiará el índice (excluido)
+     *  @param index Índice de la paleta
+     */
+    void setIndexRange(uint16_t from, uint16_t to, uint8_t index);
+
+	
+    /** @fn setIndices()
+     *  @brief Copia un bloque de índices de la paleta consecutivos (modo Palette)
+     *  @param offset Primer led a modificar
+     *  @param src Índices de origen
+     *  @param n Número de leds a copiar (se recorta al final de la tira)
+     */
+    void setIndices(uint16_t offset, const uint8_t* src, uint16_t n);
+
+	
+    /** @fn setPaletteEntry()
+     *  @brief Cambia un color de la paleta, lo que recolorea todos los leds que lo usan (modo Palette)
+     *  @param index Índice de la paleta
+     *  @param color Nuevo color
+     */
+    void setPaletteEntry(uint8_t index, const Color_t& color);
+
+	
+    /** @fn setPalette()
+     *  @brief Carga un bloque de colores consecutivos de la paleta (modo Palette)
+     *  @param first Primer índice a cargar
+     *  @param colors Colores de origen
+     *  @param count Número de colores (se recorta al final de la paleta)
+     */
+    void setPalette(uint8_t first, const Color_t* colors, uint16_t count);
+
+	
+    /** @fn commit()
+     *  @brief Codifica en el buffer dma (trasero en modo DoubleBuffer) los leds modificados desde el último commit.
+     *         Puede invocarse desde contexto ISR y desde la aplicación sobre leds distintos (ver Concurrencia)
+     *  @return Número de leds codificados
+     */
+    uint16_t commit();
+
+	
+    /** @fn putPixel()
+     *  @brief Actualiza un led sin codificarlo, en cualquier modo de buffer. Es la escritura de las vistas y 
+     *         efectos (WS281xSegment, WS281xMatrix, WS281xEffects...), que publican varios leds de una vez con 
+     *         flush() o autoCommit(). Los leds fuera de la tira se ignoran
+     *  @param led Led a modificar
+     *  @param color Nuevo color
+     */
+    inline void putPixel(uint16_t led, const Color_t& color){
+        if(led >= _num_leds){
+            return;
+        }
+        if(_dirty){
+            if(!storePixel(led, color)){
+                addStat(_stats.skipped, 1);
+            }
+            return;
+        }
+        if(_pixels){
+            _pixels[led] = color;
+        }
+    }
+
+	
+    /** @fn flush()
+     *  @brief Publica los cambios realizados con putPixel según el modo: commit en SingleBuffer, show en 
+     *         DoubleBuffer u OneShot. En Streaming no es necesario
+     */
+    void flush();
+
+	
+    /** @fn autoCommit()
+     *  @brief Codifica los cambios sólo si el modo lo hace tras cada escritura (SingleBuffer y Continuous), con la 
+     *         misma semántica que setRange. En el resto de modos la publicación queda para show() o flush()
+     */
+    inline void autoCommit(){
+        if(_mode == SingleBuffer && _refresh == Continuous){
+            commit();
+        }
+    }
+
+	
+    /** @fn show()
+     *  @brief Codifica los cambios pendientes y solicita que el buffer trasero pase a enviarse en el siguiente 
+     *         tiempo de reset (modo DoubleBuffer). En modo OneShot, codifica y envía un único frame
+     *  @return True si se acepta la solicitud, False si hay un intercambio o un envío pendiente, o el modo no 
+     *         es DoubleBuffer ni OneShot
+     */
+    bool show();
+
+	
+    /** @fn isSwapPending()
+     *  @brief Indica si hay un intercambio de buffers pendiente (modo DoubleBuffer)
+     *  @return True mientras el buffer trasero siga pendiente de enviarse
+     */
+    bool isSwapPending() { return _swap_pending; }
+
+	
+    /** @fn setGamma()
+     *  @brief Establece la tabla de corrección gamma y recodifica la tira
+     *  @param table Tabla de 256 entradas (p.ej. WS281xGamma<22>::table) o 0 para desactivar la corrección
+     */
+    void setGamma(const uint8_t* table);
+
+	
+    /** @fn setGamma()
+     *  @brief Establece la corrección gamma con un exponente en décimas, resuelto en tiempo de compilación
+     */
+    template <int GammaX10> void setGamma() { setGamma(WS281xGamma<GammaX10>::table); }
+
+	
+    /** @fn setBrightness()
+     *  @brief Establece el brillo global y recodifica la tira
+     *  @param level Brillo 0 (apagado) ... 255 (máximo)
+     */
+    void setBrightness(uint8_t level);
+
+	
+    /** @fn getBrightness()
+     *  @brief Obtiene el brillo global
+     *  @return Brillo 0...255
+     */
+    uint8_t getBrightness() { return _brightness; }
+
+	
+    /** @fn getNumLeds()
+     *  @brief Obtiene el número de leds de la tira
+     *  @return Número de leds
+     */
+    uint16_t getNumLeds() { return _num_leds; }
+
+	
+    /** @fn getBufferSize()
+     *  @brief Obtiene el tamaño del buffer dma reservado
+     *  @return Tamaño en bytes
+     */
+    uint32_t getBufferSize() { return _buffer_size; }
+
+	
+    /** @fn getDutyWidth()
+     *  @brief Obtiene el ancho de cada elemento del buffer dma, elegido por DMA_PwmOut según el periodo del pwm
+     *  @return Ancho en bytes (1, 2 o 4; 1 en el backend SPI)
+     */
+    DMA_PwmOut::DutyWidth getDutyWidth() { return _width; }
+
+	
+    /** @fn getMemorySaved()
+     *  @brief Obtiene la memoria ahorrada respecto de un buffer dma de 32 bits por elemento, incluyendo el
+     *         framebuffer RGB en modo Streaming
+     *  @return Bytes ahorrados
+     */
+    uint32_t getMemorySaved();
+
+	
+    /** @fn getStats()
+     *  @brief Copia los contadores del pipeline en una sección crítica, de forma que son coherentes entre sí
+     *  @param snapshot Copia de los contadores
+     */
+    void getStats(Stats_t& snapshot);
+
+	
+    /** @fn resetStats()
+     *  @brief Reinicia los contadores del pipeline
+     */
+    void resetStats();
     
         
   protected:       
+	
+    /** @fn WS281xLedStrip()
+     *  @brief Constructor para formatos de pixel distintos de GRB 24 bits (ver WS281xPixelFormat.h)
+     *  @param led_bits Bits por led
+     *  @param reset_bits Bits del tiempo de reset
+     *  @param low_percent Duty de un bit a 0
+     *  @param high_percent Duty de un bit a 1
+     */
+    WS281xLedStrip(PinName pin, uint32_t hz, uint16_t num_leds, DMA_PwmOut::DutyWidth width, BufferMode mode, uint16_t stream_leds,
+                   uint8_t led_bits, uint16_t reset_bits, uint8_t low_percent, uint8_t high_percent);
+
     static const uint32_t ResetTimeValue = 0;   /// Valor del tiempo de reset.
-    static const uint8_t ResetTimeBits = 50;    /// Tiempo de reset >50us. Como cada ciclo es de 1.25us. Asignado 50 = 62.5us
-    static const uint8_t ColorBits = 24;        /// Nmero de bits a enviar por color R, G, B
-    uint16_t _num_leds;                         /// Nmero de leds de la tira
-    uint32_t _buffer_size;                      /// Tamao del buffer reservado
-    uint32_t * _color_buffer;                   /// Buffer para envo de colores
+    static const uint16_t ResetTimeBits = 50;   /// Tiempo de reset >50us. Como cada ciclo es de 1.25us. Asignado 50 = 62.5us
+    static const uint8_t ColorBits = 24;        /// Número de bits a enviar por color R, G, B
+    static const uint8_t BitLowPercent = 32;    /// Duty de un bit a 0 (tON=400ns)
+    static const uint8_t BitHighPercent = 64;   /// Duty de un bit a 1 (tON=800ns)
+    static const uint8_t IdleBits = 1;          /// Elemento final a 0, que deja la línea a nivel bajo tras un envío OneShot
+
+    /** Codificador de un led en el buffer dma. Se elige una única vez según el backend, el formato de pixel y el 
+     *  ancho de elemento, de forma que el bucle de codificación no evalúa ninguno de ellos */
+    typedef void (WS281xLedStrip::*Encoder)(uint8_t* dst, const Color_t& color);
+
+    uint8_t _led_bits;                          /// Bits por led del formato de pixel (ColorBits por defecto)
+    uint16_t _reset_bits;                       /// Bits del tiempo de reset del formato de pixel (ResetTimeBits por defecto)
+    uint16_t _reset_slots;                      /// Leds equivalentes al reset (Streaming)
+    uint16_t _num_leds;                         /// Número de leds de la tira
+    BufferMode _mode;                           /// Modo de gestión del buffer dma
+    RefreshMode _refresh;                       /// Modo de refresco
+    volatile bool _sending;                     /// Frame en envío (modo OneShot)
+    Callback<void()> _frameCb;                  /// Callback de fin de envío de frame
+    Callback<void()> _renderCb;                 /// Callback de render del planificador
+    Ticker _frameTick;                          /// Ticker del planificador (modo OneShot)
+    volatile bool _sched;                       /// Planificador en marcha
+    volatile bool _frame_ready;                 /// Frame renderizado pendiente de enviar (planificador en OneShot)
+    uint16_t _frame_div;                        /// Frames dma por frame del planificador (Continuous)
+    uint16_t _frame_cnt;                        /// Frames dma desde el último render (Continuous)
+    uint32_t _hz;                               /// Frecuencia de bit
+    volatile uint8_t _frame_ends;               /// Mitades del anillo que contienen el final de un frame (Streaming)
+    Color_t * _pixels;                          /// Framebuffer RGB (copia de la tira en los modos con buffer completo)
+    uint8_t * _indices;                         /// Framebuffer de índices de la paleta (modo Palette)
+    Color_t * _palette;                         /// Paleta de PaletteSize colores (modo Palette)
+    Color16_t * _hires;                         /// Colores 8.8 de los leds con dithering
+    Color_t * _dither_err;                      /// Fracción acumulada de cada componente de los leds con dithering
+    uint32_t * _hires_map;                      /// Mapa de bits de leds con dithering (su copia RGB ya es nivel de salida)
+    uint32_t * _frac_map;                       /// Mapa de bits de leds con nivel de salida fraccionario
+    uint32_t * _dirty;                          /// Mapa de bits de leds pendientes de codificar en _color_buffer
+    uint32_t * _front_dirty;                    /// Mapa de bits de leds pendientes de codificar en _front_buffer
+    Stats_t _stats;                             /// Contadores del pipeline
+    uint32_t _encode_acc;                       /// Ciclos de codificación desde el último fin de frame
+    uint32_t _frame_budget;                     /// Ciclos del periodo del planificador
+    uint16_t _stream_leds;                      /// Leds por mitad del buffer dma (modo Streaming)
+    uint32_t _stream_slot;                      /// Siguiente posición a codificar: [0.._reset_slots) reset, resto leds
+    Callback<void()> _dmaHalfCb;                /// Callback de mitad de buffer dma (modo Streaming)
+    Callback<void()> _dmaCpltCb;                /// Callback de fin de buffer dma (modo Streaming)
+    uint32_t _buffer_size;                      /// Tamaño del buffer reservado
+    uint8_t * _color_buffer;                    /// Buffer para envío de colores (elementos de _width bytes)
+    uint8_t * _front_buffer;                    /// Buffer en envío por la DMA (modo DoubleBuffer)
+    volatile bool _swap_pending;                /// Intercambio de buffers solicitado por show()
+    DMA_PwmOut * _pwm;                          /// Canal pwm propio del backend timer (0 en el backend SPI)
+    DMA_SPI * _spi;                             /// Bus del backend SPI (0 en el backend timer)
+    DMA_PwmOut::DutyWidth _width;               /// Ancho de los elementos del buffer dma (1 byte en el backend SPI)
+    uint8_t   _symbol_bits;                     /// Bits spi por bit WS281x (backend SPI)
+    uint16_t  _spi_nibble[16];                  /// Tabla nibble->símbolos spi (4 x _symbol_bits bits, MSB primero)
+    Callback<void(DMA_SPI::ErrorResult)> _dmaErrCb; /// Callback de error de la dma spi
+    volatile bool _spi_error;                   /// Error en el último envío spi
+    uint32_t  _led_size;                        /// Bytes de cada led en el buffer dma
+    uint32_t  _reset_size;                      /// Bytes del tiempo de reset al inicio del buffer dma
     uint32_t  _bitLow;                          /// Valor para enviar un bit a 0
     uint32_t  _bitHigh;                         /// Valor para enviar un bit a 1
+    const uint8_t* _gamma;                      /// Tabla de corrección gamma (0 = lineal)
+    uint8_t   _brightness;                      /// Brillo global
+    uint8_t   _level_lut[256];                  /// Tabla de niveles: gamma y brillo aplicados a cada componente
+    const uint8_t* _lut;                        /// Tabla aplicada al codificar: _level_lut, o identidad con dithering
+    Encoder _encoder;                           /// Codificador de un led (encodeColor, encodeSpi o el del formato)
+    
+    /** Tabla nibble->duty (4 bits por entrada, MSB primero). Sólo es válida la vista del ancho del buffer dma */
+    union{
+        uint8_t  u8[16][4];
+        uint16_t u16[16][4];
+        uint32_t u32[16][4];
+    }_nibble_lut;
   
 	
+    /** @fn setup()
+     *  @brief Inicialización común a ambos backends: framebuffers, buffers dma y tabla de niveles. Requiere
+     *         _led_size, _reset_size y la tabla de codificación del backend
+     */
+    void setup(uint32_t hz, uint16_t num_leds, BufferMode mode, uint16_t stream_leds, uint8_t led_bits, uint16_t reset_bits);
+
+	
+    /** @fn startDma()
+     *  @brief Prepara el buffer dma según el modo e inicia la dma. En modo OneShot codifica los cambios pendientes
+     *         y envía un único frame
+     *  @param arm_only True para armar la dma sin habilitar el contador del timer (ver WS281xMultiStrip)
+     *  @return True si la dma se ha iniciado (o armado) correctamente
+     */
+    bool startDma(bool arm_only);
+
+	
+    /** @fn runDma()
+     *  @brief Inicia (o arma) la dma sobre un buffer con las callbacks que requiere el modo
+     *  @param buf Buffer dma a enviar
+     *  @param arm_only True para no habilitar el contador del timer
+     *  @return True si la dma se ha iniciado (o armado) correctamente
+     */
+    bool runDma(uint8_t* buf, bool arm_only);
+
+	
     /** @fn applyColor()
      *  @brief Establece el color de un led
      *  @param led Led al que cambiar el color
      *  @param color Referencia al color a cambiar
      */
     void applyColor(uint16_t led, const Color_t& color);  
+
+	
+    /** @fn updateLevels()
+     *  @brief Recalcula _level_lut y marca toda la tira para recodificarse
+     */
+    void updateLevels();
+
+	
+    /** @fn isStreaming()
+     *  @brief Indica si el buffer dma es un anillo codificado al vuelo (modos Streaming y Palette)
+     */
+    inline bool isStreaming() { return (_mode == Streaming || _mode == Palette); }
+
+	
+    /** @fn frameDone()
+     *  @brief Notifica el fin de un frame y avanza el planificador (contexto ISR)
+     */
+    void frameDone();
+
+	
+    /** @fn onFrameTick()
+     *  @brief Envía el último frame renderizado a la frecuencia del planificador (modo OneShot, contexto ISR)
+     */
+    void onFrameTick();
+
+	
+    /** @fn swapBuffers()
+     *  @brief Intercambia los buffers dma y sus mapas de bits (modo DoubleBuffer)
+     */
+    inline void swapBuffers(){
+        uint8_t* buf = _front_buffer;
+        uint32_t* dirty = _front_dirty;
+        _front_buffer = _color_buffer;
+        _front_dirty = _dirty;
+        _color_buffer = buf;
+        _dirty = dirty;
+    }
+
+	
+    /** @fn getDirtySize()
+     *  @brief Obtiene el tamaño de cada mapa de bits de leds modificados
+     *  @return Tamaño en bytes (múltiplo de 4)
+     */
+    inline uint32_t getDirtySize() { return ((_num_leds + 31) / 32) * sizeof(uint32_t); }
+
+	
+    /** @fn markDirty()
+     *  @brief Marca un led como pendiente de codificar en todos los buffers dma
+     *  @param led Led modificado
+     */
+    inline void markDirty(uint16_t led){
+        uint32_t mask = (1u << (led & 31));
+        // cada palabra agrupa 32 leds que pueden modificarse desde la aplicación y desde una ISR
+        core_util_critical_section_enter();
+        _dirty[led >> 5] |= mask;
+        if(_front_dirty){
+            _front_dirty[led >> 5] |= mask;
+        }
+        core_util_critical_section_exit();
+    }
+
+	
+    /** @fn storePixel()
+     *  @brief Actualiza un led de la copia RGB y lo marca como modificado si cambia de color (modos con mapa de bits)
+     *  @param led Led a modificar
+     *  @param color Nuevo color
+     *  @return False si el led no cambia y se descarta (el llamante lo contabiliza en skipped)
+     */
+    inline bool storePixel(uint16_t led, const Color_t& color){
+        // un led con dithering pasa a color de 8 bits: su copia RGB era nivel de salida y debe recodificarse
+        if(_hires_map && clearHires(led)){
+            _pixels[led] = color;
+            markDirty(led);
+            return true;
+        }
+        if(sameColor(_pixels[led], color)){
+            return false;
+        }
+        _pixels[led] = color;
+        markDirty(led);
+        return true;
+    }
+
+	
+    /** @fn addStat()
+     *  @brief Suma a un contador de Stats_t. Los contadores los actualizan tanto la aplicación como las ISR (dma, 
+     *         efectos, planificador), por lo que la suma se hace en sección crítica
+     *  @param counter Contador a actualizar
+     *  @param value Valor a sumar
+     */
+    inline void addStat(uint32_t& counter, uint32_t value){
+        core_util_critical_section_enter();
+        counter += value;
+        core_util_critical_section_exit();
+    }
+
+	
+    /** @fn clearHires()
+     *  @brief Elimina un led del dithering
+     *  @return True si el led tenía dithering
+     */
+    inline bool clearHires(uint16_t led){
+        uint32_t mask = (1u << (led & 31));
+        if((_hires_map[led >> 5] & mask) == 0){
+            return false;
+        }
+        _hires_map[led >> 5] &= ~mask;
+        _frac_map[led >> 5] &= ~mask;
+        return true;
+    }
+
+	
+    /** @fn isHires()
+     *  @brief Indica si un led tiene dithering (su copia RGB se codifica sin tabla de niveles)
+     */
+    inline bool isHires(uint16_t led){
+        return (_hires_map && (_hires_map[led >> 5] & (1u << (led & 31))) != 0);
+    }
+
+	
+    /** @fn storeHires()
+     *  @brief Actualiza el color 8.8 de un led. Si su nivel de salida es entero se fija ya en la copia RGB; si tiene
+     *         fracción lo resolverá ditherStep en cada commit
+     */
+    void storeHires(uint16_t led, const Color16_t& color);
+
+	
+    /** @fn ditherStep()
+     *  @brief Avanza un frame el dithering de los leds con nivel de salida fraccionario
+     */
+    void ditherStep();
+
+	
+    /** @fn ditherPixel()
+     *  @brief Redondea el nivel de salida de un led a 8 bits con el error acumulado y lo almacena si cambia
+     */
+    void ditherPixel(uint16_t led);
+
+	
+    /** @fn level16()
+     *  @brief Nivel de salida 8.8 de una componente 8.8, interpolando la tabla de niveles entre dos entradas
+     */
+    inline uint16_t level16(uint16_t value){
+        uint8_t i = value >> 8;
+        uint16_t base = (uint16_t)_level_lut[i] << 8;
+        if(i == 255 || _level_lut[i + 1] <= _level_lut[i]){
+            return base;
+        }
+        return base + ((_level_lut[i + 1] - _level_lut[i]) * (value & 0xFF));
+    }
+
+	
+    /** @fn ditherLevel()
+     *  @brief Redondea un nivel 8.8 a 8 bits sumando la fracción acumulada, que se actualiza con el nuevo error
+     */
+    static inline uint8_t ditherLevel(uint16_t level, uint8_t& err){
+        uint16_t acc = (uint16_t)err + (level & 0xFF);
+        err = (uint8_t)acc;
+        return (uint8_t)((level >> 8) + (acc >> 8));
+    }
+
+	
+    /** @fn sameColor()
+     *  @brief Compara dos colores
+     *  @return True si son iguales
+     */
+    static inline bool sameColor(const Color_t& a, const Color_t& b){
+        return (a.red == b.red && a.green == b.green && a.blue == b.blue);
+    }
+
+	
+    /** @fn encodeAt()
+     *  @brief Codifica un color en una posición del buffer dma con el codificador elegido en la construcción
+     *  @param dst Posición del buffer en la que escribir los _led_bits valores
+     *  @param color Referencia al color a codificar
+     */
+    inline void encodeAt(uint8_t* dst, const Color_t& color) { (this->*_encoder)(dst, color); }
+
+	
+    /** @fn setEncoder()
+     *  @brief Elige el codificador del ancho de elemento del buffer dma (backend timer). Los formatos de pixel de 
+     *         WS281xPixelFormat.h instalan el suyo desde su constructor, antes de la primera codificación
+     *  @param enc8 Codificador para elementos de 8 bits
+     *  @param enc16 Codificador para elementos de 16 bits
+     *  @param enc32 Codificador para elementos de 32 bits
+     */
+    inline void setEncoder(Encoder enc8, Encoder enc16, Encoder enc32){
+        _encoder = (_width == DMA_PwmOut::DutyWidth8)? enc8 : (_width == DMA_PwmOut::DutyWidth16)? enc16 : enc32;
+    }
+
+	
+    /** @fn fillStream()
+     *  @brief Codifica los siguientes _stream_leds leds (o slots de reset) del frame en una mitad del buffer dma
+     *  @param dst Mitad del buffer dma a rellenar
+     */
+    void fillStream(uint8_t* dst);  
+
+	
+    /** @fn onDmaHalf()
+     *  @brief Rellena la primera mitad del buffer dma, ya enviada (contexto ISR)
+     */
+    void onDmaHalf();  
+
+	
+    /** @fn onDmaCplt()
+     *  @brief Rellena la segunda mitad del buffer dma, ya enviada (modo Streaming), intercambia los buffers si
+     *         hay una solicitud pendiente (modo DoubleBuffer) o notifica el fin del frame (modo OneShot). 
+     *         Contexto ISR
+     */
+    void onDmaCplt();  
+
+	
+    /** @fn onDmaError()
+     *  @brief Finaliza el envío en curso tras un error de la dma del timer (contexto ISR)
+     */
+    void onDmaError();  
+
+	
+    /** @fn onSpiError()
+     *  @brief Finaliza el envío en curso tras un error de la dma spi (contexto ISR)
+     */
+    void onSpiError(DMA_SPI::ErrorResult);  
+
+	
+    /** @fn encodeSpi()
+     *  @brief Codifica un color GRB como símbolos spi (backend SPI), 3 o 4 bytes por componente
+     *  @param dst Posición del buffer en la que escribir los _led_size bytes
+     *  @param color Color a codificar
+     */
+    inline void encodeSpi(uint8_t* dst, const Color_t& color){
+        dst = WS281xBitCodec::encodeSpiByte(dst, _spi_nibble, _symbol_bits, _lut[color.green]);
+        dst = WS281xBitCodec::encodeSpiByte(dst, _spi_nibble, _symbol_bits, _lut[color.red]);
+        WS281xBitCodec::encodeSpiByte(dst, _spi_nibble, _symbol_bits, _lut[color.blue]);
+    }
+
+	
+    /** @fn encodeByte()
+     *  @brief Codifica un byte de color en 8 valores duty consecutivos mediante la tabla _nibble_lut
+     *  @param dst Posición del buffer en la que escribir los 8 valores
+     *  @param value Byte a codificar (MSB primero)
+     */
+    inline void encodeByte(uint8_t* dst, uint8_t value)  { WS281xBitCodec::encodeByte(dst, _nibble_lut.u8, value); }
+    inline void encodeByte(uint16_t* dst, uint8_t value) { WS281xBitCodec::encodeByte(dst, _nibble_lut.u16, value); }
+    inline void encodeByte(uint32_t* dst, uint8_t value) { WS281xBitCodec::encodeByte(dst, _nibble_lut.u32, value); }
+
+	
+    /** @fn encodeColor()
+     *  @brief Codifica un color en formato GRB (24 valores duty consecutivos)
+     *  @param buf Posición del buffer en la que escribir los 24 valores (elementos de tipo T)
+     *  @param color Color a codificar
+     */
+    template <typename T> void encodeColor(uint8_t* buf, const Color_t& color){
+        T* dst = (T*)buf;
+        encodeByte(dst, _lut[color.green]);
+        encodeByte(dst + 8, _lut[color.red]);
+        encodeByte(dst + 16, _lut[color.blue]);
+    }
+
 };    
 
 
@@ -0,0 +1,138 @@
+/*
+ * WS281xMatrix.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ */
+
+#include "WS281xMatrix.h"
+
+
+
+//------------------------------------------------------------------------------------
+//- STATIC ---------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+
+
+
+//------------------------------------------------------------------------------------
+//- PUBLIC CLASS IMPL. ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+WS281xMatrix::WS281xMatrix(WS281xLedStrip* strip, uint16_t width, uint16_t height, bool serpentine){ 
+    _strip = strip;
+    _map = 0;
+    _width = 0;
+    _height = 0;
+    // en Palette la tira no tiene framebuffer RGB, la matriz queda vacía
+    if(!_strip || _strip->getBufferMode() == WS281xLedStrip::Palette || 
+       ((uint32_t)width * height) > _strip->getNumLeds()){
+        return;
+    }
+    uint16_t* map = (uint16_t*)Heap::memAlloc(width * height * sizeof(uint16_t));
+    if(!map){
+        return;
+    }
+    for(uint16_t y = 0; y < height; y++){
+        for(uint16_t x = 0; x < width; x++){
+            map[(y * width) + x] = WS281xMatrixLayout::index(x, y, width, serpentine);
+        }
+    }
+    _map = map;
+    _width = width;
+    _height = height;
+}
+
+
+//------------------------------------------------------------------------------------
+WS281xMatrix::WS281xMatrix(WS281xLedStrip* strip, uint16_t width, uint16_t height, const uint16_t* table){ 
+    _strip = strip;
+    _map = 0;
+    _width = 0;
+    _height = 0;
+    if(!_strip || !table || _strip->getBufferMode() == WS281xLedStrip::Palette || 
+       ((uint32_t)width * height) > _strip->getNumLeds()){
+        return;
+    }
+    // la tabla es externa: se valida una única vez, para que las escrituras no tengan que comprobar cada índice
+    uint32_t count = (uint32_t)width * height;
+    for(uint32_t i = 0; i < count; i++){
+        if(table[i] >= _strip->getNumLeds()){
+            return;
+        }
+    }
+    _map = table;
+    _width = width;
+    _height = height;
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xMatrix::setXY(uint16_t x, uint16_t y, const WS281xLedStrip::Color_t& color){
+    if(x >= _width || y >= _height){
+        return;
+    }
+    _strip->putPixel(_map[(y * _width) + x], color);
+    _strip->autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xMatrix::fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const WS281xLedStrip::Color_t& color){
+    if(x >= _width || y >= _height){
+        return;
+    }
+    uint16_t x_end = (w > (_width - x))? _width : (x + w);
+    uint16_t y_end = (h > (_height - y))? _height : (y + h);
+    for(uint16_t row = y; row < y_end; row++){
+        const uint16_t* map = &_map[row * _width];
+        for(uint16_t col = x; col < x_end; col++){
+            _strip->putPixel(map[col], color);
+        }
+    }
+    _strip->autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xMatrix::blitRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const WS281xLedStrip::Color_t* src){
+    if(!src || x >= _width || y >= _height){
+        return;
+    }
+    // el recorte sólo afecta al número de columnas copiadas, la imagen de origen conserva su ancho
+    uint16_t cols = (w > (_width - x))? (_width - x) : w;
+    uint16_t rows = (h > (_height - y))? (_height - y) : h;
+    for(uint16_t r = 0; r < rows; r++){
+        const uint16_t* map = &_map[((y + r) * _width) + x];
+        const WS281xLedStrip::Color_t* line = &src[r * w];
+        for(uint16_t c = 0; c < cols; c++){
+            _strip->putPixel(map[c], line[c]);
+        }
+    }
+    _strip->autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xMatrix::blitFrame(const WS281xLedStrip::Color_t* frame){
+    if(!frame || !_map){
+        return;
+    }
+    // frame y tabla tienen el mismo orden, por lo que se recorren linealmente
+    uint32_t count = (uint32_t)_width * _height;
+    for(uint32_t i = 0; i < count; i++){
+        _strip->putPixel(_map[i], frame[i]);
+    }
+    _strip->autoCommit();
+}
+
+
+
+//------------------------------------------------------------------------------------
+//- PROTECTED CLASS IMPL. ------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
@@ -0,0 +1,183 @@
+/*
+ * WS281xMatrix.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  WS281xMatrix es una capa 2D sobre una tira WS281xLedStrip que forma una matriz de width x height leds. La 
+ *  traducción (x, y) -> índice de la tira se resuelve mediante una tabla, de forma que la aplicación no realiza 
+ *  ninguna aritmética por pixel:
+ *
+ *  - Para matrices de tamaño fijo, WS281xMatrixMap<W, H> genera la tabla en tiempo de compilación (constexpr, 
+ *    requiere C++11) y queda almacenada en flash: WS281xMatrix(strip, 32, 32, WS281xMatrixMap<32, 32>::table).
+ *  - Para tamaños definidos en ejecución, el constructor sin tabla la calcula una única vez en memoria.
+ *
+ *  Por defecto se asume cableado serpentine (zig-zag): las filas pares se recorren de izquierda a derecha y las 
+ *  impares de derecha a izquierda, con el led 0 en la esquina (0, 0). 
+ *
+ *  blitFrame() vuelca un frame completo en orden de filas (row-major) en una única pasada y con una única 
+ *  codificación, con la misma semántica de refresco que setPixels().
+ *
+ *  Las tiras en modo Palette no tienen framebuffer RGB: sobre ellas la matriz queda vacía (0 x 0).
+ *
+ */
+ 
+ 
+#ifndef WS281XMATRIX_H
+#define WS281XMATRIX_H
+
+ 
+#include "mbed.h"
+#include "WS281xLedStrip.h"
+
+
+//------------------------------------------------------------------------------------
+//- STRUCT WS281xMatrixMap -----------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+struct WS281xMatrixLayout {
+
+    /** Índice de la tira del led (x, y) en una matriz de 'width' columnas */
+    static constexpr uint16_t index(uint16_t x, uint16_t y, uint16_t width, bool serpentine){
+        return (y * width) + ((serpentine && (y & 1))? (width - 1 - x) : x);
+    }
+
+    /** Secuencia de índices 0..N-1, generada con profundidad de recursión logarítmica */
+    template <unsigned... I> struct Seq { typedef Seq type; };
+    template <class A, class B> struct Concat;
+    template <unsigned... A, unsigned... B> struct Concat<Seq<A...>, Seq<B...> > : Seq<A..., (sizeof...(A) + B)...> {};
+    template <unsigned N> struct MakeSeq : Concat<typename MakeSeq<N / 2>::type, typename MakeSeq<N - (N / 2)>::type> {};
+};
+template <> struct WS281xMatrixLayout::MakeSeq<0> : WS281xMatrixLayout::Seq<> {};
+template <> struct WS281xMatrixLayout::MakeSeq<1> : WS281xMatrixLayout::Seq<0> {};
+
+
+template <uint16_t W, uint16_t H, bool Serpentine, class S>
+struct WS281xMatrixTable;
+
+template <uint16_t W, uint16_t H, bool Serpentine, unsigned... I>
+struct WS281xMatrixTable<W, H, Serpentine, WS281xMatrixLayout::Seq<I...> > {
+    static const uint16_t table[W * H];
+};
+
+template <uint16_t W, uint16_t H, bool Serpentine, unsigned... I>
+const uint16_t WS281xMatrixTable<W, H, Serpentine, WS281xMatrixLayout::Seq<I...> >::table[W * H] = {
+    WS281xMatrixLayout::index(I % W, I / W, W, Serpentine)...
+};
+
+
+/** Tabla XY -> índice de una matriz de W x H leds, generada en compilación y ordenada por filas */
+template <uint16_t W, uint16_t H, bool Serpentine = true>
+struct WS281xMatrixMap : WS281xMatrixTable<W, H, Serpentine, typename WS281xMatrixLayout::MakeSeq<W * H>::type> {};
+
+
+
+//------------------------------------------------------------------------------------
+//- CLASS WS281xMatrix ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+class WS281xMatrix {
+  public:
+	
+    /** @fn WS281xMatrix()
+     *  @brief Constructor, que calcula la tabla XY -> índice en memoria
+     *  @param strip Tira de leds (con al menos width x height leds)
+     *  @param width Columnas de la matriz
+     *  @param height Filas de la matriz
+     *  @param serpentine True si el cableado es en zig-zag, False si todas las filas van en el mismo sentido
+     */
+    WS281xMatrix(WS281xLedStrip* strip, uint16_t width, uint16_t height, bool serpentine = true);
+
+	
+    /** @fn WS281xMatrix()
+     *  @brief Constructor con una tabla XY -> índice externa (p.ej. WS281xMatrixMap<W, H>::table)
+     *  @param strip Tira de leds (con al menos width x height leds)
+     *  @param width Columnas de la matriz
+     *  @param height Filas de la matriz
+     *  @param table Índice de la tira de cada led, ordenados por filas (width x height elementos). Si algún índice 
+     *         excede la tira, la matriz queda vacía (0 x 0)
+     */
+    WS281xMatrix(WS281xLedStrip* strip, uint16_t width, uint16_t height, const uint16_t* table);
+
+	
+    /** @fn ~WS281xMatrix()
+     *  @brief Destructor por defecto
+     */
+    virtual ~WS281xMatrix(){}
+
+	
+    /** @fn setXY()
+     *  @brief Cambia el color de un led. Las coordenadas fuera de la matriz se ignoran
+     *  @param x Columna
+     *  @param y Fila
+     *  @param color Color
+     */
+    void setXY(uint16_t x, uint16_t y, const WS281xLedStrip::Color_t& color);
+
+	
+    /** @fn fillRect()
+     *  @brief Rellena un rectángulo con un color, recortado a los límites de la matriz
+     *  @param x Columna de la esquina superior izquierda
+     *  @param y Fila de la esquina superior izquierda
+     *  @param w Ancho del rectángulo
+     *  @param h Alto del rectángulo
+     *  @param color Color
+     */
+    void fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const WS281xLedStrip::Color_t& color);
+
+	
+    /** @fn blitRect()
+     *  @brief Copia una imagen en un rectángulo, recortada a los límites de la matriz
+     *  @param x Columna de destino de la esquina superior izquierda
+     *  @param y Fila de destino de la esquina superior izquierda
+     *  @param w Ancho de la imagen
+     *  @param h Alto de la imagen
+     *  @param src Imagen de w x h colores ordenados por filas
+     */
+    void blitRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const WS281xLedStrip::Color_t* src);
+
+	
+    /** @fn blitFrame()
+     *  @brief Copia un frame completo de width x height colores ordenados por filas
+     *  @param frame Frame de origen
+     */
+    void blitFrame(const WS281xLedStrip::Color_t* frame);
+
+	
+    /** @fn getWidth()
+     *  @brief Obtiene el número de columnas
+     */
+    uint16_t getWidth() { return _width; }
+
+	
+    /** @fn getHeight()
+     *  @brief Obtiene el número de filas
+     */
+    uint16_t getHeight() { return _height; }
+
+	
+    /** @fn getLed()
+     *  @brief Obtiene el índice de la tira del led (x, y), que debe estar dentro de la matriz
+     */
+    uint16_t getLed(uint16_t x, uint16_t y) { return _map[(y * _width) + x]; }
+
+	
+    /** @fn getStrip()
+     *  @brief Obtiene la tira de leds
+     */
+    WS281xLedStrip* getStrip() { return _strip; }
+    
+        
+  protected:       
+
+    WS281xLedStrip* _strip;                     /// Tira de leds
+    const uint16_t* _map;                       /// Tabla XY -> índice, ordenada por filas
+    uint16_t _width;                            /// Columnas
+    uint16_t _height;                           /// Filas
+};    
+
+
+
+#endif   /* WS281XMATRIX_H */
@@ -0,0 +1,168 @@
+/*
+ * WS281xMultiStrip.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ */
+
+#include "WS281xMultiStrip.h"
+
+
+
+//------------------------------------------------------------------------------------
+//- STATIC ---------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+/** Pines asociados a los canales de TIM1 */
+static const PinName tim1_pins[WS281xMultiStrip::MaxStrips] = {PA_8, PA_9, PA_10, PA_11};
+
+
+
+
+//------------------------------------------------------------------------------------
+//- PUBLIC CLASS IMPL. ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+WS281xMultiStrip::WS281xMultiStrip(uint32_t hz, const uint16_t* num_leds, uint8_t count, DMA_PwmOut::DutyWidth width, 
+                                   WS281xLedStrip::BufferMode mode, uint16_t stream_leds){ 
+    _master = 0;
+    uint16_t longest = 0;
+    for(uint8_t i = 0; i < count && i < MaxStrips; i++){
+        longest = (num_leds[i] > longest)? num_leds[i] : longest;
+    }
+    for(uint8_t i = 0; i < MaxStrips; i++){
+        _strips[i] = 0;
+        if(i < count && num_leds[i] > 0){
+            // las tiras más cortas alargan su tiempo de reset hasta la longitud de la más larga, para que todos los
+            // canales dma tengan la misma duración de frame y permanezcan en fase en Continuous
+            uint32_t reset_bits = WS281xLedStrip::ResetTimeBits + ((uint32_t)(longest - num_leds[i]) * WS281xLedStrip::ColorBits);
+            if(reset_bits > 0xFFFF){
+                error("WS281xMultiStrip: tira %d demasiado corta para igualar la de %d leds\r\n", i, longest);
+                continue;
+            }
+            _strips[i] = new WS281xLedStrip(tim1_pins[i], hz, num_leds[i], width, mode, stream_leds,
+                                            WS281xLedStrip::ColorBits, (uint16_t)reset_bits,
+                                            WS281xLedStrip::BitLowPercent, WS281xLedStrip::BitHighPercent);
+            if(!_master){
+                _master = _strips[i];
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+WS281xMultiStrip::~WS281xMultiStrip(){ 
+    stop();
+    for(uint8_t i = 0; i < MaxStrips; i++){
+        if(_strips[i]){
+            delete(_strips[i]);
+            _strips[i] = 0;
+        }
+    }
+    _master = 0;
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xMultiStrip::start(){
+    if(!_master){
+        return false;
+    }
+    // con el contador detenido se arman todos los canales y se arrancan a la vez
+    bool result = true;
+    _master->_pwm->timerStop();
+    for(uint8_t i = 0; i < MaxStrips; i++){
+        if(_strips[i] && !_strips[i]->startDma(true)){
+            result = false;
+        }
+    }
+    _master->_pwm->timerStart();
+    return result;
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xMultiStrip::stop(){
+    for(uint8_t i = 0; i < MaxStrips; i++){
+        if(_strips[i]){
+            _strips[i]->stop();
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xMultiStrip::setRefreshMode(WS281xLedStrip::RefreshMode mode){
+    bool result = true;
+    for(uint8_t i = 0; i < MaxStrips; i++){
+        if(_strips[i] && !_strips[i]->setRefreshMode(mode)){
+            result = false;
+        }
+    }
+    return result;
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xMultiStrip::show(){
+    // no se acepta mientras alguna tira no haya enviado el frame anterior, para no desfasarlas
+    if(isSwapPending() || isSending()){
+        return false;
+    }
+    // en OneShot todas las salidas están a nivel bajo, se arman de nuevo y se arrancan en fase
+    if(_master && _master->getRefreshMode() == WS281xLedStrip::OneShot){
+        return start();
+    }
+    bool result = true;
+    for(uint8_t i = 0; i < MaxStrips; i++){
+        if(_strips[i] && !_strips[i]->show()){
+            result = false;
+        }
+    }
+    return result;
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xMultiStrip::isSwapPending(){
+    for(uint8_t i = 0; i < MaxStrips; i++){
+        if(_strips[i] && _strips[i]->isSwapPending()){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//------------------------------------------------------------------------------------
+bool WS281xMultiStrip::isSending(){
+    for(uint8_t i = 0; i < MaxStrips; i++){
+        if(_strips[i] && _strips[i]->isSending()){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t WS281xMultiStrip::getBufferSize(){
+    uint32_t size = 0;
+    for(uint8_t i = 0; i < MaxStrips; i++){
+        if(_strips[i]){
+            size += _strips[i]->getBufferSize();
+        }
+    }
+    return size;
+}
+
+
+
+//------------------------------------------------------------------------------------
+//- PROTECTED CLASS IMPL. ------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
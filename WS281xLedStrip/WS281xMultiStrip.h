@@ -0,0 +1,135 @@
+/*
+ * WS281xMultiStrip.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  WS281xMultiStrip gestiona hasta cuatro tiras WS281xLedStrip conectadas a los canales de TIM1:
+ *
+ *  Tira 0: PA_8  (TIM1_CH1) DMA1_Channel2
+ *  Tira 1: PA_9  (TIM1_CH2) DMA1_Channel3
+ *  Tira 2: PA_10 (TIM1_CH3) DMA1_Channel7
+ *  Tira 3: PA_11 (TIM1_CH4) DMA1_Channel4
+ *
+ *  Las cuatro tiras comparten una única base de tiempos y cada una dispone de su propio canal dma, de forma que se
+ *  transmiten en paralelo y el tiempo de refresco es el de la tira más larga, en lugar de la suma de todas ellas.
+ *  start() arma los canales dma con el contador de TIM1 detenido y lo habilita una única vez, por lo que todas las
+ *  tiras arrancan en fase. Para que sigan en fase en Continuous (cada canal recorre su propio buffer circular), el
+ *  tiempo de reset de las tiras más cortas se alarga con ColorBits elementos a 0 por cada led de diferencia, de
+ *  forma que todos los frames duran lo mismo que el de la tira más larga (también en Streaming).
+ *
+ *  Cada tira se manipula de forma individual mediante getStrip() y admite los mismos modos de buffer que
+ *  WS281xLedStrip. En modo DoubleBuffer, show() solicita el intercambio en todas las tiras a la vez. En modo de
+ *  refresco OneShot, show() vuelve a armar todas las tiras con TIM1 detenido y envía un único frame en fase.
+ *
+ *  NOTA: DMA1_Channel3 es compartido por TIM1_CH2, TIM16_CH1 y SPI1_TX. TIM1_CH2 no tiene ruta alternativa, por lo
+ *  que la tira 1 debe crearse antes que DMA_PwmOut(PA_6) o DMA_SPI sobre SPI1, que pasan entonces a DMA1_Channel6 y
+ *  DMA2_Channel4 respectivamente (ver DMA::allocate). Con I2C3_RX o USART3_RX (sin alternativa) hay conflicto.
+ *
+ */
+ 
+ 
+#ifndef WS281XMULTISTRIP_H
+#define WS281XMULTISTRIP_H
+
+ 
+#include "mbed.h"
+#include "WS281xLedStrip.h"
+
+//------------------------------------------------------------------------------------
+//- CLASS WS281xMultiStrip -----------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+class WS281xMultiStrip {
+  public:
+
+    static const uint8_t MaxStrips = 4;         /// Número de canales de TIM1
+	
+    /** @fn WS281xMultiStrip()
+     *  @brief Constructor, que crea una tira por cada canal de TIM1 utilizado
+     *  @param hz Frecuencia del ciclo pwm, común a todas las tiras
+     *  @param num_leds Número de leds de cada tira. Un valor 0 deja el canal sin utilizar
+     *  @param count Número de elementos de num_leds (máximo MaxStrips)
+     *  @param width Ancho de cada elemento de los buffers dma
+     *  @param mode Modo de gestión de los buffers dma
+     *  @param stream_leds Leds codificados en cada mitad del buffer dma (sólo en modo Streaming)
+     */
+    WS281xMultiStrip(uint32_t hz, const uint16_t* num_leds, uint8_t count, 
+                     DMA_PwmOut::DutyWidth width = DMA_PwmOut::DutyWidth32, 
+                     WS281xLedStrip::BufferMode mode = WS281xLedStrip::SingleBuffer, 
+                     uint16_t stream_leds = WS281xLedStrip::DefaultStreamLeds);
+
+	
+    /** @fn ~WS281xMultiStrip()
+     *  @brief Destructor, que detiene y libera las tiras
+     */
+    virtual ~WS281xMultiStrip();
+
+	
+    /** @fn start()
+     *  @brief Inicia la salida vía dma de todas las tiras en fase
+     *  @return True si todos los canales se han iniciado correctamente
+     */
+    bool start();
+
+	
+    /** @fn stop()
+     *  @brief Detiene la salida vía dma de todas las tiras
+     */
+    void stop();
+
+	
+    /** @fn setRefreshMode()
+     *  @brief Selecciona el modo de refresco de todas las tiras. Debe invocarse con la salida detenida
+     *  @param mode Modo de refresco
+     *  @return True si todas las tiras lo aceptan
+     */
+    bool setRefreshMode(WS281xLedStrip::RefreshMode mode);
+
+	
+    /** @fn show()
+     *  @brief Codifica los cambios pendientes de todas las tiras y solicita el intercambio de buffers en el siguiente
+     *         tiempo de reset (modo DoubleBuffer) o envía un único frame en fase (modo OneShot)
+     *  @return True si se acepta la solicitud, False si alguna tira tiene un intercambio o un envío pendiente
+     */
+    bool show();
+
+	
+    /** @fn isSwapPending()
+     *  @brief Indica si alguna tira tiene un intercambio de buffers pendiente (modo DoubleBuffer)
+     *  @return True mientras quede algún buffer trasero pendiente de enviarse
+     */
+    bool isSwapPending();
+
+	
+    /** @fn isSending()
+     *  @brief Indica si alguna tira está enviando un frame (modo OneShot)
+     *  @return True hasta que todas las tiras finalizan el envío
+     */
+    bool isSending();
+
+	
+    /** @fn getStrip()
+     *  @brief Obtiene una de las tiras
+     *  @param idx Índice de la tira (0..MaxStrips-1)
+     *  @return Tira o 0 si el canal no se utiliza
+     */
+    WS281xLedStrip* getStrip(uint8_t idx) { return (idx < MaxStrips)? _strips[idx] : 0; }
+
+	
+    /** @fn getBufferSize()
+     *  @brief Obtiene el tamaño total de los buffers dma reservados
+     *  @return Tamaño en bytes
+     */
+    uint32_t getBufferSize();
+    
+        
+  protected:       
+    WS281xLedStrip* _strips[MaxStrips];         /// Tiras asociadas a cada canal (0 si no se utiliza)
+    WS281xLedStrip* _master;                    /// Primera tira creada, a través de la que se controla TIM1
+};    
+
+
+
+#endif   /* WS281XMULTISTRIP_H */
@@ -0,0 +1,149 @@
+/*
+ * WS281xPixelFormat.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  Formatos de pixel para tiras WS281x y compatibles. Cada formato es una política con constantes de compilación:
+ *
+ *  - LedBits: bits por led (24 en RGB, 32 en RGBW).
+ *  - ResetBits: duración del tiempo de reset, en bits de 1.25us.
+ *  - BitLowPercent / BitHighPercent: duty de los bits a 0 y a 1.
+ *  - bytes(): orden en el que se envían las componentes del color (MSB primero).
+ *
+ *  WS281xStrip<Formato> es una WS281xLedStrip cuyo codificador, tamaño de buffer y tiempos quedan resueltos en
+ *  compilación a partir del formato, por lo que tiras de distinto tipo pueden convivir en la misma aplicación con el
+ *  mismo driver. WS281xLedStrip sin plantilla equivale a WS281xStrip<WS281xFormatGRB>.
+ *
+ *  NOTA: en WS281xFormatSK6812 (RGBW) el canal blanco se extrae del color RGB como min(R, G, B), de modo que la 
+ *  copia RGB de la tira sigue ocupando 3 bytes por led.
+ *
+ */
+ 
+ 
+#ifndef WS281XPIXELFORMAT_H
+#define WS281XPIXELFORMAT_H
+
+ 
+#include "WS281xLedStrip.h"
+
+
+//------------------------------------------------------------------------------------
+//- FORMATOS DE PIXEL ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+/** WS2812, WS2812B: orden GRB */
+struct WS281xFormatGRB {
+    static const uint8_t LedBits = 24;
+    static const uint16_t ResetBits = 50;       /// 62.5us
+    static const uint8_t BitLowPercent = 32;
+    static const uint8_t BitHighPercent = 64;
+    template <typename C> static inline void bytes(const C& c, uint8_t* out){
+        out[0] = c.green; out[1] = c.red; out[2] = c.blue;
+    }
+};
+
+
+/** WS2811 y variantes en orden RGB */
+struct WS281xFormatRGB {
+    static const uint8_t LedBits = 24;
+    static const uint16_t ResetBits = 50;       /// 62.5us
+    static const uint8_t BitLowPercent = 32;
+    static const uint8_t BitHighPercent = 64;
+    template <typename C> static inline void bytes(const C& c, uint8_t* out){
+        out[0] = c.red; out[1] = c.green; out[2] = c.blue;
+    }
+};
+
+
+/** Variantes en orden BRG */
+struct WS281xFormatBRG {
+    static const uint8_t LedBits = 24;
+    static const uint16_t ResetBits = 50;       /// 62.5us
+    static const uint8_t BitLowPercent = 32;
+    static const uint8_t BitHighPercent = 64;
+    template <typename C> static inline void bytes(const C& c, uint8_t* out){
+        out[0] = c.blue; out[1] = c.red; out[2] = c.green;
+    }
+};
+
+
+/** SK6812 RGBW: orden GRBW, 32 bits por led. tON=300ns/600ns y reset >80us */
+struct WS281xFormatSK6812 {
+    static const uint8_t LedBits = 32;
+    static const uint16_t ResetBits = 72;       /// 90us
+    static const uint8_t BitLowPercent = 24;
+    static const uint8_t BitHighPercent = 48;
+    template <typename C> static inline void bytes(const C& c, uint8_t* out){
+        uint8_t w = (c.red < c.green)? c.red : c.green;
+        w = (c.blue < w)? c.blue : w;
+        out[0] = c.green - w; out[1] = c.red - w; out[2] = c.blue - w; out[3] = w;
+    }
+};
+
+
+/** WS2815 (12V): orden GRB, tON=300ns/750ns y reset >280us */
+struct WS281xFormatWS2815 {
+    static const uint8_t LedBits = 24;
+    static const uint16_t ResetBits = 232;      /// 290us
+    static const uint8_t BitLowPercent = 24;
+    static const uint8_t BitHighPercent = 60;
+    template <typename C> static inline void bytes(const C& c, uint8_t* out){
+        out[0] = c.green; out[1] = c.red; out[2] = c.blue;
+    }
+};
+
+
+//------------------------------------------------------------------------------------
+//- CLASS WS281xStrip ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+template <class Format>
+class WS281xStrip : public WS281xLedStrip {
+  public:
+	
+    /** @fn WS281xStrip()
+     *  @brief Constructor, con los mismos parámetros que WS281xLedStrip
+     */
+    WS281xStrip(PinName pin, uint32_t hz, uint16_t num_leds, DMA_PwmOut::DutyWidth width = DMA_PwmOut::DutyWidth32, 
+                BufferMode mode = SingleBuffer, uint16_t stream_leds = DefaultStreamLeds)
+            : WS281xLedStrip(pin, hz, num_leds, width, mode, stream_leds, 
+                             Format::LedBits, Format::ResetBits, Format::BitLowPercent, Format::BitHighPercent){
+        // la clase base difiere la primera codificación, por lo que ningún led llega a codificarse en GRB
+        setEncoder(static_cast<Encoder>(&WS281xStrip::template encodeFormat<uint8_t>), 
+                   static_cast<Encoder>(&WS281xStrip::template encodeFormat<uint16_t>), 
+                   static_cast<Encoder>(&WS281xStrip::template encodeFormat<uint32_t>));
+    }
+
+	
+    /** @fn ~WS281xStrip()
+     *  @brief Destructor por defecto
+     */
+    virtual ~WS281xStrip(){}
+    
+        
+  protected:       
+	
+    /** @fn encodeFormat()
+     *  @brief Codifica las componentes del color en el orden del formato (LedBits valores duty consecutivos de 
+     *         tipo T). Es el codificador que la tira invoca para cada led
+     */
+    template <typename T> void encodeFormat(uint8_t* buf, const Color_t& color){
+        T* dst = (T*)buf;
+        uint8_t bytes[Format::LedBits / 8];
+        Format::bytes(color, bytes);
+        for(uint8_t i = 0; i < (Format::LedBits / 8); i++){
+            encodeByte(dst + (8 * i), _lut[bytes[i]]);
+        }
+    }
+};
+
+
+/** Tipos de tira habituales */
+typedef WS281xStrip<WS281xFormatSK6812> SK6812Strip;
+typedef WS281xStrip<WS281xFormatWS2815> WS2815Strip;
+
+
+#endif   /* WS281XPIXELFORMAT_H */
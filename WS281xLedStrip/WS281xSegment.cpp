@@ -0,0 +1,127 @@
+/*
+ * WS281xSegment.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ */
+
+#include "WS281xSegment.h"
+
+
+
+//------------------------------------------------------------------------------------
+//- STATIC ---------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+
+
+
+//------------------------------------------------------------------------------------
+//- PUBLIC CLASS IMPL. ---------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+WS281xSegment::WS281xSegment(WS281xLedStrip* strip, uint16_t offset, uint16_t length, bool reverse, uint16_t stride){ 
+    _strip = strip;
+    _map = 0;
+    _length = 0;
+    _first = 0;
+    _last = 0;
+    // en Palette la tira no tiene framebuffer RGB, la vista queda vacía
+    if(!_strip || _strip->getBufferMode() == WS281xLedStrip::Palette || offset >= _strip->getNumLeds() || length == 0){
+        return;
+    }
+    stride = (stride == 0)? 1 : stride;
+    // recorta la vista a los leds que caben en la tira
+    uint32_t fit = ((_strip->getNumLeds() - 1 - offset) / stride) + 1;
+    if(length > fit){
+        length = fit;
+    }
+    _map = (uint16_t*)Heap::memAlloc(length * sizeof(uint16_t));
+    if(!_map){
+        return;
+    }
+    _length = length;
+    for(uint16_t i = 0; i < _length; i++){
+        uint16_t pos = (reverse)? (_length - 1 - i) : i;
+        _map[i] = offset + (pos * stride);
+    }
+    _first = offset;
+    _last = offset + ((_length - 1) * stride);
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xSegment::setRange(uint16_t from, uint16_t to, const WS281xLedStrip::Color_t& color){
+    if(to > _length){
+        to = _length;
+    }
+    if(from >= to){
+        return;
+    }
+    for(uint16_t i = from; i < to; i++){
+        _strip->putPixel(_map[i], color);
+    }
+    _strip->autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xSegment::setPixels(uint16_t offset, const WS281xLedStrip::Color_t* src, uint16_t n){
+    if(!src || offset >= _length){
+        return;
+    }
+    if(n > (_length - offset)){
+        n = _length - offset;
+    }
+    const uint16_t* map = &_map[offset];
+    for(uint16_t i = 0; i < n; i++){
+        _strip->putPixel(map[i], src[i]);
+    }
+    _strip->autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xSegment::fillPattern(uint16_t offset, const WS281xLedStrip::Color_t* pattern, uint16_t patlen, uint16_t n){
+    if(!pattern || patlen == 0 || offset >= _length){
+        return;
+    }
+    if(n > (_length - offset)){
+        n = _length - offset;
+    }
+    uint16_t p = 0;
+    for(uint16_t i = offset; i < (offset + n); i++){
+        _strip->putPixel(_map[i], pattern[p]);
+        if(++p == patlen){
+            p = 0;
+        }
+    }
+    _strip->autoCommit();
+}
+
+
+//------------------------------------------------------------------------------------
+void WS281xSegment::setPixelsHSV(uint16_t offset, const WS281xLedStrip::Hsv_t* src, uint16_t n){
+    if(!src || offset >= _length){
+        return;
+    }
+    if(n > (_length - offset)){
+        n = _length - offset;
+    }
+    WS281xLedStrip::Color_t color;
+    for(uint16_t i = 0; i < n; i++){
+        WS281xLedStrip::hsvToRgb(src[i], color);
+        _strip->putPixel(_map[offset + i], color);
+    }
+    _strip->autoCommit();
+}
+
+
+
+//------------------------------------------------------------------------------------
+//- PROTECTED CLASS IMPL. ------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
@@ -0,0 +1,126 @@
+/*
+ * WS281xSegment.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  WS281xSegment es una vista (tira virtual) sobre una zona de una tira física WS281xLedStrip, definida por:
+ *
+ *  - offset: primer led físico de la zona.
+ *  - length: número de leds de la vista.
+ *  - reverse: recorre la zona en sentido inverso (el led 0 de la vista es el último de la zona).
+ *  - stride: separación entre leds físicos consecutivos de la vista (1 para leds contiguos).
+ *
+ *  La traducción de índices lógicos a físicos se precalcula en una tabla al crear la vista, de forma que escribir
+ *  un led a través de la vista cuesta lo mismo que escribirlo directamente en la tira. Los métodos de escritura son
+ *  los mismos que los de WS281xLedStrip y con la misma semántica de refresco; WS281xEffects también admite vistas.
+ *
+ *  Varias vistas pueden compartir la misma tira física (p.ej. puertas, estantes, un tramo montado al revés). La
+ *  vista no reserva leds: si dos vistas se solapan, prevalece la última escritura.
+ *
+ */
+ 
+ 
+#ifndef WS281XSEGMENT_H
+#define WS281XSEGMENT_H
+
+ 
+#include "mbed.h"
+#include "WS281xLedStrip.h"
+
+//------------------------------------------------------------------------------------
+//- CLASS WS281xSegment --------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+class WS281xSegment {
+  public:
+	
+    /** @fn WS281xSegment()
+     *  @brief Constructor, que precalcula la tabla de índices físicos. La longitud se recorta si la zona excede
+     *         el final de la tira. Sobre una tira en modo Palette la vista queda vacía (getNumLeds() == 0)
+     *  @param strip Tira física
+     *  @param offset Primer led físico de la zona
+     *  @param length Número de leds de la vista
+     *  @param reverse True si la vista recorre la zona en sentido inverso
+     *  @param stride Separación entre leds físicos consecutivos (mínimo 1)
+     */
+    WS281xSegment(WS281xLedStrip* strip, uint16_t offset, uint16_t length, bool reverse = false, uint16_t stride = 1);
+
+	
+    /** @fn ~WS281xSegment()
+     *  @brief Destructor por defecto
+     */
+    virtual ~WS281xSegment(){}
+
+	
+    /** @fn setRange()
+     *  @brief Cambia el color de un rango de leds de la vista
+     *  @param from Led desde el que se cambiará el color (incluido)
+     *  @param to Led hasta el que se cambiará el color (excluido)
+     *  @param color Color
+     */
+    void setRange(uint16_t from, uint16_t to, const WS281xLedStrip::Color_t& color);
+
+	
+    /** @fn setPixels()
+     *  @brief Copia un bloque de colores consecutivos de la vista
+     *  @param offset Primer led de la vista a modificar
+     *  @param src Colores de origen
+     *  @param n Número de leds a copiar (se recorta al final de la vista)
+     */
+    void setPixels(uint16_t offset, const WS281xLedStrip::Color_t* src, uint16_t n);
+
+	
+    /** @fn fillPattern()
+     *  @brief Rellena leds de la vista repitiendo un patrón de colores
+     *  @param offset Primer led de la vista a modificar
+     *  @param pattern Patrón de colores
+     *  @param patlen Número de colores del patrón
+     *  @param n Número de leds a rellenar (se recorta al final de la vista)
+     */
+    void fillPattern(uint16_t offset, const WS281xLedStrip::Color_t* pattern, uint16_t patlen, uint16_t n);
+
+	
+    /** @fn setPixelsHSV()
+     *  @brief Copia un bloque de colores HSV consecutivos de la vista, convertidos a RGB
+     *  @param offset Primer led de la vista a modificar
+     *  @param src Colores HSV de origen
+     *  @param n Número de leds a copiar (se recorta al final de la vista)
+     */
+    void setPixelsHSV(uint16_t offset, const WS281xLedStrip::Hsv_t* src, uint16_t n);
+
+	
+    /** @fn getNumLeds()
+     *  @brief Obtiene el número de leds de la vista
+     */
+    uint16_t getNumLeds() { return _length; }
+
+	
+    /** @fn getLed()
+     *  @brief Obtiene el índice físico de un led de la vista
+     *  @param led Índice dentro de la vista (debe ser menor que getNumLeds())
+     */
+    uint16_t getLed(uint16_t led) { return _map[led]; }
+
+	
+    /** @fn getStrip()
+     *  @brief Obtiene la tira física sobre la que se define la vista
+     */
+    WS281xLedStrip* getStrip() { return _strip; }
+    
+        
+  protected:       
+
+    friend class WS281xEffects;
+
+    WS281xLedStrip* _strip;                     /// Tira física
+    uint16_t* _map;                             /// Índice físico de cada led de la vista
+    uint16_t _length;                           /// Leds de la vista
+    uint16_t _first;                            /// Menor índice físico de la zona
+    uint16_t _last;                             /// Mayor índice físico de la zona
+};    
+
+
+
+#endif   /* WS281XSEGMENT_H */
@@ -0,0 +1,105 @@
+/*
+ * WS281xFileBlockDevice.h
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  BlockDevice de prueba respaldado por un fichero (stdio), con la geometría de una flash SPI (lectura y
+ *  programación por bytes, borrado por sectores de 4KB). Permite probar WS281xAnimPlayer con el mismo fichero que
+ *  genera tools/ws281x_anim_encode.cpp, sin programar la SPIFBlockDevice.
+ *
+ */
+
+
+#ifndef WS281XFILEBLOCKDEVICE_H
+#define WS281XFILEBLOCKDEVICE_H
+
+
+#include "mbed.h"
+#include "BlockDevice.h"
+#include <stdio.h>
+
+
+//------------------------------------------------------------------------------------
+//- CLASS WS281xFileBlockDevice ------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+class WS281xFileBlockDevice : public BlockDevice {
+  public:
+
+    static const bd_size_t EraseSize = 4096;    /// Tamaño de sector
+
+    /** @fn WS281xFileBlockDevice()
+     *  @brief Constructor
+     *  @param path Fichero de respaldo (se crea si no existe)
+     *  @param size Tamaño del dispositivo (múltiplo de EraseSize)
+     */
+    WS281xFileBlockDevice(const char* path, bd_size_t size) : _path(path), _size(size), _file(0) {}
+
+    virtual ~WS281xFileBlockDevice() { deinit(); }
+
+    virtual int init(){
+        if(_file){
+            return 0;
+        }
+        _file = fopen(_path, "r+b");
+        if(!_file){
+            _file = fopen(_path, "w+b");
+        }
+        return (_file)? 0 : -1;
+    }
+
+    virtual int deinit(){
+        if(_file){
+            fclose(_file);
+            _file = 0;
+        }
+        return 0;
+    }
+
+    virtual int read(void* buffer, bd_addr_t addr, bd_size_t size){
+        if(!_file || (addr + size) > _size || fseek(_file, (long)addr, SEEK_SET) != 0){
+            return -1;
+        }
+        // lo que aún no existe en el fichero se lee como flash borrada
+        size_t n = fread(buffer, 1, (size_t)size, _file);
+        memset(&((uint8_t*)buffer)[n], 0xFF, (size_t)size - n);
+        return 0;
+    }
+
+    virtual int program(const void* buffer, bd_addr_t addr, bd_size_t size){
+        if(!_file || (addr + size) > _size || fseek(_file, (long)addr, SEEK_SET) != 0){
+            return -1;
+        }
+        return (fwrite(buffer, 1, (size_t)size, _file) == size)? 0 : -1;
+    }
+
+    virtual int erase(bd_addr_t addr, bd_size_t size){
+        if(!_file || (addr % EraseSize) != 0 || (size % EraseSize) != 0 || (addr + size) > _size){
+            return -1;
+        }
+        uint8_t blank[64];
+        memset(blank, 0xFF, sizeof(blank));
+        fseek(_file, (long)addr, SEEK_SET);
+        for(bd_size_t i = 0; i < size; i += sizeof(blank)){
+            fwrite(blank, 1, sizeof(blank), _file);
+        }
+        return 0;
+    }
+
+    virtual bd_size_t get_read_size() const { return 1; }
+    virtual bd_size_t get_program_size() const { return 1; }
+    virtual bd_size_t get_erase_size() const { return EraseSize; }
+    virtual bd_size_t size() const { return _size; }
+
+  protected:
+
+    const char* _path;          /// Fichero de respaldo
+    bd_size_t _size;            /// Tamaño del dispositivo
+    FILE* _file;                /// Fichero abierto
+};
+
+
+
+#endif   /* WS281XFILEBLOCKDEVICE_H */
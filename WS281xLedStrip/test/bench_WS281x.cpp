@@ -0,0 +1,194 @@
+#include "mbed.h"
+#include "Logger.h"
+#include "WS281xLedStrip.h"
+#include <stdlib.h>
+
+
+// **************************************************************************
+// *********** DEFINICIONES *************************************************
+// **************************************************************************
+
+
+/** Macro de impresión de trazas de depuración */
+#define DEBUG_TRACE(format, ...)    if(logger){logger->printf(format, ##__VA_ARGS__);}
+
+/** Número de leds de la tira de prueba y número de frames codificados en cada medida */
+#define BENCH_NUM_LEDS      600
+#define BENCH_NUM_FRAMES    20
+
+
+// **************************************************************************
+// *********** OBJETOS  *****************************************************
+// **************************************************************************
+
+/** Canal de depuración */
+static Logger* logger;
+/** Driver de la tira de leds */
+static class WS281xBenchStrip* leddrv;
+
+
+// **************************************************************************
+// *********** TEST  ********************************************************
+// **************************************************************************
+
+
+//------------------------------------------------------------------------------------
+/** Codificador de referencia, bit a bit, tal y como lo hacía applyColor antes de incluir la tabla
+ *  de nibbles. Se mantiene aquí únicamente para comparar resultados y rendimiento.
+ */
+static void legacyApplyColor(uint32_t* buf, uint16_t led, const WS281xLedStrip::Color_t& color, uint32_t bitLow, uint32_t bitHigh){
+    uint32_t pos = 50 + (led * 24);
+    uint8_t mask = 0x80;
+    for(uint32_t i = pos; i < (pos + 8); i++){
+        buf[i] = ((color.green & mask) != 0)? bitHigh : bitLow;
+        mask = ((mask >> 1) & 0x7F);
+    }
+    mask = 0x80;
+    for(uint32_t i = (pos + 8); i < (pos + 16); i++){
+        buf[i] = ((color.red & mask) != 0)? bitHigh : bitLow;
+        mask = ((mask >> 1) & 0x7F);
+    }
+    mask = 0x80;
+    for(uint32_t i = (pos + 16); i < (pos + 24); i++){
+        buf[i] = ((color.blue & mask) != 0)? bitHigh : bitLow;
+        mask = ((mask >> 1) & 0x7F);
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+/** Tira que permite comparar su buffer dma con el generado por el codificador de referencia */
+class WS281xBenchStrip : public WS281xLedStrip {
+  public:
+    WS281xBenchStrip(PinName pin, uint16_t num_leds) : WS281xLedStrip(pin, 800000, num_leds) {}
+
+    /** Valores duty de los bits a 0 y a 1 */
+    uint32_t bitLow() { return _bitLow; }
+    uint32_t bitHigh() { return _bitHigh; }
+
+    /** Devuelve el número de elementos (reset y leds) que difieren del buffer de referencia */
+    int compare(const uint32_t* ref){
+        int errors = 0;
+        uint32_t count = _reset_bits + (_num_leds * _led_bits);
+        for(uint32_t i = 0; i < count; i++){
+            errors += (WS281xBitCodec::readDuty(&_color_buffer[i * _width], _width) != ref[i])? 1 : 0;
+        }
+        return errors;
+    }
+};
+
+
+//------------------------------------------------------------------------------------
+/** Calcula los leds codificados por segundo a partir del tiempo empleado en us */
+static uint32_t ledsPerSecond(uint32_t elapsed_us){
+    uint64_t leds = (uint64_t)BENCH_NUM_LEDS * BENCH_NUM_FRAMES;
+    return (elapsed_us)? (uint32_t)((leds * 1000000) / elapsed_us) : 0;
+}
+
+
+//------------------------------------------------------------------------------------
+void bench_WS281x(){
+    Timer tmr;
+    WS281xLedStrip::Color_t color;
+
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando bench_WS281x con %d leds...\r\n", BENCH_NUM_LEDS);
+    leddrv = new WS281xBenchStrip(PA_8, BENCH_NUM_LEDS);
+
+    // buffer auxiliar para el codificador de referencia, con el reset a 0
+    uint32_t* refbuf = (uint32_t*)calloc((BENCH_NUM_LEDS * 24) + 50, sizeof(uint32_t));
+    if(!refbuf){
+        DEBUG_TRACE("\r\nERROR: sin memoria para el buffer de referencia");
+        return;
+    }
+    uint32_t bitLow = leddrv->bitLow();
+    uint32_t bitHigh = leddrv->bitHigh();
+    int errors = 0;
+
+    // codificador bit a bit (antes)
+    tmr.reset();
+    tmr.start();
+    for(int f = 0; f < BENCH_NUM_FRAMES; f++){
+        for(int i = 0; i < BENCH_NUM_LEDS; i++){
+            color.red = i + f; color.green = i * 3; color.blue = f - i;
+            legacyApplyColor(refbuf, i, color, bitLow, bitHigh);
+        }
+    }
+    tmr.stop();
+    uint32_t legacy_us = tmr.read_us();
+
+    // codificador por tabla de nibbles (después), un color distinto por led
+    tmr.reset();
+    tmr.start();
+    for(int f = 0; f < BENCH_NUM_FRAMES; f++){
+        for(int i = 0; i < BENCH_NUM_LEDS; i++){
+            color.red = i + f; color.green = i * 3; color.blue = f - i;
+            leddrv->setRange(i, i+1, color);
+        }
+    }
+    tmr.stop();
+    uint32_t lut_us = tmr.read_us();
+    // el buffer de referencia contiene el último frame, con los mismos colores
+    errors += leddrv->compare(refbuf);
+
+    // mismo color en toda la tira (caso setRange con réplica del patrón)
+    tmr.reset();
+    tmr.start();
+    for(int f = 0; f < BENCH_NUM_FRAMES; f++){
+        color.red = f; color.green = 255 - f; color.blue = 2 * f;
+        leddrv->setRange(0, BENCH_NUM_LEDS, color);
+    }
+    tmr.stop();
+    uint32_t range_us = tmr.read_us();
+    for(int i = 0; i < BENCH_NUM_LEDS; i++){
+        legacyApplyColor(refbuf, i, color, bitLow, bitHigh);
+    }
+    errors += leddrv->compare(refbuf);
+
+    // frame completo renderizado en memoria y volcado con una única llamada
+    WS281xLedStrip::Color_t* frame = (WS281xLedStrip::Color_t*)malloc(BENCH_NUM_LEDS * sizeof(WS281xLedStrip::Color_t));
+    uint32_t frame_us = 0;
+    if(frame){
+        tmr.reset();
+        tmr.start();
+        for(int f = 0; f < BENCH_NUM_FRAMES; f++){
+            for(int i = 0; i < BENCH_NUM_LEDS; i++){
+                frame[i].red = i + f; frame[i].green = i * 3; frame[i].blue = f - i;
+            }
+            leddrv->setPixels(0, frame, BENCH_NUM_LEDS);
+        }
+        tmr.stop();
+        frame_us = tmr.read_us();
+        for(int i = 0; i < BENCH_NUM_LEDS; i++){
+            legacyApplyColor(refbuf, i, frame[i], bitLow, bitHigh);
+        }
+        errors += leddrv->compare(refbuf);
+        free(frame);
+    }
+
+    // patrón de 3 colores repetido en toda la tira
+    const WS281xLedStrip::Color_t pattern[3] = {{255, 0, 0}, {0, 255, 0}, {0, 0, 255}};
+    tmr.reset();
+    tmr.start();
+    for(int f = 0; f < BENCH_NUM_FRAMES; f++){
+        leddrv->fillPattern(0, &pattern[f % 3], 3 - (f % 3), BENCH_NUM_LEDS);
+    }
+    tmr.stop();
+    uint32_t pattern_us = tmr.read_us();
+    uint8_t first = (BENCH_NUM_FRAMES - 1) % 3;
+    for(int i = 0; i < BENCH_NUM_LEDS; i++){
+        legacyApplyColor(refbuf, i, pattern[first + (i % (3 - first))], bitLow, bitHigh);
+    }
+    errors += leddrv->compare(refbuf);
+
+    DEBUG_TRACE("\r\nBit a bit:        %d us, %d leds/s", legacy_us, ledsPerSecond(legacy_us));
+    DEBUG_TRACE("\r\nTabla nibbles:    %d us, %d leds/s", lut_us, ledsPerSecond(lut_us));
+    DEBUG_TRACE("\r\nsetRange (1 col): %d us, %d leds/s", range_us, ledsPerSecond(range_us));
+    DEBUG_TRACE("\r\nsetPixels:        %d us, %d leds/s", frame_us, ledsPerSecond(frame_us));
+    DEBUG_TRACE("\r\nfillPattern:      %d us, %d leds/s", pattern_us, ledsPerSecond(pattern_us));
+    WS281xLedStrip::Stats_t stats;
+    leddrv->getStats(stats);
+    DEBUG_TRACE("\r\nLeds codificados: %d, descartados sin cambios: %d", stats.encoded, stats.skipped);
+    DEBUG_TRACE("\r\nComparacion con la referencia: %s (%d elementos distintos)", (errors == 0)? "OK" : "ERROR", errors);
+    free(refbuf);
+}
@@ -2,6 +2,13 @@
 #include "MQLib.h"
 #include "Logger.h"
 #include "WS281xLedStrip.h"
+#include "WS281xMultiStrip.h"
+#include "WS281xEffects.h"
+#include "WS281xPixelFormat.h"
+#include "WS281xSegment.h"
+#include "WS281xMatrix.h"
+#include "WS281xAnimPlayer.h"
+#include "WS281xFileBlockDevice.h"
 
 
 // **************************************************************************
@@ -9,7 +16,7 @@
 // **************************************************************************
 
 
-/** Macro de impresin de trazas de depuracin */
+/** Macro de impresión de trazas de depuración */
 #define DEBUG_TRACE(format, ...)    if(logger){logger->printf(format, ##__VA_ARGS__);}
 
 
@@ -17,26 +24,219 @@
 // *********** OBJETOS  *****************************************************
 // **************************************************************************
 
-/** Canal de depuracin */
+/** Canal de depuración */
 static Logger* logger;
 /** Driver control detector */
 static WS281xLedStrip* leddrv;
 
 
+//------------------------------------------------------------------------------------
+/** Tira de prueba que decodifica su buffer dma con WS281xBitCodec (valores duty en el backend timer, símbolos en el
+ *  backend SPI) y compara cada led con el framebuffer o con la paleta indexada. En Streaming y Palette no arranca la
+ *  DMA: simula el anillo invocando las mismas rutinas que las interrupciones half/complete.
+ */
+class WS281xProbe : public WS281xLedStrip {
+  public:
+    WS281xProbe(PinName pin, uint16_t num_leds, DMA_PwmOut::DutyWidth width = DMA_PwmOut::DutyWidth8, 
+                BufferMode mode = WS281xLedStrip::SingleBuffer, uint16_t stream_leds = DefaultStreamLeds) 
+        : WS281xLedStrip(pin, 800000, num_leds, width, mode, stream_leds) {}
+
+    WS281xProbe(DMA_SPI* spi, uint16_t num_leds, SpiSymbol symbol, BufferMode mode = WS281xLedStrip::SingleBuffer) 
+        : WS281xLedStrip(spi, 2500000, num_leds, symbol, mode, 4) {}
+
+    /** Obtiene el color de un led del framebuffer */
+    const Color_t& pixel(uint16_t led) { return _pixels[led]; }
+
+    /** Bytes por led en el buffer dma */
+    uint32_t ledSize() { return _led_size; }
+
+    /** Indica si la tira ha creado un canal pwm, que el backend SPI no necesita */
+    bool hasPwm() { return (_pwm != 0); }
+
+    /** Nivel de la componente roja enviada a un led (SingleBuffer) */
+    uint8_t sentRed(uint16_t led) { return (uint8_t)(decodeAt(&_color_buffer[_reset_size + (led * _led_size)]) >> 8); }
+
+    /** Nivel de salida 8.8 esperado para una componente 8.8 */
+    uint16_t expected(uint16_t value) { return level16(value); }
+
+    /** Rellenos de media anillo (interrupciones half/complete) realizados en el último run */
+    uint32_t refills;
+
+    /** Rellenos esperados para 'frames' tramas: cada uno avanza _stream_leds posiciones (reset y leds) */
+    uint32_t expectedRefills(int frames) { return (frames * (_reset_slots + _num_leds)) / _stream_leds; }
+
+    /** Decodifica el buffer dma completo (SingleBuffer) frente a 'expected', o frente al framebuffer si es nulo, y
+     *  devuelve el número de errores: reset a 0, cada led en orden GRB y la línea a nivel bajo tras el último bit */
+    int check(const Color_t* expected = 0){
+        int errors = 0;
+        for(uint32_t i = 0; i < _reset_size; i++){
+            errors += (_color_buffer[i] != ResetTimeValue)? 1 : 0;
+        }
+        for(uint16_t led = 0; led < _num_leds; led++){
+            const Color_t& c = (expected)? expected[led] : _pixels[led];
+            errors += (decodeAt(&_color_buffer[_reset_size + (led * _led_size)]) == grb(c))? 0 : 1;
+        }
+        errors += (_color_buffer[_buffer_size - 1] != ResetTimeValue)? 1 : 0;
+        return errors;
+    }
+
+    /** Decodifica cada entrada de la tabla de nibbles del backend timer y devuelve el número de entradas que no
+     *  reproducen su nibble. Las vistas de la unión comparten dirección, por lo que la fila n está en n*4 elementos */
+    int checkLut(){
+        int errors = 0;
+        const uint8_t* lut = (const uint8_t*)&_nibble_lut;
+        for(uint8_t n = 0; n < 16; n++){
+            errors += (WS281xBitCodec::decodePwm(&lut[n * 4 * _width], _width, 4, _bitLow, _bitHigh) == n)? 0 : 1;
+        }
+        return errors;
+    }
+
+    /** Compara el contenido final del anillo con las posiciones que deben ocupar sus dos mitades tras el último
+     *  run, y devuelve el número de posiciones con error */
+    int checkRing(){
+        uint32_t slots = _reset_slots + _num_leds;
+        uint32_t fills = 2 + refills;
+        int errors = 0;
+        for(uint8_t h = 0; h < 2; h++){
+            // último relleno que escribió en esta mitad
+            uint32_t k = ((((fills - 1) & 1) == h)? (fills - 1) : (fills - 2));
+            const uint8_t* src = &_color_buffer[h * _stream_leds * _led_size];
+            for(uint16_t i = 0; i < _stream_leds; i++, src += _led_size){
+                uint32_t slot = ((k * _stream_leds) + i) % slots;
+                bool ok = (slot < _reset_slots)? isReset(src) : (decodeAt(src) == grb(sent(slot - _reset_slots)));
+                errors += (ok)? 0 : 1;
+            }
+        }
+        return errors;
+    }
+
+    /** Simula el envío de 'frames' tramas completas (Streaming y Palette) y devuelve el número de leds con error */
+    int run(int frames){
+        uint32_t slots = frames * (_reset_slots + _num_leds);
+        uint32_t pos = 0, resets = 0, decoded = 0;
+        int led = -1, errors = 0;
+        refills = 0;
+        _stream_slot = 0;
+        fillStream(_color_buffer);
+        fillStream(&_color_buffer[_buffer_size / 2]);
+        for(uint32_t n = 0; n < slots; n++){
+            const uint8_t* src = &_color_buffer[pos];
+            if(isReset(src)){
+                resets++;
+            }
+            else{
+                // primer led tras el reset, se inicia un nuevo frame
+                if(resets){
+                    errors += (resets < _reset_slots && led >= 0)? 1 : 0;
+                    resets = 0; led = 0;
+                }
+                if(led < 0 || led >= _num_leds || decodeAt(src) != grb(sent(led))){
+                    errors++;
+                }
+                else{
+                    decoded++;
+                }
+                led = (led < 0)? led : (led + 1);
+            }
+            // la dma avanza y genera las interrupciones en los mismos puntos que el hardware
+            pos += _led_size;
+            if(pos == _buffer_size / 2){
+                onDmaHalf();
+                refills++;
+            }
+            else if(pos == _buffer_size){
+                onDmaCplt();
+                refills++;
+                pos = 0;
+            }
+        }
+        // todos los leds de todos los frames deben haberse decodificado
+        return errors + ((decoded != (uint32_t)(frames * _num_leds))? 1 : 0);
+    }
+
+  private:
+
+    /** Color GRB de 24 bits en el orden de envío */
+    static int64_t grb(const Color_t& c) { return ((uint32_t)c.green << 16) | ((uint32_t)c.red << 8) | c.blue; }
+
+    /** Color que debe enviarse a un led: el del framebuffer o el de su entrada de paleta */
+    const Color_t& sent(uint16_t led) { return (_pixels)? _pixels[led] : _palette[_indices[led]]; }
+
+    /** Decodifica un led del buffer dma con el backend de la tira. Devuelve -1 si algún bit no es válido */
+    int64_t decodeAt(const uint8_t* src){
+        return (_spi)? WS281xBitCodec::decodeSpi(src, _symbol_bits, _led_bits) : 
+                       WS281xBitCodec::decodePwm(src, _width, _led_bits, _bitLow, _bitHigh);
+    }
+
+    /** Indica si una posición del anillo (un led) es tiempo de reset */
+    bool isReset(const uint8_t* src){
+        for(uint32_t i = 0; i < _led_size; i++){
+            if(src[i] != ResetTimeValue){
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+
+//------------------------------------------------------------------------------------
+/** Decodifica el buffer dma de una tira con formato de pixel y compara cada led con el orden de componentes
+ *  que define el formato.
+ */
+template <class Format>
+class WS281xFormatCheck : public WS281xStrip<Format> {
+  public:
+    WS281xFormatCheck(PinName pin, uint16_t num_leds) 
+        : WS281xStrip<Format>(pin, 800000, num_leds, DMA_PwmOut::DutyWidth8) {}
+
+    /** Devuelve el número de leds codificados con error */
+    int check(){
+        int errors = 0;
+        uint8_t bytes[Format::LedBits / 8];
+        for(uint16_t led = 0; led < this->_num_leds; led++){
+            const uint8_t* src = &this->_color_buffer[this->_reset_size + (led * this->_led_size)];
+            Format::bytes(this->_pixels[led], bytes);
+            uint32_t expected = 0;
+            for(uint8_t i = 0; i < (Format::LedBits / 8); i++){
+                expected = (expected << 8) | bytes[i];
+            }
+            int64_t value = WS281xBitCodec::decodePwm(src, this->_width, Format::LedBits, this->_bitLow, this->_bitHigh);
+            errors += (value == expected)? 0 : 1;
+        }
+        return errors;
+    }
+};
+
+
 // **************************************************************************
 // *********** TEST  ********************************************************
 // **************************************************************************
 
-
-
 //------------------------------------------------------------------------------------
+template <class Format>
+static int checkFormat(){
+    WS281xFormatCheck<Format>* strip = new WS281xFormatCheck<Format>(PA_8, 16);
+    // el frame inicial (a negro) ya se codifica con el formato de la tira
+    strip->commit();
+    int errors = strip->check();
+    WS281xLedStrip::Color_t color;
+    for(uint16_t i = 0; i < 16; i++){
+        color.red = i * 16; color.green = 255 - (i * 5); color.blue = (i & 1)? 0x5A : 0xC3;
+        strip->setRange(i, i + 1, color);
+    }
+    errors += strip->check();
+    delete strip;
+    return errors;
+}
+
 
 //------------------------------------------------------------------------------------
 void test_WS281x(){
 
             
     // --------------------------------------
-    // Inicia el canal de comunicacin remota
+    // Inicia el canal de comunicación remota
     //  - Pines USBTX, USBRX a 115200bps 
     logger = new Logger(USBTX, USBRX, 16, 115200);
     DEBUG_TRACE("\r\nIniciando test_WS281x...\r\n");
@@ -44,12 +244,13 @@ void test_WS281x(){
 
     // --------------------------------------
     // Creo driver de control para los servos
-    //  - Direccin I2C = 0h
-    //  - Nmero de servos controlables = 12 (0 al 11)    
+    //  - Dirección I2C = 0h
+    //  - Número de servos controlables = 12 (0 al 11)    
     DEBUG_TRACE("\r\nCreando Driver WS281x...");    
-    leddrv = new WS281xLedStrip(PA_8, 800000, 3);
+    leddrv = new WS281xLedStrip(PA_8, 800000, 3, DMA_PwmOut::DutyWidth8);
+    DEBUG_TRACE("\r\nBuffer dma: %d bytes, ahorro: %d bytes", leddrv->getBufferSize(), leddrv->getMemorySaved());
         
-    // situo todos a 0 y doy la orden sincronizada
+    // situo todos a 0º y doy la orden sincronizada
     DEBUG_TRACE("\r\nAjustando colores rojo, verde, azul... ");
     WS281xLedStrip::Color_t color;
     color.red = 255; color.green = 0; color.blue = 0;            
@@ -64,7 +265,7 @@ void test_WS281x(){
     for(;;){
         // espero 5 segundos
         Thread::wait(5000);
-        DEBUG_TRACE("\r\nCambio a verde mnimo... ");
+        DEBUG_TRACE("\r\nCambio a verde mínimo... ");
         color.red = 0; color.green = 1; color.blue = 0;
         leddrv->setRange(0, 3, color);
         Thread::wait(5000);
@@ -78,3 +279,626 @@ void test_WS281x(){
     }    
 }
 
+
+
+//------------------------------------------------------------------------------------
+/** Frames enviados, contados desde la callback de fin de envío */
+static volatile uint32_t frames_sent = 0;
+static void onFrameSent(){
+    frames_sent++;
+}
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_stream(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_stream...\r\n");
+    WS281xProbe* sim = new WS281xProbe(PA_8, 37, DMA_PwmOut::DutyWidth8, WS281xLedStrip::Streaming, 5);
+    DEBUG_TRACE("\r\nBuffer dma: %d bytes, ahorro: %d bytes", sim->getBufferSize(), sim->getMemorySaved());
+    WS281xLedStrip::Color_t color;
+    for(int i = 0; i < 37; i++){
+        color.red = i; color.green = 255 - i; color.blue = i * 7;
+        sim->setRange(i, i+1, color);
+    }
+    sim->attachFrameCb(callback(onFrameSent));
+    frames_sent = 0;
+    sim->resetStats();
+    int errors = sim->run(4);
+    DEBUG_TRACE("\r\nGradiente: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+    DEBUG_TRACE("\r\nFrames notificados: %d de 4 %s", frames_sent, (frames_sent == 4)? "OK" : "ERROR");
+    // 37 leds y 3 posiciones de reset en tramos de 5: 8 rellenos por frame
+    DEBUG_TRACE("\r\nRellenos: %d de %d %s", sim->refills, sim->expectedRefills(4), 
+                (sim->refills == sim->expectedRefills(4) && sim->refills == (4 * 8))? "OK" : "ERROR");
+    errors = sim->checkRing();
+    DEBUG_TRACE("\r\nAnillo final: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+    // el relleno del anillo se atribuye a los frames enviados
+    WS281xLedStrip::Stats_t stats;
+    sim->getStats(stats);
+    errors = (stats.frames != 4 || stats.encode_total == 0 || stats.encode_max < stats.encode_last)? 1 : 0;
+    DEBUG_TRACE("\r\nContadores: %s (%d frames, codificacion media %d us, max %d us)", (errors == 0)? "OK" : "ERROR", 
+                stats.frames, WS281xCycles::toUs((uint32_t)(stats.encode_total / 4)), WS281xCycles::toUs(stats.encode_max));
+    color.red = 0x55; color.green = 0xAA; color.blue = 0x0F;
+    sim->setRange(0, 37, color);
+    errors = sim->run(3);
+    errors += (sim->refills != sim->expectedRefills(3))? 1 : 0;
+    errors += sim->checkRing();
+    DEBUG_TRACE("\r\nColor fijo: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+    delete sim;
+}
+
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_palette(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_palette...\r\n");
+    WS281xProbe* sim = new WS281xProbe(PA_8, 37, DMA_PwmOut::DutyWidth8, WS281xLedStrip::Palette, 5);
+    DEBUG_TRACE("\r\nBuffer dma: %d bytes, ahorro: %d bytes", sim->getBufferSize(), sim->getMemorySaved());
+    // paleta en escala de rojos y leds con índices consecutivos
+    WS281xLedStrip::Color_t palette[WS281xLedStrip::PaletteSize];
+    for(uint16_t i = 0; i < WS281xLedStrip::PaletteSize; i++){
+        palette[i].red = i; palette[i].green = 255 - i; palette[i].blue = i >> 1;
+    }
+    sim->setPalette(0, palette, WS281xLedStrip::PaletteSize);
+    uint8_t indices[37];
+    for(int i = 0; i < 37; i++){
+        indices[i] = i * 7;
+    }
+    sim->setIndices(0, indices, 37);
+    int errors = sim->run(4);
+    DEBUG_TRACE("\r\nIndices: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+    // cambiar una entrada de la paleta recolorea todos los leds que la usan, sin tocar los índices
+    sim->setIndexRange(10, 20, 3);
+    WS281xLedStrip::Color_t color = {0x12, 0x34, 0x56};
+    sim->setPaletteEntry(3, color);
+    errors = sim->run(3);
+    DEBUG_TRACE("\r\nCambio de paleta: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+    // sin framebuffer RGB no se admiten vistas ni efectos
+    WS281xSegment* seg = new WS281xSegment(sim, 0, 10);
+    WS281xMatrix* mtx = new WS281xMatrix(sim, 4, 4);
+    WS281xEffects* fx = new WS281xEffects(sim);
+    errors = (seg->getNumLeds() != 0 || mtx->getWidth() != 0 || fx->gradient(0, 10, color, color) >= 0)? 1 : 0;
+    DEBUG_TRACE("\r\nVistas y efectos rechazados: %s", (errors == 0)? "OK" : "ERROR");
+    delete fx;
+    delete mtx;
+    delete seg;
+    delete sim;
+}
+
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_multi(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_multi...\r\n");
+    // cuatro tiras de distinta longitud en TIM1_CH1..CH4, con doble buffer para cambiar de frame a la vez
+    const uint16_t num_leds[WS281xMultiStrip::MaxStrips] = {60, 30, 45, 60};
+    WS281xMultiStrip* multi = new WS281xMultiStrip(800000, num_leds, WS281xMultiStrip::MaxStrips, 
+                                                   DMA_PwmOut::DutyWidth8, WS281xLedStrip::DoubleBuffer);
+    DEBUG_TRACE("\r\nBuffers dma: %d bytes", multi->getBufferSize());
+    // todas las tiras se rellenan hasta la longitud de la más larga, para que sus frames duren lo mismo
+    int errors = 0;
+    for(uint8_t i = 1; i < WS281xMultiStrip::MaxStrips; i++){
+        errors += (multi->getStrip(i)->getBufferSize() != multi->getStrip(0)->getBufferSize())? 1 : 0;
+        errors += (multi->getStrip(i)->getFrameRate() != multi->getStrip(0)->getFrameRate())? 1 : 0;
+    }
+    DEBUG_TRACE("\r\nFrames en fase: %s (%d Hz, %d errores)", (errors == 0)? "OK" : "ERROR", multi->getStrip(0)->getFrameRate(), errors);
+    WS281xLedStrip::Color_t color;
+    for(uint8_t i = 0; i < WS281xMultiStrip::MaxStrips; i++){
+        color.red = (i == 0 || i == 3)? 64 : 0; color.green = (i == 1 || i == 3)? 64 : 0; color.blue = (i == 2)? 64 : 0;
+        multi->getStrip(i)->setRange(0, num_leds[i], color);
+    }
+    multi->show();
+    DEBUG_TRACE("\r\nSTART... %s", (multi->start())? "OK" : "ERROR");
+    // desplaza un led blanco por las cuatro tiras a la vez
+    WS281xLedStrip::Color_t white = {32, 32, 32};
+    for(uint16_t pos = 0; pos < 60; pos++){
+        while(multi->isSwapPending()){
+            Thread::wait(1);
+        }
+        for(uint8_t i = 0; i < WS281xMultiStrip::MaxStrips; i++){
+            WS281xLedStrip* strip = multi->getStrip(i);
+            color.red = (i == 0 || i == 3)? 64 : 0; color.green = (i == 1 || i == 3)? 64 : 0; color.blue = (i == 2)? 64 : 0;
+            strip->setRange(0, num_leds[i], color);
+            strip->setRange(pos % num_leds[i], (pos % num_leds[i]) + 1, white);
+        }
+        multi->show();
+        Thread::wait(50);
+    }
+    DEBUG_TRACE("\r\nSTOP");
+    delete multi;
+}
+
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_oneshot(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_oneshot...\r\n");
+    leddrv = new WS281xLedStrip(PA_8, 800000, 30, DMA_PwmOut::DutyWidth8);
+    leddrv->setRefreshMode(WS281xLedStrip::OneShot);
+    frames_sent = 0;
+    leddrv->attachFrameCb(callback(onFrameSent));
+    // cada show() envía un frame (~1ms con 30 leds) y la línea queda a nivel bajo hasta el siguiente
+    WS281xLedStrip::Color_t color = {0, 0, 0};
+    for(uint8_t i = 0; i < 100; i++){
+        color.red = i; color.blue = 100 - i;
+        leddrv->setRange(0, 30, color);
+        while(!leddrv->show()){
+            Thread::wait(1);
+        }
+        Thread::wait(20);
+    }
+    while(leddrv->isSending()){
+        Thread::wait(1);
+    }
+    DEBUG_TRACE("\r\nFrames enviados: %d de 100 %s", frames_sent, (frames_sent == 100)? "OK" : "ERROR");
+}
+
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_effects(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_effects...\r\n");
+    leddrv = new WS281xLedStrip(PA_8, 800000, 60, DMA_PwmOut::DutyWidth8);
+    WS281xEffects* fx = new WS281xEffects(leddrv);
+    leddrv->start();
+    fx->start();
+    // cuatro efectos simultáneos sobre segmentos disjuntos, sin intervención de la aplicación
+    WS281xLedStrip::Color_t black = {0, 0, 0}, red = {255, 0, 0}, blue = {0, 0, 255}, white = {64, 64, 64};
+    int8_t fade = fx->fade(0, 15, black, red, 2000);
+    fx->gradient(15, 30, red, blue);
+    int8_t chase = fx->chase(30, 45, white, black, 3, 50);
+    int8_t prop = fx->propagate(45, 60, blue, 100);
+    DEBUG_TRACE("\r\nEfectos: %d, solapado: %d (esperado -1)", (fade >= 0 && chase >= 0 && prop >= 0), fx->fade(10, 20, red, blue, 100));
+    for(;;){
+        Thread::wait(100);
+        if(!fx->isRunning(fade)){
+            DEBUG_TRACE("\r\nFundido finalizado, invierto...");
+            WS281xLedStrip::Color_t tmp = red; red = black; black = tmp;
+            fade = fx->fade(0, 15, black, red, 2000);
+        }
+        if(!fx->isRunning(prop)){
+            DEBUG_TRACE("\r\nPropagación finalizada, reinicio...");
+            blue.green ^= 0xFF;
+            prop = fx->propagate(45, 60, blue, 100);
+        }
+    }
+}
+
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_formats(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_formats...\r\n");
+    DEBUG_TRACE("\r\nGRB:    %d errores", checkFormat<WS281xFormatGRB>());
+    DEBUG_TRACE("\r\nRGB:    %d errores", checkFormat<WS281xFormatRGB>());
+    DEBUG_TRACE("\r\nBRG:    %d errores", checkFormat<WS281xFormatBRG>());
+    DEBUG_TRACE("\r\nSK6812: %d errores", checkFormat<WS281xFormatSK6812>());
+    DEBUG_TRACE("\r\nWS2815: %d errores", checkFormat<WS281xFormatWS2815>());
+    // una tira SK6812 en el pin contiguo, con el mismo driver
+    SK6812Strip* rgbw = new SK6812Strip(PA_9, 800000, 10, DMA_PwmOut::DutyWidth8);
+    DEBUG_TRACE("\r\nSK6812 10 leds: buffer dma %d bytes", rgbw->getBufferSize());
+    delete rgbw;
+}
+
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_segment(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_segment...\r\n");
+    WS281xProbe* sim = new WS281xProbe(PA_8, 30, DMA_PwmOut::DutyWidth8, WS281xLedStrip::Streaming, 5);
+    // tramo invertido con un led de separación: leds físicos 22, 20, ... 4
+    WS281xSegment* seg = new WS281xSegment(sim, 4, 10, true, 2);
+    WS281xLedStrip::Color_t colors[10];
+    for(uint8_t i = 0; i < 10; i++){
+        colors[i].red = i + 1; colors[i].green = 0; colors[i].blue = 0;
+    }
+    seg->setPixels(0, colors, 10);
+    int errors = 0;
+    for(uint8_t i = 0; i < 10; i++){
+        uint16_t led = 22 - (2 * i);
+        if(seg->getLed(i) != led || sim->pixel(led).red != (i + 1) || sim->pixel(led + 1).red != 0){
+            errors++;
+        }
+    }
+    DEBUG_TRACE("\r\nsetPixels: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+    // una vista que excede la tira se recorta
+    WS281xSegment* tail = new WS281xSegment(sim, 25, 10, false, 2);
+    DEBUG_TRACE("\r\nRecorte: %s (%d leds)", (tail->getNumLeds() == 3)? "OK" : "ERROR", tail->getNumLeds());
+    // degradado sobre la vista, avanzado manualmente con el motor detenido
+    WS281xEffects* fx = new WS281xEffects(sim);
+    WS281xLedStrip::Color_t black = {0, 0, 0}, white = {90, 90, 90};
+    int8_t id = fx->gradient(seg, black, white);
+    int8_t overlap = fx->fade(10, 12, black, white, 100);
+    fx->tick();
+    errors = 0;
+    for(uint8_t i = 0; i < 10; i++){
+        if(sim->pixel(seg->getLed(i)).green != (i * 10)){
+            errors++;
+        }
+    }
+    errors += sim->run(2);
+    DEBUG_TRACE("\r\nDegradado: %s (%d errores), id=%d, solapado=%d (esperado -1)", (errors == 0 && id >= 0 && overlap < 0)? "OK" : "ERROR", errors, id, overlap);
+    delete fx;
+    delete tail;
+    delete seg;
+    delete sim;
+}
+
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_matrix(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_matrix...\r\n");
+    // la tabla en compilación coincide con la calculada en ejecución para una matriz 32x32
+    WS281xProbe* big = new WS281xProbe(PA_8, 32 * 32, DMA_PwmOut::DutyWidth8, WS281xLedStrip::Streaming, 16);
+    WS281xMatrix* runtime = new WS281xMatrix(big, 32, 32);
+    int errors = 0;
+    for(uint16_t y = 0; y < 32; y++){
+        for(uint16_t x = 0; x < 32; x++){
+            if(runtime->getLed(x, y) != WS281xMatrixMap<32, 32>::table[(y * 32) + x]){
+                errors++;
+            }
+        }
+    }
+    DEBUG_TRACE("\r\nTabla 32x32: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+    delete runtime;
+    delete big;
+    // matriz 8x4 en zig-zag: la fila 1 empieza en el led 15
+    WS281xProbe* sim = new WS281xProbe(PA_8, 8 * 4, DMA_PwmOut::DutyWidth8, WS281xLedStrip::Streaming, 4);
+    WS281xMatrix* mtx = new WS281xMatrix(sim, 8, 4, WS281xMatrixMap<8, 4>::table);
+    WS281xLedStrip::Color_t frame[8 * 4];
+    for(uint8_t i = 0; i < (8 * 4); i++){
+        frame[i].red = i; frame[i].green = 0; frame[i].blue = 0;
+    }
+    mtx->blitFrame(frame);
+    errors = 0;
+    for(uint16_t y = 0; y < 4; y++){
+        for(uint16_t x = 0; x < 8; x++){
+            uint16_t led = (y * 8) + (((y & 1) != 0)? (7 - x) : x);
+            if(sim->pixel(led).red != ((y * 8) + x)){
+                errors++;
+            }
+        }
+    }
+    DEBUG_TRACE("\r\nblitFrame: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+    // rectángulo 3x3 recortado en la esquina inferior derecha
+    WS281xLedStrip::Color_t img[9];
+    for(uint8_t i = 0; i < 9; i++){
+        img[i].red = 0; img[i].green = 0; img[i].blue = 100 + i;
+    }
+    mtx->blitRect(6, 2, 3, 3, img);
+    errors = (sim->pixel(mtx->getLed(6, 2)).blue != 100) + (sim->pixel(mtx->getLed(7, 2)).blue != 101);
+    errors += (sim->pixel(mtx->getLed(6, 3)).blue != 103) + (sim->pixel(mtx->getLed(7, 3)).blue != 104);
+    errors += (sim->pixel(mtx->getLed(5, 3)).blue != 0);
+    mtx->setXY(0, 1, img[8]);
+    errors += (sim->pixel(15).blue != 108);
+    errors += sim->run(2);
+    DEBUG_TRACE("\r\nblitRect/setXY: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+    // una tabla con un índice fuera de la tira se rechaza: la matriz queda vacía y las escrituras se ignoran
+    static const uint16_t bad_table[4] = {0, 1, 2, 8 * 4};
+    WS281xMatrix* bad = new WS281xMatrix(sim, 2, 2, bad_table);
+    bad->setXY(1, 1, img[0]);
+    errors = (bad->getWidth() != 0 || bad->getHeight() != 0)? 1 : 0;
+    DEBUG_TRACE("\r\nTabla invalida: %s", (errors == 0)? "OK" : "ERROR");
+    delete bad;
+    delete mtx;
+    delete sim;
+}
+
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_dither(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_dither...\r\n");
+    WS281xProbe* strip = new WS281xProbe(PA_8, 8);
+    strip->setGamma<22>();
+    DEBUG_TRACE("\r\nDithering: %s", (strip->enableDithering())? "OK" : "ERROR");
+    // niveles bajos con fracción en los leds pares y un nivel entero en el 1
+    WS281xLedStrip::Color16_t colors[4] = {{0x4080, 0, 0}, {0x8000, 0, 0}, {0xC0C0, 0, 0}, {0x1A55, 0, 0}};
+    strip->setPixels16(0, colors, 4);
+    WS281xLedStrip::Color_t red = {200, 0, 0};
+    strip->setRange(4, 8, red);
+    // la media de 256 frames debe reproducir el nivel 8.8 con un error menor de un frame
+    uint32_t sum[4] = {0, 0, 0, 0};
+    strip->resetStats();
+    for(uint16_t f = 0; f < 256; f++){
+        strip->commit();
+        for(uint8_t i = 0; i < 4; i++){
+            sum[i] += strip->sentRed(i);
+        }
+    }
+    int errors = 0;
+    for(uint8_t i = 0; i < 4; i++){
+        uint16_t level = strip->expected(colors[i].red);
+        DEBUG_TRACE("\r\nLed %d: nivel 8.8 = 0x%04X, media = 0x%04X", i, level, sum[i]);
+        if(sum[i] > (uint32_t)level + 256 || (sum[i] + 256) < level){
+            errors++;
+        }
+    }
+    // sólo se recodifican leds con dithering: nunca los de color de 8 bits ni los de nivel entero
+    WS281xLedStrip::Stats_t stats;
+    strip->getStats(stats);
+    errors += (stats.encoded > (256 * 2))? 1 : 0;
+    DEBUG_TRACE("\r\nMedia temporal: %s (%d errores, %d leds codificados)", (errors == 0)? "OK" : "ERROR", errors, stats.encoded);
+    delete strip;
+}
+
+
+
+//------------------------------------------------------------------------------------
+/** Render del planificador: desplaza un led encendido en cada frame */
+static uint16_t render_pos = 0;
+static void onRender(){
+    WS281xLedStrip::Color_t black = {0, 0, 0}, white = {32, 32, 32};
+    leddrv->setRange(render_pos, render_pos + 1, black);
+    render_pos = (render_pos + 1) % leddrv->getNumLeds();
+    leddrv->setRange(render_pos, render_pos + 1, white);
+}
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_scheduler(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_scheduler...\r\n");
+    leddrv = new WS281xLedStrip(PA_8, 800000, 30, DMA_PwmOut::DutyWidth8, WS281xLedStrip::DoubleBuffer);
+    leddrv->attachFrameCb(callback(onFrameSent));
+    Timer tmr;
+    // OneShot: 50 frames por segundo marcados por el ticker, sin esperas en la aplicación
+    leddrv->setRefreshMode(WS281xLedStrip::OneShot);
+    leddrv->resetStats();
+    frames_sent = 0;
+    tmr.start();
+    leddrv->startScheduler(50, callback(onRender));
+    Thread::wait(2000);
+    leddrv->stopScheduler();
+    WS281xLedStrip::Stats_t stats;
+    leddrv->getStats(stats);
+    DEBUG_TRACE("\r\nOneShot: %d frames en %d ms (esperados 100), %d perdidos", frames_sent, tmr.read_ms(), stats.missed);
+    // Continuous: la DMA marca el ritmo y el render se invoca cada N frames
+    while(leddrv->isSending()){
+        Thread::wait(1);
+    }
+    leddrv->setRefreshMode(WS281xLedStrip::Continuous);
+    leddrv->start();
+    leddrv->resetStats();
+    frames_sent = 0;
+    render_pos = 0;
+    leddrv->startScheduler(100, callback(onRender));
+    Thread::wait(1000);
+    leddrv->stop();
+    leddrv->getStats(stats);
+    DEBUG_TRACE("\r\nContinuous: %d frames dma/s, %d renders (esperados 100), %d perdidos", frames_sent, render_pos, stats.missed);
+    DEBUG_TRACE("\r\nCodificacion: media %d us, max %d us por frame; %d errores dma", 
+                WS281xCycles::toUs((uint32_t)(stats.encode_total / ((stats.frames)? stats.frames : 1))), 
+                WS281xCycles::toUs(stats.encode_max), stats.dma_errors);
+}
+
+
+
+//------------------------------------------------------------------------------------
+/** Frame procedural de la animación: fondo fijo, una barra que avanza y un degradado que cambia cada 4 frames */
+static void animFrame(uint16_t f, uint16_t num_leds, uint8_t* rgb){
+    for(uint16_t i = 0; i < num_leds; i++){
+        uint8_t* c = &rgb[3 * i];
+        c[0] = 0; c[1] = 0; c[2] = 8;
+        if(i >= (num_leds / 2)){
+            c[0] = (uint8_t)((i * 5) + ((f / 4) * 20)); c[1] = (uint8_t)i; c[2] = 0;
+        }
+        if(i >= (f % num_leds) && i < ((f % num_leds) + 5)){
+            c[0] = 255; c[1] = 128; c[2] = 64;
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_anim(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_anim...\r\n");
+    const uint16_t num_leds = 40, frames = 24, key_interval = 8;
+    // codificación (como tools/ws281x_anim_encode.cpp) y programación en el dispositivo
+    WS281xFileBlockDevice* bd = new WS281xFileBlockDevice("ws281x_anim.bin", 64 * 1024);
+    bd->init();
+    bd->erase(0, 64 * 1024);
+    uint8_t* prev = (uint8_t*)Heap::memAlloc(3 * num_leds);
+    uint8_t* cur = (uint8_t*)Heap::memAlloc(3 * num_leds);
+    uint8_t* enc = (uint8_t*)Heap::memAlloc(WS281xAnimCodec::maxFrameSize(num_leds));
+    WS281xAnimCodec::Header_t hdr = {num_leds, 30, key_interval, frames, 0};
+    for(uint16_t f = 0; f < frames; f++){
+        animFrame(f, num_leds, cur);
+        uint32_t size = WS281xAnimCodec::encodeFrame(((f % key_interval) == 0)? 0 : prev, cur, num_leds, enc);
+        bd->program(enc, WS281xAnimCodec::HeaderSize + hdr.data_size, size);
+        hdr.data_size += size;
+        memcpy(prev, cur, 3 * num_leds);
+    }
+    uint8_t raw_hdr[WS281xAnimCodec::HeaderSize];
+    WS281xAnimCodec::writeHeader(hdr, raw_hdr);
+    bd->program(raw_hdr, 0, WS281xAnimCodec::HeaderSize);
+    DEBUG_TRACE("\r\nCodificados %d frames en %d bytes (%d en bruto)", frames, hdr.data_size, frames * 3 * num_leds);
+
+    // reproducción con un buffer pequeño, para que los frames den la vuelta al anillo, y dos pasadas en bucle
+    WS281xProbe* sim = new WS281xProbe(PA_8, num_leds, DMA_PwmOut::DutyWidth8, WS281xLedStrip::Streaming, 5);
+    WS281xAnimPlayer* player = new WS281xAnimPlayer(sim, bd, 0, 256);
+    int errors = (player->open())? 0 : 1;
+    player->setLoop(true);
+    for(uint16_t f = 0; f < (2 * frames) && errors == 0; f++){
+        player->fill();
+        if(!player->nextFrame()){
+            errors++;
+            break;
+        }
+        animFrame(f % frames, num_leds, cur);
+        for(uint16_t i = 0; i < num_leds; i++){
+            const WS281xLedStrip::Color_t& c = sim->pixel(i);
+            if(c.red != cur[3 * i] || c.green != cur[(3 * i) + 1] || c.blue != cur[(3 * i) + 2]){
+                errors++;
+            }
+        }
+    }
+    errors += player->getUnderruns();
+    errors += sim->run(1);
+    DEBUG_TRACE("\r\nReproduccion en bucle: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+    // sin repetición termina tras el último frame, y sin llenar el buffer se contabilizan underruns
+    player->setLoop(false);
+    player->open();
+    uint16_t decoded = 0;
+    while(player->nextFrame()){
+        decoded++;
+    }
+    errors = (decoded == 0 || decoded >= frames || player->getUnderruns() != 1)? 1 : 0;
+    while(!player->isFinished()){
+        player->fill();
+        decoded += (player->nextFrame())? 1 : 0;
+    }
+    errors += (decoded != frames)? 1 : 0;
+    DEBUG_TRACE("\r\nFin y underruns: %s (%d frames)", (errors == 0)? "OK" : "ERROR", decoded);
+    // una cabecera sin datos para sus frames se rechaza, y stop() no detiene un planificador que no inició play()
+    WS281xAnimCodec::Header_t empty = {num_leds, 30, key_interval, frames, 0};
+    WS281xAnimCodec::writeHeader(empty, raw_hdr);
+    bd->erase(0, 64 * 1024);
+    bd->program(raw_hdr, 0, WS281xAnimCodec::HeaderSize);
+    errors = (player->open())? 1 : 0;
+    player->stop();
+    DEBUG_TRACE("\r\nCabecera truncada: %s", (errors == 0)? "OK" : "ERROR");
+    delete player;
+    delete sim;
+    delete bd;
+}
+
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_spi(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_spi...\r\n");
+    // SPI1_TX comparte DMA1_Channel3 con TIM16_CH1 y TIM1_CH2, pero ambos tienen rutas alternativas
+    static_assert(!DMA::conflicts(DMA::ReqSpi1Tx, DMA_PwmOut::getRequest(PA_6)), "SPI1_TX y TIM16_CH1 sin canal DMA");
+    static_assert(!DMA::conflicts(DMA::ReqSpi1Tx, DMA_PwmOut::getRequest(PA_9)), "SPI1_TX y TIM1_CH2 sin canal DMA");
+    static_assert(DMA::conflicts(DMA_PwmOut::getRequest(PA_9), DMA::ReqI2c3Rx), "TIM1_CH2 e I2C3_RX deben colisionar");
+    // SPI1 a 2.5MHz (80MHz/32), la tira se conecta a MOSI (PA_7)
+    DMA_SPI* spi = new DMA_SPI(2500000, PA_7, PA_6, PA_5);
+    WS281xLedStrip::SpiSymbol symbols[2] = {WS281xLedStrip::SpiSymbol3, WS281xLedStrip::SpiSymbol4};
+    WS281xLedStrip::Color_t color;
+    for(uint8_t s = 0; s < 2; s++){
+        WS281xProbe* strip = new WS281xProbe(spi, 16, symbols[s]);
+        for(uint16_t i = 0; i < 16; i++){
+            color.red = i * 16; color.green = 255 - (i * 5); color.blue = (i & 1)? 0x5A : 0xC3;
+            strip->setRange(i, i + 1, color);
+        }
+        int errors = strip->check();
+        DEBUG_TRACE("\r\nSimbolos de %d bits: %s (%d bytes/led, buffer %d bytes, %d errores)", symbols[s], 
+                    (errors == 0)? "OK" : "ERROR", strip->ledSize(), strip->getBufferSize(), errors);
+        delete strip;
+    }
+    // en Streaming se decodifica el anillo durante varios frames
+    WS281xProbe* strip = new WS281xProbe(spi, 37, WS281xLedStrip::SpiSymbol3, WS281xLedStrip::Streaming);
+    for(uint16_t i = 0; i < 37; i++){
+        color.red = i; color.green = 0x80 | i; color.blue = 255 - i;
+        strip->setRange(i, i + 1, color);
+    }
+    int errors = strip->run(3);
+    DEBUG_TRACE("\r\nStreaming: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+    delete strip;
+    // el backend SPI no crea ningún canal pwm, y los cambios de modo de refresco sólo afectan al bus
+    strip = new WS281xProbe(spi, 16, WS281xLedStrip::SpiSymbol3);
+    errors = (strip->hasPwm())? 1 : 0;
+    errors += (strip->setRefreshMode(WS281xLedStrip::OneShot) && strip->setRefreshMode(WS281xLedStrip::Continuous))? 0 : 1;
+    DEBUG_TRACE("\r\nSin canal pwm: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+    delete strip;
+    delete spi;
+}
+
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_lut(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_lut...\r\n");
+    // las tres vistas de la tabla, una por cada ancho de elemento del buffer dma
+    DMA_PwmOut::DutyWidth widths[3] = {DMA_PwmOut::DutyWidth8, DMA_PwmOut::DutyWidth16, DMA_PwmOut::DutyWidth32};
+    for(uint8_t w = 0; w < 3; w++){
+        WS281xProbe* strip = new WS281xProbe(PA_8, 4, widths[w]);
+        int errors = strip->checkLut();
+        DEBUG_TRACE("\r\nTabla de %d bits: %s (%d errores)", 8 * strip->getDutyWidth(), (errors == 0)? "OK" : "ERROR", errors);
+        delete strip;
+    }
+}
+
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_encode(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_encode...\r\n");
+    const uint16_t num_leds = 37;
+    WS281xLedStrip::Color_t expected[num_leds];
+    const WS281xLedStrip::Color_t pattern[3] = {{255, 0, 0}, {0, 255, 0}, {0x5A, 0xA5, 0x81}};
+    DMA_PwmOut::DutyWidth widths[3] = {DMA_PwmOut::DutyWidth8, DMA_PwmOut::DutyWidth16, DMA_PwmOut::DutyWidth32};
+    int total = 0;
+    for(uint8_t w = 0; w < 3; w++){
+        WS281xProbe* strip = new WS281xProbe(PA_8, num_leds, widths[w]);
+        // un color distinto en cada led, led a led
+        for(uint16_t i = 0; i < num_leds; i++){
+            expected[i].red = i * 7; expected[i].green = 255 - (i * 3); expected[i].blue = (i & 1)? 0x5A : 0xC3;
+            strip->setRange(i, i + 1, expected[i]);
+        }
+        int errors = strip->check(expected);
+        // un frame completo con una única llamada
+        for(uint16_t i = 0; i < num_leds; i++){
+            expected[i].red = 255 - i; expected[i].green = i; expected[i].blue = i * 5;
+        }
+        strip->setPixels(0, expected, num_leds);
+        errors += strip->check(expected);
+        // un patrón repetido desde un led intermedio
+        strip->fillPattern(10, pattern, 3, num_leds);
+        for(uint16_t i = 10; i < num_leds; i++){
+            expected[i] = pattern[(i - 10) % 3];
+        }
+        errors += strip->check(expected);
+        DEBUG_TRACE("\r\nCodificacion %d bits: %s (%d errores)", 8 * strip->getDutyWidth(), (errors == 0)? "OK" : "ERROR", errors);
+        total += errors;
+        delete strip;
+    }
+    DEBUG_TRACE("\r\nResultado: %s", (total == 0)? "OK" : "ERROR");
+}
+
+
+
+//------------------------------------------------------------------------------------
+void test_WS281x_hsv(){
+    logger = new Logger(USBTX, USBRX, 16, 115200);
+    DEBUG_TRACE("\r\nIniciando test_WS281x_hsv...\r\n");
+    // colores primarios: 85 y 170 quedan 2/256 antes del inicio exacto de su sector, de ahí el residuo de 1 y 3
+    // en la componente anterior, igual que en la conversión en coma flotante
+    struct{ WS281xLedStrip::Hsv_t hsv; WS281xLedStrip::Color_t rgb; } cases[] = {
+        {{0, 255, 255},     {255, 0, 0}},
+        {{85, 255, 255},    {1, 255, 0}},
+        {{170, 255, 255},   {0, 3, 255}},
+        // sin saturación: gris del nivel indicado, para cualquier tono
+        {{0, 0, 255},       {255, 255, 255}},
+        {{43, 0, 77},       {77, 77, 77}},
+        {{200, 0, 1},       {1, 1, 1}},
+        // sin brillo: negro, para cualquier tono y saturación
+        {{0, 255, 0},       {0, 0, 0}},
+        {{128, 180, 0},     {0, 0, 0}},
+        {{255, 0, 0},       {0, 0, 0}},
+    };
+    int errors = 0;
+    for(uint8_t i = 0; i < sizeof(cases)/sizeof(cases[0]); i++){
+        WS281xLedStrip::Color_t rgb;
+        WS281xLedStrip::hsvToRgb(cases[i].hsv, rgb);
+        if(rgb.red != cases[i].rgb.red || rgb.green != cases[i].rgb.green || rgb.blue != cases[i].rgb.blue){
+            DEBUG_TRACE("\r\nHSV(%d,%d,%d) = RGB(%d,%d,%d), esperado RGB(%d,%d,%d)", cases[i].hsv.hue, cases[i].hsv.sat, 
+                        cases[i].hsv.val, rgb.red, rgb.green, rgb.blue, cases[i].rgb.red, cases[i].rgb.green, cases[i].rgb.blue);
+            errors++;
+        }
+    }
+    DEBUG_TRACE("\r\nValores conocidos: %s (%d errores)", (errors == 0)? "OK" : "ERROR", errors);
+}
@@ -0,0 +1,89 @@
+/*
+ * ws281x_anim_encode.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  Herramienta de host que genera un contenedor WS281xAnimCodec a partir de frames RGB en bruto (3 bytes por led,
+ *  num_leds leds por frame, uno tras otro). El fichero resultante se programa tal cual en el BlockDevice y se
+ *  reproduce con WS281xAnimPlayer.
+ *
+ *  Compilación:
+ *      g++ -O2 -I.. -o ws281x_anim_encode ws281x_anim_encode.cpp
+ *
+ *  Uso:
+ *      ws281x_anim_encode <frames.rgb> <num_leds> <fps> <key_interval> <salida.wsan>
+ *
+ *  num_leds admite como máximo WS281xAnimCodec::MaxLeds. Se genera un KeyFrame cada key_interval frames (empezando
+ *  por el primero) y DeltaFrames en el resto.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "WS281xAnimCodec.h"
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+    if(argc != 6){
+        fprintf(stderr, "Uso: %s <frames.rgb> <num_leds> <fps> <key_interval> <salida.wsan>\n", argv[0]);
+        return 1;
+    }
+    long num_leds = strtol(argv[2], 0, 10);
+    long fps = strtol(argv[3], 0, 10);
+    long key_interval = strtol(argv[4], 0, 10);
+    if(num_leds <= 0 || num_leds > WS281xAnimCodec::MaxLeds || fps <= 0 || fps > 0xFFFF || 
+       key_interval <= 0 || key_interval > 0xFFFF){
+        fprintf(stderr, "Parametros fuera de rango\n");
+        return 1;
+    }
+    FILE* in = fopen(argv[1], "rb");
+    if(!in){
+        fprintf(stderr, "No se puede abrir %s\n", argv[1]);
+        return 1;
+    }
+    FILE* out = fopen(argv[5], "wb");
+    if(!out){
+        fprintf(stderr, "No se puede crear %s\n", argv[5]);
+        fclose(in);
+        return 1;
+    }
+
+    size_t frame_size = 3 * (size_t)num_leds;
+    std::vector<uint8_t> prev(frame_size), cur(frame_size);
+    std::vector<uint8_t> enc(WS281xAnimCodec::maxFrameSize((uint16_t)num_leds));
+    WS281xAnimCodec::Header_t hdr = {(uint16_t)num_leds, (uint16_t)fps, (uint16_t)key_interval, 0, 0};
+    uint8_t raw_hdr[WS281xAnimCodec::HeaderSize];
+
+    // la cabecera se reescribe al final, con el número de frames y el tamaño de datos
+    fwrite(raw_hdr, 1, sizeof(raw_hdr), out);
+    while(fread(&cur[0], 1, frame_size, in) == frame_size){
+        bool key = ((hdr.frames % key_interval) == 0);
+        uint32_t size = WS281xAnimCodec::encodeFrame((key)? 0 : &prev[0], &cur[0], (uint16_t)num_leds, &enc[0]);
+        if(fwrite(&enc[0], 1, size, out) != size){
+            fprintf(stderr, "Error de escritura\n");
+            fclose(in);
+            fclose(out);
+            return 1;
+        }
+        hdr.data_size += size;
+        hdr.frames++;
+        prev.swap(cur);
+    }
+    fclose(in);
+    if(hdr.frames == 0){
+        fprintf(stderr, "No hay frames completos en %s\n", argv[1]);
+        fclose(out);
+        return 1;
+    }
+    WS281xAnimCodec::writeHeader(hdr, raw_hdr);
+    fseek(out, 0, SEEK_SET);
+    fwrite(raw_hdr, 1, sizeof(raw_hdr), out);
+    fclose(out);
+
+    printf("%u frames, %u bytes (%.1f%% del tamano en bruto)\n", (unsigned)hdr.frames, (unsigned)(hdr.data_size + WS281xAnimCodec::HeaderSize),
+           100.0 * (hdr.data_size + WS281xAnimCodec::HeaderSize) / ((double)hdr.frames * frame_size));
+    return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * ws281x_codec_test.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  Prueba de host de WS281xBitCodec: codifica con las mismas tablas que WS281xLedStrip y decodifica el resultado,
+ *  comprobando que se recupera el valor original en todos los anchos de elemento del backend timer (8, 16 y 32 bits)
+ *  y en los símbolos de 3 y 4 bits del backend SPI. Comprueba también que un elemento o símbolo no válido se detecta.
+ *
+ *  Compilación:
+ *      g++ -O2 -I.. -o ws281x_codec_test ws281x_codec_test.cpp
+ *
+ *  Uso:
+ *      ws281x_codec_test
+ *
+ *  Termina con código 1 si alguna comprobación falla.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "WS281xBitCodec.h"
+
+
+/** Comprobaciones fallidas */
+static uint32_t failures = 0;
+
+/** Registra una comprobación fallida */
+#define CHECK(cond, ...)    do{ if(!(cond)){ failures++; printf("FALLO: " __VA_ARGS__); printf("\n"); } }while(0)
+
+
+//------------------------------------------------------------------------------------
+/** Codifica los 256 valores de byte con elementos de tipo T y los decodifica */
+template <typename T> static void testPwm(uint32_t bit_low, uint32_t bit_high){
+    T lut[16][4];
+    T buf[8];
+    WS281xBitCodec::buildNibbleLut(lut, bit_low, bit_high);
+    for(uint16_t v = 0; v < 256; v++){
+        WS281xBitCodec::encodeByte(buf, lut, (uint8_t)v);
+        int64_t d = WS281xBitCodec::decodePwm((const uint8_t*)buf, sizeof(T), 8, bit_low, bit_high);
+        CHECK(d == v, "pwm%u (%u/%u): byte %u decodificado como %d", (unsigned)(8 * sizeof(T)), bit_low, bit_high, v, (int)d);
+    }
+    // un elemento que no es bit_low ni bit_high invalida la decodificación
+    WS281xBitCodec::encodeByte(buf, lut, 0xA5);
+    buf[3] = (T)(bit_low + 1);
+    CHECK(WS281xBitCodec::decodePwm((const uint8_t*)buf, sizeof(T), 8, bit_low, bit_high) < 0,
+          "pwm%u: elemento no valido aceptado", (unsigned)(8 * sizeof(T)));
+}
+
+
+//------------------------------------------------------------------------------------
+/** Codifica leds GRB de 24 bits con símbolos spi de 'symbol_bits' bits y los decodifica */
+static void testSpi(uint8_t symbol_bits){
+    uint16_t table[16];
+    uint8_t buf[3 * 4 + 1];
+    WS281xBitCodec::buildSpiNibbles(table, symbol_bits);
+    for(uint32_t i = 0; i < 4096; i++){
+        // recorre los 256 valores en cada componente y combinaciones variadas entre ellas
+        uint32_t grb = ((i & 0xFF) << 16) | (((i * 37) & 0xFF) << 8) | ((i * 101 + (i >> 8)) & 0xFF);
+        memset(buf, 0xEE, sizeof(buf));
+        uint8_t* dst = buf;
+        dst = WS281xBitCodec::encodeSpiByte(dst, table, symbol_bits, (uint8_t)(grb >> 16));
+        dst = WS281xBitCodec::encodeSpiByte(dst, table, symbol_bits, (uint8_t)(grb >> 8));
+        dst = WS281xBitCodec::encodeSpiByte(dst, table, symbol_bits, (uint8_t)grb);
+        CHECK(dst == &buf[3 * symbol_bits], "spi%u: %u bytes escritos", symbol_bits, (unsigned)(dst - buf));
+        CHECK(*dst == 0xEE, "spi%u: escritura fuera del led", symbol_bits);
+        int64_t d = WS281xBitCodec::decodeSpi(buf, symbol_bits, 24);
+        CHECK(d == grb, "spi%u: led %06x decodificado como %06x", symbol_bits, grb, (unsigned)d);
+    }
+    // un símbolo 111.. no es válido
+    WS281xBitCodec::encodeSpiByte(buf, table, symbol_bits, 0x00);
+    buf[0] |= 0xE0;
+    CHECK(WS281xBitCodec::decodeSpi(buf, symbol_bits, 8) < 0, "spi%u: simbolo no valido aceptado", symbol_bits);
+}
+
+
+//------------------------------------------------------------------------------------
+int main(){
+    // duty de un periodo de 800KHz con timers a 80MHz (100 ticks) y a 16MHz (20 ticks), y valores anchos de 32 bits
+    testPwm<uint8_t>(32, 64);
+    testPwm<uint8_t>(6, 13);
+    testPwm<uint16_t>(32, 64);
+    testPwm<uint16_t>(300, 700);
+    testPwm<uint32_t>(32, 64);
+    testPwm<uint32_t>(70000, 140000);
+    testSpi(3);
+    testSpi(4);
+    if(failures){
+        printf("%u comprobaciones fallidas\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * ws281x_hsv_bench.cpp
+ *
+ *  Created on: Oct 2026
+ *      Author: raulMrello
+ *
+ *  Herramienta de host que compara la conversión HSV->RGB entera de WS281xColor (la que utiliza setPixelsHSV) con
+ *  una referencia en coma flotante: error máximo y medio sobre todos los tonos, y conversiones por segundo de cada
+ *  método. La precisión no depende de la plataforma; la velocidad es la del host.
+ *
+ *  Compilación:
+ *      g++ -O2 -I.. -o ws281x_hsv_bench ws281x_hsv_bench.cpp
+ *
+ *  Uso:
+ *      ws281x_hsv_bench [conversiones]
+ *
+ *  Termina con código 1 si el error máximo supera MaxError.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "WS281xColor.h"
+
+
+/** Error máximo admitido por componente frente a la referencia */
+static const uint32_t MaxError = 2;
+
+/** Conversiones por defecto en la medida de velocidad (600 leds x 20 frames) */
+static const uint32_t DefaultConversions = 12000;
+
+
+/** Color RGB de destino, con los miembros que requiere WS281xColor::hsvToRgb */
+struct Rgb_t{
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+};
+
+
+//------------------------------------------------------------------------------------
+/** Conversión HSV->RGB de referencia en coma flotante, tal y como se hacía en la aplicación antes de
+ *  setPixelsHSV. El tono 0..255 corresponde a 0..360º.
+ */
+static void floatHsvToRgb(const WS281xColor::Hsv_t& hsv, Rgb_t& rgb){
+    float h = (hsv.hue * 6.0f) / 256.0f;
+    float s = hsv.sat / 255.0f;
+    float v = hsv.val / 255.0f;
+    int sector = (int)h;
+    float f = h - sector;
+    float p = v * (1.0f - s);
+    float q = v * (1.0f - s * f);
+    float t = v * (1.0f - s * (1.0f - f));
+    float r, g, b;
+    switch(sector){
+        case 0:  r = v; g = t; b = p; break;
+        case 1:  r = q; g = v; b = p; break;
+        case 2:  r = p; g = v; b = t; break;
+        case 3:  r = p; g = q; b = v; break;
+        case 4:  r = t; g = p; b = v; break;
+        default: r = v; g = p; b = q; break;
+    }
+    rgb.red = (uint8_t)(r * 255.0f + 0.5f);
+    rgb.green = (uint8_t)(g * 255.0f + 0.5f);
+    rgb.blue = (uint8_t)(b * 255.0f + 0.5f);
+}
+
+
+//------------------------------------------------------------------------------------
+/** Microsegundos transcurridos desde t0 */
+static uint32_t elapsedUs(const std::chrono::steady_clock::time_point& t0){
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+}
+
+
+//------------------------------------------------------------------------------------
+/** Conversiones por segundo a partir del tiempo empleado en us */
+static uint32_t perSecond(uint32_t conversions, uint32_t elapsed_us){
+    return (elapsed_us)? (uint32_t)(((uint64_t)conversions * 1000000) / elapsed_us) : 0;
+}
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+    if(argc > 2){
+        fprintf(stderr, "Uso: %s [conversiones]\n", argv[0]);
+        return 1;
+    }
+    long conversions = (argc == 2)? strtol(argv[1], 0, 10) : DefaultConversions;
+    if(conversions <= 0){
+        fprintf(stderr, "Parametros fuera de rango\n");
+        return 1;
+    }
+    WS281xColor::Hsv_t hsv;
+    Rgb_t ci, cf;
+    uint32_t max_err = 0, sum_err = 0, samples = 0;
+    // volatile para que el compilador no elimine las conversiones medidas
+    volatile uint32_t checksum = 0;
+
+    // precisión: todos los tonos con saturación y brillo en pasos de 5
+    for(uint16_t h = 0; h < 256; h++){
+        for(uint16_t sat = 0; sat < 256; sat += 5){
+            for(uint16_t val = 0; val < 256; val += 5){
+                hsv.hue = h; hsv.sat = sat; hsv.val = val;
+                WS281xColor::hsvToRgb(hsv, ci);
+                floatHsvToRgb(hsv, cf);
+                uint32_t err[3] = {(uint32_t)abs(ci.red - cf.red), (uint32_t)abs(ci.green - cf.green), (uint32_t)abs(ci.blue - cf.blue)};
+                for(uint8_t c = 0; c < 3; c++){
+                    max_err = (err[c] > max_err)? err[c] : max_err;
+                    sum_err += err[c];
+                }
+                samples += 3;
+            }
+        }
+    }
+
+    // velocidad: mismas conversiones con ambos métodos
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < (uint32_t)conversions; i++){
+        hsv.hue = i; hsv.sat = 255 - (i >> 4); hsv.val = 200;
+        floatHsvToRgb(hsv, cf);
+        checksum += cf.red + cf.green + cf.blue;
+    }
+    uint32_t float_us = elapsedUs(t0);
+    t0 = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < (uint32_t)conversions; i++){
+        hsv.hue = i; hsv.sat = 255 - (i >> 4); hsv.val = 200;
+        WS281xColor::hsvToRgb(hsv, ci);
+        checksum += ci.red + ci.green + ci.blue;
+    }
+    uint32_t int_us = elapsedUs(t0);
+
+    printf("Error maximo: %u, error medio: %u/1000 (%u muestras)\n", max_err, (sum_err * 1000) / samples, samples);
+    printf("Coma flotante: %u us, %u conversiones/s\n", float_us, perSecond(conversions, float_us));
+    printf("Entero:        %u us, %u conversiones/s\n", int_us, perSecond(conversions, int_us));
+    printf("(checksum %u)\n", (uint32_t)checksum);
+    return (max_err <= MaxError)? 0 : 1;
+}
@@ -28,11 +28,11 @@ Zerocross::Zerocross(PinName gpio_zc){
     if(gpio_zc != NC){
         _iizc = new InterruptIn(gpio_zc);
         
-        // Asocia manejadores de interrupcin del pin de entrada
+        // Asocia manejadores de interrupción del pin de entrada
         _iizc->rise(callback((void(*)())0));
         _iizc->fall(callback((void(*)())0));
     }
-    // Desactiva las callbacks de notificacin
+    // Desactiva las callbacks de notificación
     _isrRiseCb = callback(NULL_CALLBACK);
     _isrFallCb = callback(NULL_CALLBACK);
 }
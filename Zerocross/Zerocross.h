@@ -4,9 +4,9 @@
  *  Created on: Sep 2017
  *      Author: raulMrello
  *
- *	Zerocross es el mdulo encargado de gestionar los eventos ocurridos en la entrada conectada al detector de paso por cero.
- *  Se podr configurar para generar eventos en el flanco de bajada, de subida o en ambos. Las notificaciones se realizarn
- *  mediante la instalacin de callbacks dedicadas. Dichas callbacks se ejecutarn en el contexto ISR
+ *	Zerocross es el módulo encargado de gestionar los eventos ocurridos en la entrada conectada al detector de paso por cero.
+ *  Se podrá configurar para generar eventos en el flanco de bajada, de subida o en ambos. Las notificaciones se realizarán
+ *  mediante la instalación de callbacks dedicadas. Dichas callbacks se ejecutarán en el contexto ISR
  */
  
 #ifndef __Zerocross__H
@@ -20,8 +20,8 @@ class Zerocross{
     
     /** Tipo de flanco activo*/
     enum LogicLevel{
-        EdgeActiveIsFall,   /// Activo slo en flanco de bajada
-        EdgeActiveIsRise,   /// Activo slo en flanco de subida
+        EdgeActiveIsFall,   /// Activo sólo en flanco de bajada
+        EdgeActiveIsRise,   /// Activo sólo en flanco de subida
         EdgeActiveAreBoth   /// Activo en ambos flancos
     };
     
@@ -46,7 +46,7 @@ class Zerocross{
   
     
 	/** disableEvents
-     *  Desactiva la notificacin de eventos de un nivel concreto. De esta forma se permite desactivar eventos
+     *  Desactiva la notificación de eventos de un nivel concreto. De esta forma se permite desactivar eventos
      *  de un flanco, pero dejar otro flanco activo.
      *  @param level Nivel a desactivar
      */
@@ -54,8 +54,8 @@ class Zerocross{
          
   protected:
   
-    LogicLevel _level;                          /// Nivel lgico configurado
-    InterruptIn* _iizc;                         /// Entrada de interrupcin asociada al GPIO
+    LogicLevel _level;                          /// Nivel lógico configurado
+    InterruptIn* _iizc;                         /// Entrada de interrupción asociada al GPIO
     Callback<void(LogicLevel)> _isrRiseCb;      /// Callback para notificar eventos en flanco de subida (ISR)
     Callback<void(LogicLevel)> _isrFallCb;      /// Callback para notificar eventos en flanco de bajada (ISR)
     